@@ -0,0 +1,121 @@
+#include <cstddef>
+
+#include <random>
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <algorithm>
+
+#include <celero/Celero.h>
+#include <wenda/fds/epoch.h>
+#include <wenda/fds/redblack_tree.h>
+
+using namespace wenda;
+
+// ======================================================================================
+//                         many readers, one writer performance tests
+// ======================================================================================
+class ReadersWriterFixture
+	: public celero::TestFixture
+{
+public:
+	ReadersWriterFixture()
+		: data(element_count)
+	{
+		std::mt19937 mt(577);
+		std::uniform_int_distribution<int> dis(0, 2 * static_cast<int>(element_count));
+
+		std::generate_n(data.begin(), element_count, [&](){ return dis(mt); });
+
+		for (std::size_t i = 0; i < element_count; i += 2)
+		{
+			std::tie(tree, std::ignore, std::ignore) = tree.insert(data[i]);
+		}
+	}
+
+	/**
+	* Runs the reader threads while the calling thread writes, and waits for the readers to finish.
+	*/
+	template<typename Read, typename Write>
+	void run(Read read, Write write)
+	{
+		std::vector<std::thread> readers;
+
+		for (std::size_t i = 0; i < reader_count; i++)
+		{
+			readers.emplace_back([&, i]()
+			{
+				std::size_t found = 0;
+
+				for (std::size_t j = 0; j < lookup_count; j++)
+				{
+					found += read(data[(i * 7919 + j) % element_count]);
+				}
+
+				celero::DoNotOptimizeAway(found);
+			});
+		}
+
+		for (std::size_t i = 1; i < write_count; i += 2)
+		{
+			write(data[i]);
+		}
+
+		for (auto& reader : readers)
+		{
+			reader.join();
+		}
+	}
+
+	std::vector<int> data;
+	fds::redblack_tree<int> tree;
+	static const std::size_t element_count = 10000;
+	static const std::size_t reader_count = 4;
+	static const std::size_t lookup_count = 20000;
+	static const std::size_t write_count = 200;
+};
+
+BASELINE_F(ReadersWriter, Locked_Snapshot_Copy, ReadersWriterFixture, 0, 10)
+{
+	// readers copy the current version under a lock, which updates the reference count of the root.
+	std::mutex mutex;
+	auto current = tree;
+
+	run([&](int value) -> std::size_t
+	{
+		fds::redblack_tree<int> snapshot;
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			snapshot = current;
+		}
+
+		return snapshot.find(value) != snapshot.end() ? 1 : 0;
+	}, [&](int value)
+	{
+		auto next = std::get<0>(current.insert(value));
+		std::lock_guard<std::mutex> lock(mutex);
+		current = std::move(next);
+	});
+}
+
+BENCHMARK_F(ReadersWriter, Epoch_Guard, ReadersWriterFixture, 0, 10)
+{
+	fds::epoch_published<fds::redblack_tree<int>> published(tree);
+
+	run([&](int value) -> std::size_t
+	{
+		fds::epoch_guard guard;
+		auto const& snapshot = published.load(guard);
+
+		return snapshot.find(value) != snapshot.end() ? 1 : 0;
+	}, [&](int value)
+	{
+		published.publish(std::get<0>(published.get().insert(value)));
+	});
+
+	fds::epoch_domain::instance().synchronize();
+}
\ No newline at end of file
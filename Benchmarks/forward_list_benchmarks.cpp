@@ -1,8 +1,11 @@
 #include <cstddef>
 #include <forward_list>
+#include <memory>
+#include <vector>
 
 #include <celero/Celero.h>
 #include <wenda/fds/forward_list.h>
+#include <wenda/fds/biased_refcount.h>
 
 using namespace wenda;
 
@@ -11,10 +14,16 @@ class ForwardListPushFront
 {
 public:
 	ForwardListPushFront()
-		: lists(element_count)
-	{}
+		: lists(element_count), values(element_count)
+	{
+		for (size_t i = 0; i < element_count; i++)
+		{
+			values[i] = static_cast<int>(element_count - 1 - i);
+		}
+	}
 
 	std::vector<fds::forward_list<int>> lists;
+	std::vector<int> values;
 	static const std::size_t element_count = 1000;
 };
 
@@ -42,6 +51,54 @@ BENCHMARK_F(ForwardList_PushFront, FDS_forward_list_keep_one, ForwardListPushFro
 	celero::DoNotOptimizeAway(list);
 }
 
+BENCHMARK_F(ForwardList_PushFront, FDS_forward_list_keep_one_std_allocator, ForwardListPushFront, 0, 100)
+{
+	fds::forward_list<int, std::allocator<int>> list;
+
+	for (size_t i = 0, end = element_count; i < end; i++)
+	{
+		list = list.push_front(static_cast<int>(i));
+	}
+
+	celero::DoNotOptimizeAway(list);
+}
+
+BENCHMARK_F(ForwardList_PushFront, FDS_forward_list_keep_one_nonatomic_refcount, ForwardListPushFront, 0, 100)
+{
+	fds::forward_list<int, fds::node_pool_allocator<int>, fds::nonatomic_refcount_policy> list;
+
+	for (size_t i = 0, end = element_count; i < end; i++)
+	{
+		list = list.push_front(static_cast<int>(i));
+	}
+
+	celero::DoNotOptimizeAway(list);
+}
+
+BENCHMARK_F(ForwardList_PushFront, FDS_forward_list_keep_one_seq_cst_refcount, ForwardListPushFront, 0, 100)
+{
+	fds::forward_list<int, fds::node_pool_allocator<int>, fds::seq_cst_refcount_policy> list;
+
+	for (size_t i = 0, end = element_count; i < end; i++)
+	{
+		list = list.push_front(static_cast<int>(i));
+	}
+
+	celero::DoNotOptimizeAway(list);
+}
+
+BENCHMARK_F(ForwardList_PushFront, FDS_forward_list_keep_one_biased_refcount, ForwardListPushFront, 0, 100)
+{
+	fds::forward_list<int, fds::node_pool_allocator<int>, fds::biased_refcount_policy> list;
+
+	for (size_t i = 0, end = element_count; i < end; i++)
+	{
+		list = list.push_front(static_cast<int>(i));
+	}
+
+	celero::DoNotOptimizeAway(list);
+}
+
 BENCHMARK_F(ForwardList_PushFront, FDS_forward_list_keep_all, ForwardListPushFront, 0, 100)
 {
 	fds::forward_list<int> list;
@@ -51,5 +108,19 @@ BENCHMARK_F(ForwardList_PushFront, FDS_forward_list_keep_all, ForwardListPushFro
 		this->lists[i] = list.push_front(static_cast<int>(i));
 	}
 
+	celero::DoNotOptimizeAway(list);
+}
+
+BENCHMARK_F(ForwardList_PushFront, FDS_forward_list_from_range, ForwardListPushFront, 0, 100)
+{
+	fds::forward_list<int> list(values.begin(), values.end());
+
+	celero::DoNotOptimizeAway(list);
+}
+
+BENCHMARK_F(ForwardList_PushFront, FDS_forward_list_prepend_range, ForwardListPushFront, 0, 100)
+{
+	auto list = lists[0].prepend_range(values.begin(), values.end());
+
 	celero::DoNotOptimizeAway(list);
 }
\ No newline at end of file
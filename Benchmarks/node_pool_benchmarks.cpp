@@ -0,0 +1,98 @@
+#include <cstddef>
+#include <vector>
+
+#include <celero/Celero.h>
+#include <wenda/fds/node_pool.h>
+
+using namespace wenda;
+
+// ======================================================================================
+//                         node allocation performance tests
+// ======================================================================================
+namespace
+{
+	// same layout as a redblack_node<int>: reference count, two child pointers and the data.
+	struct benchmark_node
+	{
+		std::size_t refcount;
+		void* left;
+		void* right;
+		int data;
+	};
+}
+
+class NodeAllocationFixture
+	: public celero::TestFixture
+{
+public:
+	NodeAllocationFixture()
+		: nodes(element_count)
+	{}
+
+	std::vector<benchmark_node*> nodes;
+	static const std::size_t element_count = 10000;
+};
+
+BASELINE_F(NodeAllocation_Keep_All, Heap, NodeAllocationFixture, 0, 100)
+{
+	for (std::size_t i = 0; i < element_count; i++)
+	{
+		nodes[i] = new benchmark_node();
+	}
+
+	for (std::size_t i = 0; i < element_count; i++)
+	{
+		delete nodes[i];
+	}
+
+	celero::DoNotOptimizeAway(nodes);
+}
+
+BENCHMARK_F(NodeAllocation_Keep_All, NodePool, NodeAllocationFixture, 0, 100)
+{
+	fds::node_pool_allocator<benchmark_node> allocator;
+
+	for (std::size_t i = 0; i < element_count; i++)
+	{
+		nodes[i] = ::new (allocator.allocate(1)) benchmark_node();
+	}
+
+	for (std::size_t i = 0; i < element_count; i++)
+	{
+		allocator.deallocate(nodes[i], 1);
+	}
+
+	celero::DoNotOptimizeAway(nodes);
+}
+
+BASELINE_F(NodeAllocation_Churn, Heap, NodeAllocationFixture, 0, 100)
+{
+	// models a path copy: a handful of nodes are created, and the previous version is released.
+	for (std::size_t i = 0; i < element_count; i++)
+	{
+		auto index = (i * 7919) % element_count;
+		delete nodes[index];
+		nodes[index] = new benchmark_node();
+	}
+
+	celero::DoNotOptimizeAway(nodes);
+}
+
+BENCHMARK_F(NodeAllocation_Churn, NodePool, NodeAllocationFixture, 0, 100)
+{
+	fds::node_pool_allocator<benchmark_node> allocator;
+
+	for (std::size_t i = 0; i < element_count; i++)
+	{
+		auto index = (i * 7919) % element_count;
+
+		if (nodes[index])
+		{
+			allocator.deallocate(nodes[index], 1);
+		}
+
+		nodes[index] = ::new (allocator.allocate(1)) benchmark_node();
+	}
+
+	celero::DoNotOptimizeAway(nodes);
+}
\ No newline at end of file
@@ -0,0 +1,65 @@
+#include <cstddef>
+
+#include <random>
+
+#include <vector>
+
+#include <algorithm>
+
+#include <celero/Celero.h>
+#include <wenda/fds/node_reclaimer.h>
+#include <wenda/fds/redblack_tree.h>
+
+using namespace wenda;
+
+// ======================================================================================
+//                         garbage release performance tests
+// ======================================================================================
+class ReleaseVersionFixture
+	: public celero::TestFixture
+{
+public:
+	ReleaseVersionFixture()
+		: data(element_count)
+	{
+		std::mt19937 mt(314);
+		std::uniform_int_distribution<int> dis;
+
+		std::generate_n(data.begin(), element_count, [&](){ return dis(mt); });
+	}
+
+	std::vector<int> data;
+	fds::background_reclaimer background;
+	static const std::size_t element_count = 10000;
+};
+
+BASELINE_F(ReleaseVersion, Immediate, ReleaseVersionFixture, 0, 10)
+{
+	// builds a large version, and measures the time taken by the writer to drop it.
+	fds::redblack_tree<int> tree;
+
+	for (auto value : data)
+	{
+		std::tie(tree, std::ignore, std::ignore) = tree.insert(value);
+	}
+
+	tree = fds::redblack_tree<int>();
+	celero::DoNotOptimizeAway(tree);
+}
+
+BENCHMARK_F(ReleaseVersion, Background, ReleaseVersionFixture, 0, 10)
+{
+	fds::redblack_tree<int> tree;
+
+	for (auto value : data)
+	{
+		std::tie(tree, std::ignore, std::ignore) = tree.insert(value);
+	}
+
+	{
+		fds::deferred_reclamation_scope scope(background.get_reclaimer());
+		tree = fds::redblack_tree<int>();
+	}
+
+	celero::DoNotOptimizeAway(tree);
+}
\ No newline at end of file
@@ -0,0 +1,74 @@
+#include <cstddef>
+
+#include <random>
+
+#include <vector>
+
+#include <algorithm>
+
+#include <celero/Celero.h>
+#include <wenda/fds/node_region.h>
+#include <wenda/fds/redblack_tree.h>
+
+using namespace wenda;
+
+// ======================================================================================
+//                         temporary version performance tests
+// ======================================================================================
+class TemporaryVersionsFixture
+	: public celero::TestFixture
+{
+public:
+	TemporaryVersionsFixture()
+		: data(element_count), versions(element_count)
+	{
+		std::mt19937 mt(271);
+		std::uniform_int_distribution<int> dis;
+
+		std::generate_n(data.begin(), element_count, [&](){ return dis(mt); });
+
+		for (std::size_t i = 0; i < base_count; i++)
+		{
+			std::tie(base, std::ignore, std::ignore) = base.insert(dis(mt));
+		}
+	}
+
+	fds::redblack_tree<int> base;
+	std::vector<int> data;
+	std::vector<fds::redblack_tree<int>> versions;
+	static const std::size_t element_count = 1000;
+	static const std::size_t base_count = 10000;
+};
+
+BASELINE_F(TemporaryVersions, NodePool, TemporaryVersionsFixture, 0, 100)
+{
+	// models a request handler: many versions derived from a long-lived base, dropped together.
+	for (std::size_t i = 0; i < element_count; i++)
+	{
+		std::tie(versions[i], std::ignore, std::ignore) = base.insert(data[i]);
+	}
+
+	for (auto& version : versions)
+	{
+		version = base;
+	}
+
+	celero::DoNotOptimizeAway(versions);
+}
+
+BENCHMARK_F(TemporaryVersions, RegionScope, TemporaryVersionsFixture, 0, 100)
+{
+	fds::region_scope scope;
+
+	for (std::size_t i = 0; i < element_count; i++)
+	{
+		std::tie(versions[i], std::ignore, std::ignore) = base.insert(data[i]);
+	}
+
+	for (auto& version : versions)
+	{
+		version = base;
+	}
+
+	celero::DoNotOptimizeAway(versions);
+}
\ No newline at end of file
@@ -0,0 +1,112 @@
+#include <cstddef>
+
+#include <random>
+
+#include <map>
+#include <utility>
+#include <vector>
+
+#include <algorithm>
+#include <functional>
+
+#include <celero/Celero.h>
+#include <wenda/fds/redblack_map.h>
+#include <wenda/fds/redblack_tree.h>
+
+using namespace wenda;
+
+// ======================================================================================
+//                         value update performance tests
+// ======================================================================================
+struct PairKeyCompare
+{
+	typedef void is_transparent;
+
+	bool operator()(std::pair<int, int> const& left, std::pair<int, int> const& right) const { return left.first < right.first; }
+	bool operator()(std::pair<int, int> const& left, int right) const { return left.first < right; }
+	bool operator()(int left, std::pair<int, int> const& right) const { return left < right.first; }
+};
+
+class RedBlackMapUpdateFixture
+	: public celero::TestFixture
+{
+public:
+	RedBlackMapUpdateFixture()
+	{
+		std::mt19937 mt(71);
+		std::uniform_int_distribution<int> dis;
+
+		for (std::size_t i = 0; i < element_count; i++)
+		{
+			keys.push_back(dis(mt));
+		}
+
+		for (auto key : keys)
+		{
+			std_map[key] = key;
+			std::tie(fds_map, std::ignore) = fds_map.insert_or_assign(key, key);
+			std::tie(pair_tree, std::ignore, std::ignore) = pair_tree.insert(std::make_pair(key, key));
+		}
+
+		queries = keys;
+		std::shuffle(queries.begin(), queries.end(), mt);
+	}
+
+	std::vector<int> keys;
+	std::vector<int> queries;
+	std::map<int, int> std_map;
+	fds::redblack_map<int, int> fds_map;
+	fds::redblack_tree<std::pair<int, int>, PairKeyCompare> pair_tree;
+
+	static const std::size_t element_count = 1000;
+};
+
+BASELINE_F(RedBlackMapUpdate, STD_Map_Assign, RedBlackMapUpdateFixture, 0, 100)
+{
+	std::map<int, int> map = std_map;
+
+	for (auto key : queries)
+	{
+		map[key]++;
+	}
+
+	celero::DoNotOptimizeAway(map);
+}
+
+BENCHMARK_F(RedBlackMapUpdate, FDS_RedBlackTree_Erase_Insert, RedBlackMapUpdateFixture, 0, 100)
+{
+	auto tree = pair_tree;
+
+	for (auto key : queries)
+	{
+		auto value = tree.find_ptr(key)->second;
+		std::tie(tree, std::ignore) = tree.erase(key);
+		std::tie(tree, std::ignore, std::ignore) = tree.insert(std::make_pair(key, value + 1));
+	}
+
+	celero::DoNotOptimizeAway(tree);
+}
+
+BENCHMARK_F(RedBlackMapUpdate, FDS_RedBlackMap_Insert_Or_Assign, RedBlackMapUpdateFixture, 0, 100)
+{
+	auto map = fds_map;
+
+	for (auto key : queries)
+	{
+		std::tie(map, std::ignore) = map.insert_or_assign(key, *map.find(key) + 1);
+	}
+
+	celero::DoNotOptimizeAway(map);
+}
+
+BENCHMARK_F(RedBlackMapUpdate, FDS_RedBlackMap_Update, RedBlackMapUpdateFixture, 0, 100)
+{
+	auto map = fds_map;
+
+	for (auto key : queries)
+	{
+		std::tie(map, std::ignore) = map.update(key, [](int value) { return value + 1; });
+	}
+
+	celero::DoNotOptimizeAway(map);
+}
\ No newline at end of file
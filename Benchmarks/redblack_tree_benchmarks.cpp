@@ -3,13 +3,18 @@
 #include <random>
 
 #include <set>
+#include <string>
 #include <vector>
 
 #include <algorithm>
 #include <functional>
+#include <memory>
+#include <numeric>
 
 #include <celero/Celero.h>
 #include <wenda/fds/redblack_tree.h>
+#include <wenda/fds/biased_refcount.h>
+#include <wenda/fds/intern_table.h>
 
 using namespace wenda;
 
@@ -27,9 +32,13 @@ public:
 		std::uniform_int_distribution<int> dis;
 
 		std::generate_n(data.begin(), element_count, [&](){ return dis(mt); });
+
+		sorted = data;
+		std::sort(sorted.begin(), sorted.end());
 	}
 
 	std::vector<int> data;
+	std::vector<int> sorted;
 	std::vector<fds::redblack_tree<int>> trees;
 	static const std::size_t element_count = 10000;
 };
@@ -69,6 +78,105 @@ BENCHMARK_F(RedBlackTreeInsert, FDS_RedBlackTree_Insert_Keep_All, RedBlackTreeIn
 	}
 }
 
+BENCHMARK_F(RedBlackTreeInsert, FDS_RedBlackTree_Insert_Keep_One_NonAtomic_RefCount, RedBlackTreeInsertFixture, 0, 10)
+{
+	fds::redblack_tree<int, std::less<>, fds::node_pool_allocator<int>, fds::nonatomic_refcount_policy> set;
+
+	for (size_t i = 0; i < element_count; i++)
+	{
+		std::tie(set, std::ignore, std::ignore) = set.insert(data[i]);
+	}
+
+	celero::DoNotOptimizeAway(set);
+}
+
+BENCHMARK_F(RedBlackTreeInsert, FDS_RedBlackTree_Insert_Keep_One_SeqCst_RefCount, RedBlackTreeInsertFixture, 0, 10)
+{
+	fds::redblack_tree<int, std::less<>, fds::node_pool_allocator<int>, fds::seq_cst_refcount_policy> set;
+
+	for (size_t i = 0; i < element_count; i++)
+	{
+		std::tie(set, std::ignore, std::ignore) = set.insert(data[i]);
+	}
+
+	celero::DoNotOptimizeAway(set);
+}
+
+BENCHMARK_F(RedBlackTreeInsert, FDS_RedBlackTree_Insert_Keep_One_Biased_RefCount, RedBlackTreeInsertFixture, 0, 10)
+{
+	fds::redblack_tree<int, std::less<>, fds::node_pool_allocator<int>, fds::biased_refcount_policy> set;
+
+	for (size_t i = 0; i < element_count; i++)
+	{
+		std::tie(set, std::ignore, std::ignore) = set.insert(data[i]);
+	}
+
+	celero::DoNotOptimizeAway(set);
+}
+
+BENCHMARK_F(RedBlackTreeInsert, FDS_RedBlackTree_Insert_Transient, RedBlackTreeInsertFixture, 0, 10)
+{
+	fds::redblack_tree<int>::transient_type transient;
+
+	for (size_t i = 0; i < element_count; i++)
+	{
+		transient.insert(data[i]);
+	}
+
+	auto set = transient.take_persistent();
+	celero::DoNotOptimizeAway(set);
+}
+
+BENCHMARK_F(RedBlackTreeInsert, FDS_RedBlackTree_Build_Range, RedBlackTreeInsertFixture, 0, 10)
+{
+	fds::redblack_tree<int> set(data.begin(), data.end());
+
+	celero::DoNotOptimizeAway(set);
+}
+
+BENCHMARK_F(RedBlackTreeInsert, FDS_RedBlackTree_Build_Sorted_Range, RedBlackTreeInsertFixture, 0, 10)
+{
+	fds::redblack_tree<int> set(fds::sorted_range, sorted.begin(), sorted.end());
+
+	celero::DoNotOptimizeAway(set);
+}
+
+BENCHMARK_F(RedBlackTreeInsert, FDS_RedBlackTree_Insert_Keep_One_STD_Allocator, RedBlackTreeInsertFixture, 0, 10)
+{
+	fds::redblack_tree<int, std::less<>, std::allocator<int>> set;
+
+	for (size_t i = 0; i < element_count; i++)
+	{
+		std::tie(set, std::ignore, std::ignore) = set.insert(data[i]);
+	}
+
+	celero::DoNotOptimizeAway(set);
+}
+
+BENCHMARK_F(RedBlackTreeInsert, FDS_RedBlackTree_Insert_Keep_One_Sum_Augmentation, RedBlackTreeInsertFixture, 0, 10)
+{
+	fds::redblack_tree<int, std::less<>, fds::node_pool_allocator<int>, fds::default_refcount_policy, fds::sum_augmentation<long long>> set;
+
+	for (size_t i = 0; i < element_count; i++)
+	{
+		std::tie(set, std::ignore, std::ignore) = set.insert(data[i]);
+	}
+
+	celero::DoNotOptimizeAway(set);
+}
+
+BENCHMARK_F(RedBlackTreeInsert, FDS_RedBlackTree_Insert_Keep_One_Hash_Augmentation, RedBlackTreeInsertFixture, 0, 10)
+{
+	fds::redblack_tree<int, std::less<>, fds::node_pool_allocator<int>, fds::default_refcount_policy, fds::hash_augmentation<int>> set;
+
+	for (size_t i = 0; i < element_count; i++)
+	{
+		std::tie(set, std::ignore, std::ignore) = set.insert(data[i]);
+	}
+
+	celero::DoNotOptimizeAway(set);
+}
+
 // ======================================================================================
 //                         find performance tests
 // ======================================================================================
@@ -84,11 +192,11 @@ public:
 
 		for (std::size_t i = 0; i < element_count; i++)
 		{
-			int value = dis(mt);
-			data.push_back(value);
-			std::tie(fds_tree, std::ignore, std::ignore) = fds_tree.insert(value);
-			std_set.insert(value);
+			data.push_back(dis(mt));
 		}
+
+		fds_tree = fds::redblack_tree<int>(data.begin(), data.end());
+		std_set.insert(data.begin(), data.end());
 	}
 
 	std::vector<int> data;
@@ -116,6 +224,235 @@ BENCHMARK_F(RedBlackTreeFind, FDS_RedBlackTree_Find, RedBlackTreeFindDeleteFixtu
 	}
 }
 
+BENCHMARK_F(RedBlackTreeFind, FDS_RedBlackTree_Find_Ptr, RedBlackTreeFindDeleteFixture, 0, 1000)
+{
+	for (std::size_t i = 0; i < element_count; i++)
+	{
+		data[i] = *fds_tree.find_ptr(data[i]);
+	}
+}
+
+BENCHMARK_F(RedBlackTreeFind, FDS_RedBlackTree_Insert_Existing, RedBlackTreeFindDeleteFixture, 0, 1000)
+{
+	fds::redblack_tree<int> tree = fds_tree;
+
+	for (std::size_t i = 0; i < element_count; i++)
+	{
+		std::tie(tree, std::ignore, std::ignore) = tree.insert(data[i]);
+	}
+
+	celero::DoNotOptimizeAway(tree);
+}
+
+BENCHMARK_F(RedBlackTreeFind, FDS_RedBlackTree_Erase_Missing, RedBlackTreeFindDeleteFixture, 0, 1000)
+{
+	fds::redblack_tree<int> tree = fds_tree;
+
+	for (std::size_t i = 0; i < element_count; i++)
+	{
+		std::tie(tree, std::ignore) = tree.erase(data[i] ^ 1);
+	}
+
+	celero::DoNotOptimizeAway(tree);
+}
+
+// ======================================================================================
+//                         string lookup performance tests
+// ======================================================================================
+class RedBlackTreeStringFindFixture
+	: public celero::TestFixture
+{
+public:
+	RedBlackTreeStringFindFixture()
+	{
+		std::mt19937 mt(31);
+		std::uniform_int_distribution<int> dis;
+
+		for (std::size_t i = 0; i < element_count; i++)
+		{
+			words.push_back("symbol_table_entry_" + std::to_string(dis(mt)));
+		}
+
+		fds_tree = fds::redblack_tree<std::string>(words.begin(), words.end());
+		fds_tree_opaque = fds::redblack_tree<std::string, std::less<std::string>>(words.begin(), words.end());
+		fds_tree_three_way = fds::redblack_tree<std::string, fds::three_way_less<>>(words.begin(), words.end());
+		std_set.insert(words.begin(), words.end());
+
+		for (auto const& word : words)
+		{
+			queries.push_back(word.c_str());
+		}
+	}
+
+	std::vector<std::string> words;
+	std::vector<char const*> queries;
+	fds::redblack_tree<std::string> fds_tree;
+	fds::redblack_tree<std::string, std::less<std::string>> fds_tree_opaque;
+	fds::redblack_tree<std::string, fds::three_way_less<>> fds_tree_three_way;
+	std::set<std::string, std::less<>> std_set;
+
+	static const std::size_t element_count = 1000;
+};
+
+BASELINE_F(RedBlackTreeStringFind, STD_Set_Find, RedBlackTreeStringFindFixture, 0, 1000)
+{
+	std::size_t found = 0;
+
+	for (auto query : queries)
+	{
+		found += std_set.find(query) != std_set.end();
+	}
+
+	celero::DoNotOptimizeAway(found);
+}
+
+BENCHMARK_F(RedBlackTreeStringFind, FDS_RedBlackTree_Contains_Temporary, RedBlackTreeStringFindFixture, 0, 1000)
+{
+	std::size_t found = 0;
+
+	for (auto query : queries)
+	{
+		found += fds_tree_opaque.contains(query);
+	}
+
+	celero::DoNotOptimizeAway(found);
+}
+
+BENCHMARK_F(RedBlackTreeStringFind, FDS_RedBlackTree_Contains_Transparent, RedBlackTreeStringFindFixture, 0, 1000)
+{
+	std::size_t found = 0;
+
+	for (auto query : queries)
+	{
+		found += fds_tree.contains(query);
+	}
+
+	celero::DoNotOptimizeAway(found);
+}
+
+BENCHMARK_F(RedBlackTreeStringFind, FDS_RedBlackTree_Contains_Three_Way, RedBlackTreeStringFindFixture, 0, 1000)
+{
+	std::size_t found = 0;
+
+	for (auto query : queries)
+	{
+		found += fds_tree_three_way.contains(query);
+	}
+
+	celero::DoNotOptimizeAway(found);
+}
+
+BASELINE_F(RedBlackTreeStringInsert, STD_Set_Insert, RedBlackTreeStringFindFixture, 0, 10)
+{
+	std::set<std::string> set;
+
+	for (auto const& word : words)
+	{
+		set.insert(word);
+	}
+
+	celero::DoNotOptimizeAway(set);
+}
+
+BENCHMARK_F(RedBlackTreeStringInsert, FDS_RedBlackTree_Insert_Keep_One, RedBlackTreeStringFindFixture, 0, 10)
+{
+	fds::redblack_tree<std::string> tree;
+
+	for (auto const& word : words)
+	{
+		std::tie(tree, std::ignore, std::ignore) = tree.insert(word);
+	}
+
+	celero::DoNotOptimizeAway(tree);
+}
+
+BENCHMARK_F(RedBlackTreeStringInsert, FDS_RedBlackTree_Insert_Keep_One_Three_Way, RedBlackTreeStringFindFixture, 0, 10)
+{
+	fds::redblack_tree<std::string, fds::three_way_less<>> tree;
+
+	for (auto const& word : words)
+	{
+		std::tie(tree, std::ignore, std::ignore) = tree.insert(word);
+	}
+
+	celero::DoNotOptimizeAway(tree);
+}
+
+BASELINE_F(RedBlackTreeStringDelete, STD_Set_Delete, RedBlackTreeStringFindFixture, 0, 10)
+{
+	std::set<std::string, std::less<>> set = std_set;
+
+	for (auto const& word : words)
+	{
+		set.erase(word);
+	}
+
+	celero::DoNotOptimizeAway(set);
+}
+
+BENCHMARK_F(RedBlackTreeStringDelete, FDS_RedBlackTree_Delete_Keep_One, RedBlackTreeStringFindFixture, 0, 10)
+{
+	auto tree = fds_tree;
+
+	for (auto const& word : words)
+	{
+		std::tie(tree, std::ignore) = tree.erase(word);
+	}
+
+	celero::DoNotOptimizeAway(tree);
+}
+
+BENCHMARK_F(RedBlackTreeStringDelete, FDS_RedBlackTree_Delete_Keep_One_Three_Way, RedBlackTreeStringFindFixture, 0, 10)
+{
+	auto tree = fds_tree_three_way;
+
+	for (auto const& word : words)
+	{
+		std::tie(tree, std::ignore) = tree.erase(word);
+	}
+
+	celero::DoNotOptimizeAway(tree);
+}
+
+// ======================================================================================
+//                         order statistics performance tests
+// ======================================================================================
+BASELINE_F(RedBlackTreeRank, STD_Set_Rank, RedBlackTreeFindDeleteFixture, 0, 100)
+{
+	std::size_t total = 0;
+
+	for (std::size_t i = 0; i < element_count; i++)
+	{
+		total += std::distance(std_set.begin(), std_set.find(data[i]));
+	}
+
+	celero::DoNotOptimizeAway(total);
+}
+
+BENCHMARK_F(RedBlackTreeRank, FDS_RedBlackTree_Rank, RedBlackTreeFindDeleteFixture, 0, 100)
+{
+	std::size_t total = 0;
+
+	for (std::size_t i = 0; i < element_count; i++)
+	{
+		total += fds_tree.rank(data[i]);
+	}
+
+	celero::DoNotOptimizeAway(total);
+}
+
+BENCHMARK_F(RedBlackTreeRank, FDS_RedBlackTree_Select, RedBlackTreeFindDeleteFixture, 0, 100)
+{
+	int total = 0;
+
+	for (std::size_t i = 0; i < fds_tree.size(); i++)
+	{
+		total += fds_tree.select(i);
+	}
+
+	celero::DoNotOptimizeAway(total);
+}
+
 // ======================================================================================
 //                         deletion performance tests
 // ======================================================================================
@@ -188,4 +525,543 @@ BENCHMARK_F(RedBlackTreeIteration, FDS_RedBlackTree_Reduce, RedBlackTreeFindDele
 	int result = reduce(fds_tree, std::plus<int>(), 0);
 
 	celero::DoNotOptimizeAway(result);
+}
+
+BENCHMARK_F(RedBlackTreeIteration, FDS_RedBlackTree_Parallel_Reduce, RedBlackTreeFindDeleteFixture, 0, 1000)
+{
+	int result = parallel_reduce(fds_tree, std::plus<int>(), 0, std::plus<int>());
+
+	celero::DoNotOptimizeAway(result);
+}
+
+// ======================================================================================
+//                         bulk operation performance tests
+// ======================================================================================
+class RedBlackTreeBulkFixture
+	: public celero::TestFixture
+{
+public:
+	RedBlackTreeBulkFixture()
+	{
+		std::vector<int> values(element_count);
+
+		for (std::size_t i = 0; i < element_count; i++)
+		{
+			values[i] = static_cast<int>(i);
+		}
+
+		fds_tree = fds::redblack_tree<int>(fds::sorted_range, values.begin(), values.end());
+		std_set.insert(values.begin(), values.end());
+	}
+
+	fds::redblack_tree<int> fds_tree;
+	std::set<int> std_set;
+
+	static const std::size_t element_count = 1000000;
+};
+
+BASELINE_F(RedBlackTreeBulk, STD_Set_Accumulate, RedBlackTreeBulkFixture, 0, 10)
+{
+	long long result = std::accumulate(std_set.begin(), std_set.end(), 0LL);
+
+	celero::DoNotOptimizeAway(result);
+}
+
+BENCHMARK_F(RedBlackTreeBulk, FDS_RedBlackTree_Reduce, RedBlackTreeBulkFixture, 0, 10)
+{
+	long long result = reduce(fds_tree, std::plus<long long>(), 0LL);
+
+	celero::DoNotOptimizeAway(result);
+}
+
+BENCHMARK_F(RedBlackTreeBulk, FDS_RedBlackTree_Parallel_Reduce, RedBlackTreeBulkFixture, 0, 10)
+{
+	long long result = parallel_reduce(fds_tree, std::plus<long long>(), 0LL, std::plus<long long>());
+
+	celero::DoNotOptimizeAway(result);
+}
+
+BENCHMARK_F(RedBlackTreeBulk, FDS_RedBlackTree_Map_Values, RedBlackTreeBulkFixture, 0, 10)
+{
+	auto result = fds_tree.map_values([](int value) { return 2 * static_cast<long long>(value); });
+
+	celero::DoNotOptimizeAway(result);
+}
+
+BENCHMARK_F(RedBlackTreeBulk, FDS_RedBlackTree_Filter, RedBlackTreeBulkFixture, 0, 10)
+{
+	auto result = fds_tree.filter([](int value) { return value % 2 == 0; });
+
+	celero::DoNotOptimizeAway(result);
+}
+
+BENCHMARK_F(RedBlackTreeBulk, FDS_RedBlackTree_Filter_Few_Removed, RedBlackTreeBulkFixture, 0, 10)
+{
+	auto result = fds_tree.filter([](int value) { return value % 100000 != 0; });
+
+	celero::DoNotOptimizeAway(result);
+}
+
+// ======================================================================================
+//                         range query performance tests
+// ======================================================================================
+class RedBlackTreeRangeFixture
+	: public celero::TestFixture
+{
+public:
+	RedBlackTreeRangeFixture()
+	{
+		std::vector<int> values(element_count);
+		std::iota(values.begin(), values.end(), 0);
+
+		fds_tree = sum_tree(fds::sorted_range, values.begin(), values.end());
+		std_set.insert(values.begin(), values.end());
+
+		std::mt19937 mt(17);
+		std::uniform_int_distribution<int> dis(0, static_cast<int>(element_count));
+
+		for (std::size_t i = 0; i < range_count; i++)
+		{
+			auto lower = dis(mt);
+			bounds.push_back(std::make_pair(lower, lower + range_width));
+		}
+	}
+
+	typedef fds::redblack_tree<int, std::less<>, fds::node_pool_allocator<int>, fds::default_refcount_policy, fds::sum_augmentation<long long>> sum_tree;
+
+	sum_tree fds_tree;
+	std::set<int> std_set;
+	std::vector<std::pair<int, int>> bounds;
+
+	static const std::size_t element_count = 100000;
+	static const std::size_t range_count = 1000;
+	static const int range_width = 1000;
+};
+
+BASELINE_F(RedBlackTreeAggregate, STD_Set_Range_Accumulate, RedBlackTreeRangeFixture, 0, 10)
+{
+	long long result = 0;
+
+	for (auto const& bound : bounds)
+	{
+		result += std::accumulate(std_set.lower_bound(bound.first), std_set.lower_bound(bound.second), 0LL);
+	}
+
+	celero::DoNotOptimizeAway(result);
+}
+
+BENCHMARK_F(RedBlackTreeAggregate, FDS_RedBlackTree_Aggregate, RedBlackTreeRangeFixture, 0, 10)
+{
+	long long result = 0;
+
+	for (auto const& bound : bounds)
+	{
+		result += fds_tree.aggregate(bound.first, bound.second);
+	}
+
+	celero::DoNotOptimizeAway(result);
+}
+
+BASELINE_F(RedBlackTreeRangeScan, STD_Set_Range_Scan, RedBlackTreeRangeFixture, 0, 10)
+{
+	long long result = 0;
+
+	for (auto const& bound : bounds)
+	{
+		for (auto it = std_set.lower_bound(bound.first), last = std_set.lower_bound(bound.second); it != last; ++it)
+		{
+			result += *it;
+		}
+	}
+
+	celero::DoNotOptimizeAway(result);
+}
+
+BENCHMARK_F(RedBlackTreeRangeScan, FDS_RedBlackTree_Range_Scan, RedBlackTreeRangeFixture, 0, 10)
+{
+	long long result = 0;
+
+	for (auto const& bound : bounds)
+	{
+		for (auto value : fds_tree.range(bound.first, bound.second))
+		{
+			result += value;
+		}
+	}
+
+	celero::DoNotOptimizeAway(result);
+}
+
+BENCHMARK_F(RedBlackTreeRangeScan, FDS_RedBlackTree_Range_Scan_From_Begin, RedBlackTreeRangeFixture, 0, 1)
+{
+	long long result = 0;
+
+	for (auto const& bound : bounds)
+	{
+		for (auto it = fds_tree.begin(), last = fds_tree.end(); it != last && *it < bound.second; ++it)
+		{
+			if (*it >= bound.first)
+			{
+				result += *it;
+			}
+		}
+	}
+
+	celero::DoNotOptimizeAway(result);
+}
+
+// ======================================================================================
+//                         set operation performance tests
+// ======================================================================================
+class RedBlackTreeSetOperationFixture
+	: public celero::TestFixture
+{
+public:
+	RedBlackTreeSetOperationFixture()
+	{
+		std::mt19937 mt(17);
+		std::uniform_int_distribution<int> dis;
+
+		for (std::size_t i = 0; i < element_count; i++)
+		{
+			left.push_back(dis(mt));
+		}
+
+		for (std::size_t i = 0; i < element_count / 10; i++)
+		{
+			right.push_back(dis(mt));
+		}
+
+		std::sort(left.begin(), left.end());
+		std::sort(right.begin(), right.end());
+
+		left_tree = fds::redblack_tree<int>(fds::sorted_range, left.begin(), left.end());
+		right_tree = fds::redblack_tree<int>(fds::sorted_range, right.begin(), right.end());
+		left_set.insert(left.begin(), left.end());
+		right_set.insert(right.begin(), right.end());
+	}
+
+	std::vector<int> left;
+	std::vector<int> right;
+	fds::redblack_tree<int> left_tree;
+	fds::redblack_tree<int> right_tree;
+	std::set<int> left_set;
+	std::set<int> right_set;
+
+	static const std::size_t element_count = 100000;
+};
+
+BASELINE_F(RedBlackTreeUnion, STD_Set_Copy_Insert, RedBlackTreeSetOperationFixture, 0, 10)
+{
+	std::set<int> set = left_set;
+	set.insert(right_set.begin(), right_set.end());
+
+	celero::DoNotOptimizeAway(set);
+}
+
+BENCHMARK_F(RedBlackTreeUnion, FDS_RedBlackTree_Insert, RedBlackTreeSetOperationFixture, 0, 10)
+{
+	fds::redblack_tree<int> set = left_tree;
+
+	for (auto value : right)
+	{
+		std::tie(set, std::ignore, std::ignore) = set.insert(value);
+	}
+
+	celero::DoNotOptimizeAway(set);
+}
+
+BENCHMARK_F(RedBlackTreeUnion, FDS_RedBlackTree_Union, RedBlackTreeSetOperationFixture, 0, 10)
+{
+	auto set = set_union(left_tree, right_tree);
+
+	celero::DoNotOptimizeAway(set);
+}
+
+BENCHMARK_F(RedBlackTreeUnion, FDS_RedBlackTree_Union_Sequential, RedBlackTreeSetOperationFixture, 0, 10)
+{
+	fds::task_pool sequential(0);
+	auto set = set_union(left_tree, right_tree, sequential);
+
+	celero::DoNotOptimizeAway(set);
+}
+
+BENCHMARK_F(RedBlackTreeUnion, FDS_RedBlackTree_Intersection, RedBlackTreeSetOperationFixture, 0, 10)
+{
+	auto set = set_intersection(left_tree, right_tree);
+
+	celero::DoNotOptimizeAway(set);
+}
+
+BENCHMARK_F(RedBlackTreeUnion, FDS_RedBlackTree_Difference, RedBlackTreeSetOperationFixture, 0, 10)
+{
+	auto set = set_difference(left_tree, right_tree);
+
+	celero::DoNotOptimizeAway(set);
+}
+
+// ======================================================================================
+//                         version comparison performance tests
+// ======================================================================================
+class RedBlackTreeDiffFixture
+	: public celero::TestFixture
+{
+public:
+	RedBlackTreeDiffFixture()
+	{
+		std::vector<int> values(element_count);
+
+		for (std::size_t i = 0; i < element_count; i++)
+		{
+			values[i] = static_cast<int>(2 * i);
+		}
+
+		older = fds::redblack_tree<int>(fds::sorted_range, values.begin(), values.end());
+		newer = older;
+		restored = older;
+
+		std::mt19937 mt(97);
+		std::uniform_int_distribution<int> dis(0, static_cast<int>(2 * element_count));
+
+		for (std::size_t i = 0; i < edit_count; i++)
+		{
+			auto value = dis(mt);
+
+			if (i % 2 == 0)
+			{
+				std::tie(newer, std::ignore, std::ignore) = newer.insert(value | 1);
+				std::tie(restored, std::ignore, std::ignore) = restored.insert(value | 1);
+				std::tie(restored, std::ignore) = restored.erase(value | 1);
+			}
+			else
+			{
+				std::tie(newer, std::ignore) = newer.erase(value & ~1);
+			}
+		}
+	}
+
+	fds::redblack_tree<int> older;
+	fds::redblack_tree<int> newer;
+	fds::redblack_tree<int> restored; ///< A version of older with elements inserted and erased again.
+
+	static const std::size_t element_count = 1000000;
+	static const std::size_t edit_count = 200;
+};
+
+BASELINE_F(RedBlackTreeDiff, FDS_RedBlackTree_Full_Walk, RedBlackTreeDiffFixture, 0, 10)
+{
+	std::size_t changes = 0;
+	auto first = older.begin();
+	auto second = newer.begin();
+
+	while (first != older.end() || second != newer.end())
+	{
+		if (second == newer.end() || (first != older.end() && *first < *second))
+		{
+			++first;
+			++changes;
+		}
+		else if (first == older.end() || *second < *first)
+		{
+			++second;
+			++changes;
+		}
+		else
+		{
+			++first;
+			++second;
+		}
+	}
+
+	celero::DoNotOptimizeAway(changes);
+}
+
+BENCHMARK_F(RedBlackTreeDiff, FDS_RedBlackTree_Diff, RedBlackTreeDiffFixture, 0, 10)
+{
+	std::size_t changes = 0;
+	auto count = [&](int) { ++changes; };
+
+	older.diff(newer, count, count, [](int, int) {});
+
+	celero::DoNotOptimizeAway(changes);
+}
+
+BENCHMARK_F(RedBlackTreeDiff, FDS_RedBlackTree_Equal_Restored, RedBlackTreeDiffFixture, 0, 10)
+{
+	celero::DoNotOptimizeAway(older == restored);
+}
+
+
+class RedBlackTreeMergeFixture
+	: public celero::TestFixture
+{
+public:
+	RedBlackTreeMergeFixture()
+	{
+		std::vector<int> values(element_count);
+
+		for (std::size_t i = 0; i < element_count; i++)
+		{
+			values[i] = static_cast<int>(2 * i);
+		}
+
+		base = fds::redblack_tree<int>(fds::sorted_range, values.begin(), values.end());
+		left = base;
+		right = base;
+
+		std::mt19937 mt(101);
+		std::uniform_int_distribution<int> dis(0, static_cast<int>(2 * element_count));
+
+		for (std::size_t i = 0; i < edit_count; i++)
+		{
+			std::tie(left, std::ignore, std::ignore) = left.insert(dis(mt) | 1);
+
+			auto value = dis(mt);
+			rightEdits.push_back(value);
+
+			if (i % 2 == 0)
+			{
+				std::tie(right, std::ignore, std::ignore) = right.insert(value | 1);
+			}
+			else
+			{
+				std::tie(right, std::ignore) = right.erase(value & ~1);
+			}
+		}
+	}
+
+	fds::redblack_tree<int> base;
+	fds::redblack_tree<int> left;
+	fds::redblack_tree<int> right;
+	std::vector<int> rightEdits; ///< The edits made by right, to replay on left.
+
+	static const std::size_t element_count = 1000000;
+	static const std::size_t edit_count = 200;
+};
+
+BASELINE_F(RedBlackTreeMerge, FDS_RedBlackTree_Replay_Edits, RedBlackTreeMergeFixture, 0, 100)
+{
+	auto merged = left;
+
+	for (std::size_t i = 0; i < rightEdits.size(); i++)
+	{
+		if (i % 2 == 0)
+		{
+			std::tie(merged, std::ignore, std::ignore) = merged.insert(rightEdits[i] | 1);
+		}
+		else
+		{
+			std::tie(merged, std::ignore) = merged.erase(rightEdits[i] & ~1);
+		}
+	}
+
+	celero::DoNotOptimizeAway(merged.size());
+}
+
+BENCHMARK_F(RedBlackTreeMerge, FDS_RedBlackTree_Merge3, RedBlackTreeMergeFixture, 0, 100)
+{
+	auto merged = merge3(base, left, right, [](int const*, int const* mine, int const*) { return mine; });
+	celero::DoNotOptimizeAway(merged.size());
+}
+
+class RedBlackTreeHashFixture
+	: public celero::TestFixture
+{
+public:
+	typedef fds::redblack_tree<int, std::less<>, fds::node_pool_allocator<int>, fds::default_refcount_policy, fds::hash_augmentation<int>> hash_tree;
+
+	RedBlackTreeHashFixture()
+	{
+		std::vector<int> values(element_count);
+
+		for (std::size_t i = 0; i < element_count; i++)
+		{
+			values[i] = static_cast<int>(2 * i);
+		}
+
+		// the trees are built separately, as by different replicas, so that they share no nodes.
+		plain = fds::redblack_tree<int>(fds::sorted_range, values.begin(), values.end());
+		plainCopy = fds::redblack_tree<int>(fds::sorted_range, values.begin(), values.end());
+		hashed = hash_tree(fds::sorted_range, values.begin(), values.end());
+
+		values[element_count / 2] += 1;
+		hashedChanged = hash_tree(fds::sorted_range, values.begin(), values.end());
+		values[element_count / 2] -= 1;
+		hashedCopy = hash_tree(fds::sorted_range, values.begin(), values.end());
+	}
+
+	fds::redblack_tree<int> plain;
+	fds::redblack_tree<int> plainCopy;
+	hash_tree hashed;
+	hash_tree hashedCopy;
+	hash_tree hashedChanged; ///< A separately built tree with one element replaced.
+
+	static const std::size_t element_count = 1000000;
+};
+
+BASELINE_F(RedBlackTreeHash, FDS_RedBlackTree_Equal_Separately_Built, RedBlackTreeHashFixture, 0, 10)
+{
+	celero::DoNotOptimizeAway(plain == plainCopy);
+}
+
+BENCHMARK_F(RedBlackTreeHash, FDS_RedBlackTree_Equal_Separately_Built_Hashed, RedBlackTreeHashFixture, 0, 10)
+{
+	celero::DoNotOptimizeAway(hashed == hashedCopy);
+}
+
+BENCHMARK_F(RedBlackTreeHash, FDS_RedBlackTree_Unequal_Separately_Built_Hashed, RedBlackTreeHashFixture, 0, 10)
+{
+	celero::DoNotOptimizeAway(hashed == hashedChanged);
+}
+
+BENCHMARK_F(RedBlackTreeHash, FDS_RedBlackTree_HashEqual_Separately_Built, RedBlackTreeHashFixture, 0, 10)
+{
+	celero::DoNotOptimizeAway(hashed.hash_equal(hashedCopy));
+}
+
+BENCHMARK_F(RedBlackTreeHash, FDS_RedBlackTree_Diff_Separately_Built_Hashed, RedBlackTreeHashFixture, 0, 10)
+{
+	std::size_t changes = 0;
+	auto count = [&](int) { ++changes; };
+
+	hashed.diff(hashedChanged, count, count, [](int, int) {});
+
+	celero::DoNotOptimizeAway(changes);
+}
+
+class RedBlackTreeInternFixture
+	: public celero::TestFixture
+{
+public:
+	RedBlackTreeInternFixture()
+		: values(element_count)
+	{
+		std::iota(values.begin(), values.end(), 0);
+		interned = table.intern(fds::redblack_tree<int>(fds::sorted_range, values.begin(), values.end()));
+	}
+
+	std::vector<int> values;
+	fds::intern_table<fds::redblack_tree<int>> table;
+	fds::redblack_tree<int> interned;
+
+	static const std::size_t element_count = 100000;
+};
+
+BASELINE_F(RedBlackTreeIntern, FDS_RedBlackTree_Build_Sorted_Range, RedBlackTreeInternFixture, 0, 10)
+{
+	fds::redblack_tree<int> tree(fds::sorted_range, values.begin(), values.end());
+	celero::DoNotOptimizeAway(tree.size());
+}
+
+BENCHMARK_F(RedBlackTreeIntern, FDS_RedBlackTree_Build_And_Intern_Existing, RedBlackTreeInternFixture, 0, 10)
+{
+	// every node of the new tree has a canonical equivalent, so that the new tree is released entirely.
+	auto tree = table.intern(fds::redblack_tree<int>(fds::sorted_range, values.begin(), values.end()));
+	celero::DoNotOptimizeAway(tree.size());
+}
+
+BENCHMARK_F(RedBlackTreeIntern, FDS_RedBlackTree_Intern_Derived_Version, RedBlackTreeInternFixture, 0, 10)
+{
+	auto tree = table.intern(std::get<0>(interned.insert(static_cast<int>(element_count))));
+	celero::DoNotOptimizeAway(tree.size());
 }
\ No newline at end of file
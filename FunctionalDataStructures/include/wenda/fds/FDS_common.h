@@ -18,4 +18,29 @@
 #define WENDA_CONSTEXPR
 #endif
 
+/**
+* Aligns a type to the given number of bytes, which must be a literal.
+*/
+#ifndef WENDA_ALIGNAS
+#if defined(_MSC_VER) && _MSC_VER < 1900
+#define WENDA_ALIGNAS(alignment) __declspec(align(alignment))
+#else
+#define WENDA_ALIGNAS(alignment) alignas(alignment)
+#endif
+#endif
+
+/**
+* Declares a variable with thread storage duration.
+* Visual Studio 2013 does not support thread_local, and its __declspec(thread) only supports objects
+* that are trivially constructible and destructible, with a constant initializer. Variables declared with
+* this macro must be such objects: cleanup at thread exit goes through detail::at_thread_exit().
+*/
+#ifndef WENDA_THREAD_LOCAL
+#if defined(_MSC_VER) && _MSC_VER < 1900
+#define WENDA_THREAD_LOCAL __declspec(thread)
+#else
+#define WENDA_THREAD_LOCAL thread_local
+#endif
+#endif
+
 #endif // WENDA_FDS_FDS_COMMON_H_INCLUDED
\ No newline at end of file
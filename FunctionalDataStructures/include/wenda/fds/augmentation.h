@@ -0,0 +1,251 @@
+#ifndef WENDA_FDS_AUGMENTATION_H_INCLUDED
+#define WENDA_FDS_AUGMENTATION_H_INCLUDED
+
+#include "FDS_common.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <type_traits>
+
+/**
+* @file augmentation.h
+* This file implements the augmentation policies of the nodes of the persistent trees.
+* An augmentation policy describes a monoid: every node caches the combination of the values
+* of the elements of its subtree, which is recomputed whenever the node is created, so that
+* aggregates over ranges of elements can be computed in O(log n).
+* A policy provides a value_type, and the static functions identity(), lift() and combine(),
+* where combine() must be associative with identity() as its neutral element.
+*/
+
+WENDA_FDS_NAMESPACE_BEGIN
+
+/**
+* Augmentation policy indicating that the nodes do not cache any value.
+* The nodes of trees using it are not larger than without augmentation.
+*/
+struct no_augmentation
+{};
+
+/**
+* Augmentation policy caching the sum of the elements of each subtree.
+*/
+template<typename T>
+struct sum_augmentation
+{
+	typedef T value_type;
+
+	static value_type identity()
+	{
+		return value_type();
+	}
+
+	static value_type lift(T const& value)
+	{
+		return value;
+	}
+
+	static value_type combine(value_type const& left, value_type const& right)
+	{
+		return left + right;
+	}
+};
+
+/**
+* Augmentation policy caching the minimum of the elements of each subtree.
+* The aggregate of an empty range is the largest value of @p T.
+*/
+template<typename T>
+struct min_augmentation
+{
+	typedef T value_type;
+
+	static value_type identity()
+	{
+		return std::numeric_limits<T>::max();
+	}
+
+	static value_type lift(T const& value)
+	{
+		return value;
+	}
+
+	static value_type combine(value_type const& left, value_type const& right)
+	{
+		return (std::min)(left, right);
+	}
+};
+
+/**
+* Augmentation policy caching the maximum of the elements of each subtree.
+* The aggregate of an empty range is the lowest value of @p T.
+*/
+template<typename T>
+struct max_augmentation
+{
+	typedef T value_type;
+
+	static value_type identity()
+	{
+		return std::numeric_limits<T>::lowest();
+	}
+
+	static value_type lift(T const& value)
+	{
+		return value;
+	}
+
+	static value_type combine(value_type const& left, value_type const& right)
+	{
+		return (std::max)(left, right);
+	}
+};
+
+/**
+* The value cached by @ref hash_augmentation, which is a polynomial hash of a sequence of elements.
+* The hash of a sequence is the sum of the hashes of its elements, each multiplied by a power of the base
+* for every element following it, modulo 2^64. The power of the base for the length of the sequence is
+* kept with the hash, so that hashes of sequences can be concatenated.
+*/
+struct sequence_hash
+{
+	std::uint64_t hash; ///< The hash of the sequence.
+	std::uint64_t power; ///< The base raised to the length of the sequence.
+
+	friend bool operator==(sequence_hash const& left, sequence_hash const& right) WENDA_NOEXCEPT
+	{
+		return left.hash == right.hash && left.power == right.power;
+	}
+
+	friend bool operator!=(sequence_hash const& left, sequence_hash const& right) WENDA_NOEXCEPT
+	{
+		return !(left == right);
+	}
+};
+
+/**
+* Augmentation policy caching a hash of the elements of each subtree, in order.
+* As the hash only depends on the sequence of elements, and not on the shape of the tree, trees holding
+* equal elements have equal hashes even if they were built separately, and the hash of the tree, or of any
+* range of it, may be compared with one computed in another process, see redblack_tree::aggregate().
+* Trees using this policy compare unequal in constant time if their hashes differ, and compare the elements of
+* subtrees with equal hashes with operator== only. The hash is not cryptographic, so that redblack_tree::hash_equal(),
+* which compares the hashes alone, may consider trees holding different elements equal.
+* @tparam T The type of the elements.
+* @tparam Hash The hash function of the elements, whose result is mixed before being combined.
+*/
+template<typename T, typename Hash = std::hash<T>>
+struct hash_augmentation
+{
+	typedef sequence_hash value_type;
+
+	static const std::uint64_t base = 0x100000001b3ull; ///< The base of the polynomial, which must be odd.
+
+	static value_type identity()
+	{
+		return value_type{ 0, 1 };
+	}
+
+	static value_type lift(T const& value)
+	{
+		// mixes the bits of the hash, as std::hash is the identity for integers on common implementations.
+		std::uint64_t hash = static_cast<std::uint64_t>(Hash()(value));
+		hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ull;
+		hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebull;
+		return value_type{ hash ^ (hash >> 31), base };
+	}
+
+	static value_type combine(value_type const& left, value_type const& right)
+	{
+		return value_type{ left.hash * right.power + right.hash, left.power * right.power };
+	}
+};
+
+/**
+* Indicates whether the given augmentation policy caches a value in the nodes.
+*/
+template<typename Augmentation>
+struct is_augmented
+	: std::true_type
+{};
+
+template<>
+struct is_augmented<no_augmentation>
+	: std::false_type
+{};
+
+/**
+* Indicates whether the given augmentation policy caches a hash of the elements, so that
+* subtrees with different hashes are known to hold different elements.
+*/
+template<typename Augmentation>
+struct is_hash_augmentation
+	: std::false_type
+{};
+
+template<typename T, typename Hash>
+struct is_hash_augmentation<hash_augmentation<T, Hash>>
+	: std::true_type
+{};
+
+namespace detail
+{
+	/**
+	* This class holds the value cached by a node for the given augmentation policy.
+	* It derives from the other holders of the node, rather than being a separate base, so that
+	* the node does not grow when both are empty.
+	* @tparam T The type of the elements of the node.
+	* @tparam Augmentation The augmentation policy.
+	* @tparam Base The base class, which is constructed from the argument of the constructor.
+	*/
+	template<typename T, typename Augmentation, typename Base>
+	class augmented_value_holder
+		: public Base
+	{
+		typename Augmentation::value_type summary; ///< The combined value of the elements of the subtree.
+	public:
+		template<typename Arg>
+		explicit augmented_value_holder(Arg const& arg)
+			: Base(arg), summary(Augmentation::identity())
+		{}
+
+		/**
+		* Returns the combined value of the elements of the subtree rooted at this node.
+		*/
+		typename Augmentation::value_type const& get_summary() const WENDA_NOEXCEPT
+		{
+			return summary;
+		}
+	protected:
+		/**
+		* Recomputes the cached value from the element of the node and its children, which may be null.
+		*/
+		template<typename Pointer>
+		void update_summary(T const& data, Pointer const& left, Pointer const& right)
+		{
+			auto leftSummary = left ? left->get_summary() : Augmentation::identity();
+			auto rightSummary = right ? right->get_summary() : Augmentation::identity();
+			summary = Augmentation::combine(Augmentation::combine(leftSummary, Augmentation::lift(data)), rightSummary);
+		}
+	};
+
+	template<typename T, typename Base>
+	class augmented_value_holder<T, no_augmentation, Base>
+		: public Base
+	{
+	public:
+		template<typename Arg>
+		explicit augmented_value_holder(Arg const& arg)
+			: Base(arg)
+		{}
+	protected:
+		template<typename Pointer>
+		void update_summary(T const&, Pointer const&, Pointer const&) WENDA_NOEXCEPT
+		{}
+	};
+}
+
+WENDA_FDS_NAMESPACE_END
+
+#endif // WENDA_FDS_AUGMENTATION_H_INCLUDED
\ No newline at end of file
@@ -0,0 +1,453 @@
+#ifndef WENDA_FDS_BIASED_REFCOUNT_H_INCLUDED
+#define WENDA_FDS_BIASED_REFCOUNT_H_INCLUDED
+
+#include "FDS_common.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "intrusive_ptr.h"
+#include "node_traits.h"
+#include "detail/thread_support.h"
+
+/**
+* @file biased_refcount.h
+* This file implements biased reference counting, for objects that are mostly referenced
+* by the thread that created them.
+* Every object is owned by the thread that created it. The owner updates a plain biased counter,
+* while the other threads update an atomic shared counter. The owner gives up its ownership when
+* its biased counter drops to zero, merging both counters, after which the object is counted atomically.
+* When another thread releases a reference that was counted by the owner, the shared counter becomes
+* negative: the object is then queued to its owner, which merges the counters the next time it releases
+* a reference, when process_biased_references() is called, or when it exits.
+*/
+
+WENDA_FDS_NAMESPACE_BEGIN
+
+/**
+* Reference counting policy selecting biased reference counting.
+* Use it for trees and lists that are almost exclusively modified by a single writer thread,
+* while other threads occasionally hold snapshots.
+*/
+struct biased_refcount_policy
+{};
+
+template<>
+class basic_intrusive_refcount<biased_refcount_policy>;
+
+namespace detail
+{
+	/**
+	* This class implements the queue of objects waiting for their owner thread to merge their counters.
+	* There is one queue per thread, which also identifies the thread as the owner of objects.
+	* Queues are never freed, as objects may refer to the queue of a thread that has exited.
+	*/
+	class biased_refcount_queue
+	{
+		typedef basic_intrusive_refcount<biased_refcount_policy> object_type;
+
+		std::atomic<object_type const*> head;
+
+		/**
+		* The queue of a thread, which is closed when the thread exits.
+		*/
+		struct thread_queue
+		{
+			biased_refcount_queue* queue;
+			thread_exit_callback exit;
+		};
+
+		static thread_queue& local_queue() WENDA_NOEXCEPT
+		{
+			static WENDA_THREAD_LOCAL thread_queue local = { nullptr, { nullptr, nullptr } };
+			return local;
+		}
+
+		static void close_current()
+		{
+			local_queue().queue->drain(true);
+		}
+	public:
+		biased_refcount_queue() WENDA_NOEXCEPT
+			: head(nullptr)
+		{}
+
+		/**
+		* The value of the head of the queue once its thread has exited.
+		*/
+		static object_type const* closed() WENDA_NOEXCEPT
+		{
+			return reinterpret_cast<object_type const*>(std::uintptr_t(1));
+		}
+
+		/**
+		* Returns the queue of the current thread.
+		*/
+		static biased_refcount_queue* current()
+		{
+			auto& local = local_queue();
+
+			if (!local.queue)
+			{
+				local.queue = new biased_refcount_queue();
+				local.exit.function = &close_current;
+				at_thread_exit(local.exit);
+			}
+
+			return local.queue;
+		}
+
+		/**
+		* Returns a value indicating whether there are objects waiting in the queue.
+		*/
+		bool pending() const WENDA_NOEXCEPT
+		{
+			auto first = head.load(std::memory_order_relaxed);
+			return first != nullptr && first != closed();
+		}
+
+		/**
+		* Returns a value indicating whether the owner thread of the queue has exited.
+		*/
+		bool is_closed() const WENDA_NOEXCEPT
+		{
+			return head.load(std::memory_order_acquire) == closed();
+		}
+
+		/**
+		* Adds the given object to the queue.
+		* @returns False if the queue is closed, in which case the object was not added.
+		*/
+		inline bool push(object_type const* object) WENDA_NOEXCEPT;
+
+		/**
+		* Merges the counters of all the objects in the queue, and destroys those that are no longer referenced.
+		* This must be called from the thread owning the queue.
+		* @param close If true, the queue is closed and no more objects may be added to it.
+		*/
+		inline void drain(bool close = false) WENDA_NOEXCEPT;
+	};
+
+	template<typename Derived>
+	void destroy_biased(basic_intrusive_refcount<biased_refcount_policy> const* object);
+}
+
+/**
+* This class implements a biased intrusive reference count.
+* The objects are owned by the thread that constructs them, and that thread must also be the one
+* taking the first reference to them (as is the case for the nodes of the data structures).
+*/
+template<>
+class basic_intrusive_refcount<biased_refcount_policy>
+{
+	friend class detail::biased_refcount_queue;
+
+	static const std::intptr_t merged_flag = 1; ///< Set once the owner has given up its ownership.
+	static const std::intptr_t queued_flag = 2; ///< Set while the object waits in the queue of its owner.
+	static const std::intptr_t count_unit = 4; ///< The value of one reference in the shared counter.
+
+	mutable std::atomic<detail::biased_refcount_queue*> owner;
+	mutable std::atomic<std::intptr_t> shared;
+	mutable std::size_t biased;
+	mutable basic_intrusive_refcount const* next_queued;
+	mutable void(*destroy)(basic_intrusive_refcount const*);
+
+	static std::intptr_t shared_count(std::intptr_t value) WENDA_NOEXCEPT
+	{
+		return value / count_unit - (value % count_unit < 0 ? 1 : 0);
+	}
+
+	void initialize_owner()
+	{
+		auto queue = detail::biased_refcount_queue::current();
+
+		if (queue->is_closed())
+		{
+			// objects created while the thread exits are counted atomically from the start.
+			owner.store(nullptr, std::memory_order_relaxed);
+			shared.store(merged_flag, std::memory_order_relaxed);
+		}
+		else
+		{
+			owner.store(queue, std::memory_order_relaxed);
+			shared.store(0, std::memory_order_relaxed);
+		}
+	}
+
+	/**
+	* Merges the biased counter into the shared counter, clearing the queued flag.
+	* This must be called by the owner, or by any thread once the owner has exited.
+	* @returns The number of remaining references.
+	*/
+	std::size_t merge() const WENDA_NOEXCEPT
+	{
+		auto count = static_cast<std::intptr_t>(biased);
+		biased = 0;
+		owner.store(nullptr, std::memory_order_relaxed);
+
+		auto current = shared.load(std::memory_order_relaxed);
+		std::intptr_t desired;
+
+		do
+		{
+			desired = ((current + count * count_unit) & ~queued_flag) | merged_flag;
+		} while (!shared.compare_exchange_weak(current, desired, std::memory_order_acq_rel, std::memory_order_relaxed));
+
+		return static_cast<std::size_t>(shared_count(desired));
+	}
+
+	template<typename Derived>
+	std::size_t remove_shared_reference() const WENDA_NOEXCEPT
+	{
+		auto value = shared.fetch_sub(count_unit, std::memory_order_release) - count_unit;
+
+		if (value & merged_flag)
+		{
+			auto count = shared_count(value);
+
+			if (count == 0)
+			{
+				std::atomic_thread_fence(std::memory_order_acquire);
+			}
+
+			return static_cast<std::size_t>(count);
+		}
+
+		if (shared_count(value) >= 0 || (value & queued_flag))
+		{
+			// the owner still holds the remaining references.
+			return 1;
+		}
+
+		// a reference counted by the owner has been released here: ask the owner to merge.
+		while (!(value & (merged_flag | queued_flag)))
+		{
+			auto queue = owner.load(std::memory_order_relaxed);
+
+			if (!queue)
+			{
+				// the owner is giving up its ownership, and counts this release when it sets the merged flag.
+				return 1;
+			}
+
+			if (shared.compare_exchange_weak(value, value | queued_flag, std::memory_order_relaxed))
+			{
+				destroy = &detail::destroy_biased<Derived>;
+
+				if (queue->push(this))
+				{
+					return 1;
+				}
+
+				// the owner has exited, merge on its behalf.
+				std::atomic_thread_fence(std::memory_order_acquire);
+				return merge();
+			}
+		}
+
+		return 1;
+	}
+public:
+	typedef biased_refcount_policy refcount_policy; ///< The policy used to update the counter.
+
+	basic_intrusive_refcount()
+		: biased(0), next_queued(nullptr), destroy(nullptr)
+	{
+		initialize_owner();
+	}
+
+	basic_intrusive_refcount(basic_intrusive_refcount const&)
+		: biased(0), next_queued(nullptr), destroy(nullptr)
+	{
+		initialize_owner();
+	}
+
+	friend std::size_t add_reference(basic_intrusive_refcount const* obj)
+	{
+		return add_reference(obj, 1);
+	}
+
+	/**
+	* Adds @p count references to the given object at once.
+	*/
+	friend std::size_t add_reference(basic_intrusive_refcount const* obj, std::size_t count)
+	{
+		if (obj->owner.load(std::memory_order_relaxed) == detail::biased_refcount_queue::current())
+		{
+			obj->biased += count;
+			return obj->biased + shared_count(obj->shared.load(std::memory_order_relaxed));
+		}
+
+		auto value = obj->shared.fetch_add(count * count_unit, std::memory_order_relaxed) + count * count_unit;
+		return static_cast<std::size_t>(shared_count(value));
+	}
+
+	/**
+	* Removes a reference from the given object.
+	* @returns Zero if this was the last reference, and the object must be destroyed; otherwise a non-zero value.
+	*/
+	template<typename Derived>
+	friend std::size_t remove_reference(Derived const* obj)
+	{
+		basic_intrusive_refcount const* object = obj;
+		auto queue = detail::biased_refcount_queue::current();
+
+		if (object->owner.load(std::memory_order_relaxed) == queue)
+		{
+			if (queue->pending())
+			{
+				queue->drain();
+			}
+
+			// draining may have merged this object.
+			if (object->owner.load(std::memory_order_relaxed) == queue)
+			{
+				if (--object->biased != 0)
+				{
+					return object->biased;
+				}
+
+				// give up the ownership. Threads releasing a reference meanwhile see no owner, and leave the
+				// counters to the compare-exchange below, which sees their release.
+				object->owner.store(nullptr, std::memory_order_relaxed);
+				auto value = object->shared.load(std::memory_order_relaxed);
+
+				do
+				{
+					if (value & queued_flag)
+					{
+						// the counters will be merged when the queue is drained.
+						object->owner.store(queue, std::memory_order_relaxed);
+						return 1;
+					}
+				} while (!object->shared.compare_exchange_weak(value, value | merged_flag, std::memory_order_acq_rel, std::memory_order_relaxed));
+
+				return static_cast<std::size_t>(shared_count(value));
+			}
+		}
+
+		return object->template remove_shared_reference<Derived>();
+	}
+
+	/**
+	* Returns the number of references currently held on the given object.
+	* The biased references are only visible from the owner thread.
+	*/
+	friend std::size_t reference_count(basic_intrusive_refcount const* obj)
+	{
+		auto count = shared_count(obj->shared.load(std::memory_order_acquire));
+
+		if (obj->owner.load(std::memory_order_relaxed) == detail::biased_refcount_queue::current())
+		{
+			count += static_cast<std::intptr_t>(obj->biased);
+		}
+
+		return static_cast<std::size_t>(count);
+	}
+
+	/**
+	* Returns a value indicating whether the caller holds the only reference to the given object.
+	* Threads other than the owner cannot see the biased references, so they only consider
+	* objects whose ownership has been given up.
+	*/
+	friend bool is_unique_reference(basic_intrusive_refcount const* obj)
+	{
+		auto value = obj->shared.load(std::memory_order_acquire);
+
+		if (obj->owner.load(std::memory_order_relaxed) == detail::biased_refcount_queue::current())
+		{
+			return static_cast<std::intptr_t>(obj->biased) + shared_count(value) == 1;
+		}
+
+		return (value & merged_flag) && shared_count(value) == 1;
+	}
+};
+
+namespace detail
+{
+	template<typename Derived>
+	void destroy_biased_object(Derived const* object, typename Derived::allocator_type* = nullptr)
+	{
+		destroy_node(object);
+	}
+
+	template<typename Derived>
+	void destroy_biased_object(Derived const* object, ...)
+	{
+		delete object;
+	}
+
+	/**
+	* Destroys an object whose counters were merged by its owner thread.
+	* Nodes are returned to their allocator, other objects are deleted.
+	*/
+	template<typename Derived>
+	void destroy_biased(basic_intrusive_refcount<biased_refcount_policy> const* object)
+	{
+		destroy_biased_object(static_cast<Derived const*>(object), nullptr);
+	}
+
+	inline bool biased_refcount_queue::push(object_type const* object) WENDA_NOEXCEPT
+	{
+		auto first = head.load(std::memory_order_acquire);
+
+		do
+		{
+			if (first == closed())
+			{
+				return false;
+			}
+
+			object->next_queued = first;
+		} while (!head.compare_exchange_weak(first, object, std::memory_order_release, std::memory_order_acquire));
+
+		return true;
+	}
+
+	inline void biased_refcount_queue::drain(bool close) WENDA_NOEXCEPT
+	{
+		for (;;)
+		{
+			auto object = head.exchange(close ? closed() : nullptr, std::memory_order_acq_rel);
+
+			if (object == nullptr || object == closed())
+			{
+				return;
+			}
+
+			while (object)
+			{
+				auto next = object->next_queued;
+
+				if (object->merge() == 0)
+				{
+					object->destroy(object);
+				}
+
+				object = next;
+			}
+
+			if (!close)
+			{
+				return;
+			}
+		}
+	}
+}
+
+/**
+* Merges the counters of the objects owned by the current thread that were released by other threads,
+* and destroys those that are no longer referenced.
+* This also happens whenever the owner releases a reference, so this only needs to be called
+* by owner threads that stay idle for long periods.
+*/
+inline void process_biased_references()
+{
+	detail::biased_refcount_queue::current()->drain();
+}
+
+WENDA_FDS_NAMESPACE_END
+
+#endif // WENDA_FDS_BIASED_REFCOUNT_H_INCLUDED
\ No newline at end of file
@@ -23,23 +23,24 @@ namespace detail
 	* @param rightRight The right child of the right node.
 	* @param valueLeft The value of the left node.
 	* @param valueRight The value of the right node.
+	* @param allocator The allocator with which to allocate the new nodes.
 	* @returns A tuple containing the left child as its first element and the right child as its second.
 	* @tparam T The type of the element held by the nodes.
 	*/
-	template<typename T, typename LL, typename LR, typename RL, typename RR, typename ValueL, typename ValueR>
-	std::tuple<intrusive_rb_ptr<T>, intrusive_rb_ptr<T>>
+	template<typename T, typename Traits, typename LL, typename LR, typename RL, typename RR, typename ValueL, typename ValueR>
+	std::tuple<intrusive_rb_ptr<T, Traits>, intrusive_rb_ptr<T, Traits>>
 		balance_create_leftright(LL&& leftLeft, LR&& leftRight, RL&& rightLeft, RR&& rightRight,
-		ValueL&& valueLeft, ValueR&& valueRight)
+		ValueL&& valueLeft, ValueR&& valueRight, typename Traits::allocator_type const& allocator)
 	{
-		auto newLeft = make_redblack_node<T>(
+		auto newLeft = make_redblack_node<T, Traits>(
 			std::forward<ValueL>(valueLeft), NodeColour::Black,
-			std::forward<LL>(leftLeft), std::forward<LR>(leftRight));
+			std::forward<LL>(leftLeft), std::forward<LR>(leftRight), allocator);
 
-		auto newRight = make_redblack_node<T>(
+		auto newRight = make_redblack_node<T, Traits>(
 			std::forward<ValueR>(valueRight), NodeColour::Black,
-			std::forward<RL>(rightLeft), std::forward<RR>(rightRight));
+			std::forward<RL>(rightLeft), std::forward<RR>(rightRight), allocator);
 
-		typedef std::tuple<intrusive_rb_ptr<T>, intrusive_rb_ptr<T>> return_t;
+		typedef std::tuple<intrusive_rb_ptr<T, Traits>, intrusive_rb_ptr<T, Traits>> return_t;
 
 		return return_t(std::move(newLeft), std::move(newRight));
 		}
@@ -50,17 +51,19 @@ namespace detail
 	* @param left The left child of the node to be created.
 	* @param right The right child of the node to be created.
 	* @param value The value of the node to be created.
+	* @param allocator The allocator with which to allocate the new node.
 	* @tparam T The type of the element held by the nodes.
 	*/
-	template<typename T, typename Left, typename Right, typename Value>
-	intrusive_rb_ptr<T> balance_create_middle(NodeColour previousColour, Left&& left, Right&& right, Value&& value)
+	template<typename T, typename Traits, typename Left, typename Right, typename Value>
+	intrusive_rb_ptr<T, Traits> balance_create_middle(NodeColour previousColour, Left&& left, Right&& right, Value&& value,
+		typename Traits::allocator_type const& allocator)
 	{
-		return make_redblack_node<T>(std::forward<Value>(value), previousColour - NodeColour::Black,
-			std::forward<Left>(left), std::forward<Right>(right));
+		return make_redblack_node<T, Traits>(std::forward<Value>(value), previousColour - NodeColour::Black,
+			std::forward<Left>(left), std::forward<Right>(right), allocator);
 	}
 
-	template<typename T>
-	const_rb_pointer<T> adjust_inserted(const_rb_pointer<T> inserted, const_rb_pointer<T> old_node, const_rb_pointer<T> new_node)
+	template<typename T, typename Traits>
+	const_rb_pointer<T, Traits> adjust_inserted(const_rb_pointer<T, Traits> inserted, const_rb_pointer<T, Traits> old_node, const_rb_pointer<T, Traits> new_node)
 	{
 		if (inserted == old_node)
 		{
@@ -82,43 +85,45 @@ namespace detail
 	* @param right The right child of the grandparent node.
 	* @param[in,out] inserted A pointer to the node that has just been inserted.
 	* It will be fixed up if necessary (if the rebalancing has affected the pointed-to node).
+	* @param allocator The allocator with which to allocate the new nodes.
 	* @returns A pointer to an equivalent rebalanced tree.
 	*/
-	template<typename T, typename U>
-	intrusive_rb_ptr<T> balance(NodeColour node_colour, U&& value,
-		const_intrusive_rb_ptr<T> left, const_intrusive_rb_ptr<T> right,
-		const_rb_pointer<T>& inserted)
+	template<typename T, typename Traits = default_node_traits<T>, typename U>
+	intrusive_rb_ptr<T, Traits> balance(NodeColour node_colour, U&& value,
+		const_intrusive_rb_ptr<T, Traits> left, const_intrusive_rb_ptr<T, Traits> right,
+		const_rb_pointer<T, Traits>& inserted,
+		typename Traits::allocator_type const& allocator = typename Traits::allocator_type())
 	{
 		if (node_colour != NodeColour::Black && node_colour != NodeColour::DoubleBlack)
 		{
-			return make_redblack_node<T>(std::forward<U>(value), node_colour, std::move(left), std::move(right));
+			return make_redblack_node<T, Traits>(std::forward<U>(value), node_colour, std::move(left), std::move(right), allocator);
 		}
 
 		if (left && colour(left) == NodeColour::Red)
 		{
 			if (left->get_left() && colour(left->get_left()) == NodeColour::Red)
 			{
-				intrusive_rb_ptr<T> newLeft, newRight;
+				intrusive_rb_ptr<T, Traits> newLeft, newRight;
 
-				std::tie(newLeft, newRight) = balance_create_leftright<T>(
+				std::tie(newLeft, newRight) = balance_create_leftright<T, Traits>(
 					left->get_left()->get_left(), left->get_left()->get_right(), left->get_right(), std::move(right),
-					left->get_left()->get_data(), std::forward<U>(value));
+					left->get_left()->get_data(), std::forward<U>(value), allocator);
 
-				inserted = adjust_inserted<T>(inserted, left->get_left().get(), newLeft.get());
+				inserted = adjust_inserted<T, Traits>(inserted, left->get_left().get(), newLeft.get());
 
-				return balance_create_middle<T>(node_colour, std::move(newLeft), std::move(newRight), left->get_data());
+				return balance_create_middle<T, Traits>(node_colour, std::move(newLeft), std::move(newRight), left->get_data(), allocator);
 			}
 			else if (left->get_right() && colour(left->get_right()) == NodeColour::Red)
 			{
-				intrusive_rb_ptr<T> newLeft, newRight;
+				intrusive_rb_ptr<T, Traits> newLeft, newRight;
 
-				std::tie(newLeft, newRight) = balance_create_leftright<T>(
+				std::tie(newLeft, newRight) = balance_create_leftright<T, Traits>(
 					left->get_left(), left->get_right()->get_left(), left->get_right()->get_right(), std::move(right),
-					left->get_data(), std::forward<U>(value));
+					left->get_data(), std::forward<U>(value), allocator);
 
-				auto retval = balance_create_middle<T>(node_colour, std::move(newLeft), std::move(newRight), left->get_right()->get_data());
+				auto retval = balance_create_middle<T, Traits>(node_colour, std::move(newLeft), std::move(newRight), left->get_right()->get_data(), allocator);
 
-				inserted = adjust_inserted<T>(inserted, left->get_right().get(), retval.get());
+				inserted = adjust_inserted<T, Traits>(inserted, left->get_right().get(), retval.get());
 
 				return retval;
 			}
@@ -128,33 +133,33 @@ namespace detail
 		{
 			if (right->get_left() && colour(right->get_left()) == NodeColour::Red)
 			{
-				intrusive_rb_ptr<T> newLeft, newRight;
+				intrusive_rb_ptr<T, Traits> newLeft, newRight;
 
-				std::tie(newLeft, newRight) = balance_create_leftright<T>(
+				std::tie(newLeft, newRight) = balance_create_leftright<T, Traits>(
 					std::move(left), right->get_left()->get_left(), right->get_left()->get_right(), right->get_right(),
-					std::forward<U>(value), right->get_data());
+					std::forward<U>(value), right->get_data(), allocator);
 
-				auto retval = balance_create_middle<T>(node_colour, std::move(newLeft), std::move(newRight), right->get_left()->get_data());
+				auto retval = balance_create_middle<T, Traits>(node_colour, std::move(newLeft), std::move(newRight), right->get_left()->get_data(), allocator);
 
-				inserted = adjust_inserted<T>(inserted, right->get_left().get(), retval.get());
+				inserted = adjust_inserted<T, Traits>(inserted, right->get_left().get(), retval.get());
 
 				return retval;
 			}
 			else if (right->get_right() && colour(right->get_right()) == NodeColour::Red)
 			{
-				intrusive_rb_ptr<T> newLeft, newRight;
+				intrusive_rb_ptr<T, Traits> newLeft, newRight;
 
-				std::tie(newLeft, newRight) = balance_create_leftright<T>(
+				std::tie(newLeft, newRight) = balance_create_leftright<T, Traits>(
 					std::move(left), right->get_left(), right->get_right()->get_left(), right->get_right()->get_right(),
-					std::forward<U>(value), right->get_right()->get_data());
+					std::forward<U>(value), right->get_right()->get_data(), allocator);
 
-				inserted = adjust_inserted<T>(inserted, right->get_right().get(), newRight.get());
+				inserted = adjust_inserted<T, Traits>(inserted, right->get_right().get(), newRight.get());
 
-				return balance_create_middle<T>(node_colour, std::move(newLeft), std::move(newRight), right->get_data());
+				return balance_create_middle<T, Traits>(node_colour, std::move(newLeft), std::move(newRight), right->get_data(), allocator);
 			}
 		}
 
-		return make_redblack_node<T>(std::forward<U>(value), node_colour, std::move(left), std::move(right));
+		return make_redblack_node<T, Traits>(std::forward<U>(value), node_colour, std::move(left), std::move(right), allocator);
 	}
 }
 
@@ -0,0 +1,123 @@
+#ifndef WENDA_FDS_DETAIL_REDBLACK_TREE_BUILD_H_INCLUDED
+#define WENDA_FDS_DETAIL_REDBLACK_TREE_BUILD_H_INCLUDED
+
+/**
+* @file redblack_tree_build.h
+* This file implements the linear-time construction of red-black trees from sorted ranges.
+* The elements are laid out in a perfectly balanced tree, whose levels are all full except possibly
+* the deepest one. The nodes of the full levels are black, and the nodes of the deepest level are red,
+* which gives every path from the root the same black height without any rebalancing.
+*/
+
+#include "../FDS_common.h"
+#include "redblack_tree_data.h"
+
+#include <cstddef>
+
+WENDA_FDS_NAMESPACE_BEGIN
+
+namespace detail
+{
+	/**
+	* Counts the distinct elements of the given sorted range.
+	* @param first The beginning of the range.
+	* @param last The end of the range.
+	* @param compare The ordering of the range.
+	*/
+	template<typename ForwardIterator, typename Compare>
+	std::size_t count_sorted_unique(ForwardIterator first, ForwardIterator last, Compare const& compare)
+	{
+		if (first == last)
+		{
+			return 0;
+		}
+
+		std::size_t count = 1;
+		auto previous = first;
+
+		while (++first != last)
+		{
+			if (compare(*previous, *first))
+			{
+				count++;
+			}
+
+			previous = first;
+		}
+
+		return count;
+	}
+
+	/**
+	* Returns the number of full levels of a perfectly balanced tree of @p count nodes.
+	* The nodes below these levels are coloured red.
+	*/
+	inline std::size_t full_levels(std::size_t count) WENDA_NOEXCEPT
+	{
+		std::size_t levels = 0;
+
+		while (count > 0)
+		{
+			count = (count - 1) / 2;
+			levels++;
+		}
+
+		return levels;
+	}
+
+	/**
+	* Builds a balanced subtree from the next @p count distinct elements of a sorted range.
+	* Equivalent elements are collapsed into the first one.
+	* @param first The iterator to the next element of the range, which is advanced past the consumed elements.
+	* @param last The end of the range.
+	* @param count The number of distinct elements to consume.
+	* @param depth The depth of the subtree in the tree.
+	* @param red_depth The depth at which the nodes are coloured red.
+	* @param compare The ordering of the range.
+	* @param allocator The allocator with which to allocate the nodes.
+	* @returns A pointer to the root of the subtree, carrying its colour.
+	*/
+	template<typename T, typename Traits, typename ForwardIterator, typename Compare>
+	const_intrusive_rb_ptr<T, Traits> build_sorted(ForwardIterator& first, ForwardIterator const& last, std::size_t count,
+		std::size_t depth, std::size_t red_depth, Compare const& compare, typename Traits::allocator_type const& allocator)
+	{
+		if (count == 0)
+		{
+			return make_null_redblack_node<T, Traits>();
+		}
+
+		auto leftCount = (count - 1) / 2;
+		auto left = build_sorted<T, Traits>(first, last, leftCount, depth + 1, red_depth, compare, allocator);
+
+		auto current = first;
+
+		while (++first != last && !compare(*current, *first))
+		{
+		}
+
+		auto right = build_sorted<T, Traits>(first, last, count - 1 - leftCount, depth + 1, red_depth, compare, allocator);
+
+		return make_redblack_node<T, Traits>(*current, depth == red_depth ? NodeColour::Red : NodeColour::Black,
+			std::move(left), std::move(right), allocator);
+	}
+
+	/**
+	* Builds a red-black tree from the given sorted range, in linear time and with one allocation per distinct element.
+	* @param first The beginning of the range. Its elements must be sorted with respect to @p compare.
+	* @param last The end of the range.
+	* @param compare The ordering of the tree.
+	* @param allocator The allocator with which to allocate the nodes.
+	* @returns A pointer to the root of the new tree.
+	*/
+	template<typename T, typename Traits, typename ForwardIterator, typename Compare>
+	const_intrusive_rb_ptr<T, Traits> build_sorted(ForwardIterator first, ForwardIterator last, Compare const& compare,
+		typename Traits::allocator_type const& allocator)
+	{
+		auto count = count_sorted_unique(first, last, compare);
+		return build_sorted<T, Traits>(first, last, count, 0, full_levels(count), compare, allocator);
+	}
+}
+
+WENDA_FDS_NAMESPACE_END
+
+#endif // WENDA_FDS_DETAIL_REDBLACK_TREE_BUILD_H_INCLUDED
\ No newline at end of file
@@ -8,6 +8,10 @@
 
 #include "../FDS_common.h"
 #include "../intrusive_packed_ptr.h"
+#include "../node_traits.h"
+
+#include <cstddef>
+#include <limits>
 
 WENDA_FDS_NAMESPACE_BEGIN
 
@@ -35,42 +39,74 @@ namespace detail
 		return NodeColour((static_cast<std::uint_fast32_t>(left) -static_cast<std::uint_fast32_t>(right)) % 4);
 	}
 
-	template<typename T>
+	/**
+	* The maximum height of a red-black tree. As a red-black tree of n elements has a height of at most 2 log2(n + 1),
+	* this bounds the height of any tree that fits in memory, and the algorithms may record paths in arrays of this size.
+	*/
+	const std::size_t redblack_max_height = 2 * std::numeric_limits<std::size_t>::digits;
+
+	template<typename T, typename Traits = default_node_traits<T>>
 	class redblack_tree_iterator;
 
-	template<typename T>
+	template<typename T, typename Traits = default_node_traits<T>>
 	class redblack_node;
 
-	template<typename T> using rb_pointer = packed_ptr<redblack_node<T>>;
-	template<typename T> using const_rb_pointer = packed_ptr<const redblack_node<T>>;
-	template<typename T> using intrusive_rb_ptr = intrusive_packed_ptr<redblack_node<T>>;
-	template<typename T> using const_intrusive_rb_ptr = intrusive_packed_ptr<const redblack_node<T>>;
+	// The pointer aliases are defined through the node, and are therefore not deducible.
+	// Functions that must deduce the node type from their arguments spell out the pointer types instead.
+	template<typename T, typename Traits = default_node_traits<T>> using rb_pointer = typename redblack_node<T, Traits>::pointer;
+	template<typename T, typename Traits = default_node_traits<T>> using const_rb_pointer = typename redblack_node<T, Traits>::const_pointer;
+	template<typename T, typename Traits = default_node_traits<T>> using intrusive_rb_ptr = typename redblack_node<T, Traits>::intrusive_pointer;
+	template<typename T, typename Traits = default_node_traits<T>> using const_intrusive_rb_ptr = typename redblack_node<T, Traits>::const_intrusive_pointer;
+
+	/**
+	* Creates a null redblack node (that is, a node with no content) of  the given @p colour.
+	* @param colour The colour of the node to create.
+	*/
+	template<typename T, typename Traits = default_node_traits<T>>
+	const_rb_pointer<T, Traits> make_null_redblack_node(NodeColour colour = NodeColour::Black) WENDA_NOEXCEPT
+	{
+		const_rb_pointer<T, Traits> ptr(nullptr);
+		ptr.set_value(static_cast<std::uint_fast32_t>(colour));
+		return ptr;
+	}
 
 	/**
 	* This class represents a node in a red-black tree.
 	* @tparam T The type of the elements stored by the node.
+	* @tparam Traits The @ref node_traits of the node, which determine how it is allocated and reference counted.
 	*/
-	template<typename T>
+	template<typename T, typename Traits>
 	class redblack_node
-		: public intrusive_refcount
+		: public Traits::refcount_type,
+		public augmented_value_holder<T, typename Traits::augmentation_type, allocator_holder<typename Traits::allocator_type>>
 	{
+	public:
+		typedef typename Traits::allocator_type allocator_type; ///< The allocator used for the nodes.
+		typedef packed_ptr<redblack_node> pointer;
+		typedef packed_ptr<const redblack_node> const_pointer;
+		typedef intrusive_packed_ptr<redblack_node, node_deleter<redblack_node>> intrusive_pointer;
+		typedef intrusive_packed_ptr<const redblack_node, node_deleter<redblack_node>> const_intrusive_pointer;
+	private:
 		T data; ///< The data held by the node
-		const_intrusive_rb_ptr<T> left; ///< A pointer to the smaller (left) child, or null.
-		const_intrusive_rb_ptr<T> right; ///< A pointer to the greater (right) child, or null.
+		const_intrusive_pointer left; ///< A pointer to the smaller (left) child, or null.
+		const_intrusive_pointer right; ///< A pointer to the greater (right) child, or null.
+		std::size_t count; ///< The number of nodes in the subtree rooted at this node, including itself.
 	public:
 		/**
 		* Initializes a new node with the given data.
+		* Nodes should be created with make_redblack_node().
 		*/
-		redblack_node(T data, const_intrusive_rb_ptr<T> left,
-			const_intrusive_rb_ptr<T> right)
-			: data(std::move(data)), left(std::move(left)), right(std::move(right))
+		redblack_node(allocator_type const& allocator, T data, const_intrusive_pointer left,
+			const_intrusive_pointer right)
+			: augmented_value_holder<T, typename Traits::augmentation_type, allocator_holder<allocator_type>>(allocator), data(std::move(data)), left(std::move(left)), right(std::move(right))
 		{
+			update_aggregates();
 		}
 
 		/**
 		* Returns a pointer to the minimum node from this node.
 		*/
-		const_rb_pointer<T> minimum() const WENDA_NOEXCEPT
+		const_pointer minimum() const WENDA_NOEXCEPT
 		{
 			return is_leaf(left) ? this : left->minimum();
 		}
@@ -78,7 +114,7 @@ namespace detail
 		/**
 		* Returns a pointer to the maximum node from this node.
 		*/
-		const_rb_pointer<T> maximum() const WENDA_NOEXCEPT
+		const_pointer maximum() const WENDA_NOEXCEPT
 		{
 			return is_leaf(right) ? this : right->maximum();
 		}
@@ -91,15 +127,15 @@ namespace detail
 		* function used to construct this tree.
 		*/
 		template<typename U, typename Compare>
-		const_rb_pointer<T> find(U&& value, Compare const& comp) const WENDA_NOEXCEPT
+		const_pointer find(U&& value, Compare const& comp) const WENDA_NOEXCEPT
 		{
 			if (comp(value, data))
 			{
-				return is_leaf(left) ? make_null_redblack_node<T>() : left->find(std::forward<U>(value), comp);
+				return is_leaf(left) ? make_null_redblack_node<T, Traits>() : left->find(std::forward<U>(value), comp);
 			}
 			else if (comp(data, value))
 			{
-				return is_leaf(right) ? make_null_redblack_node<T>() : right->find(std::forward<U>(value), comp);
+				return is_leaf(right) ? make_null_redblack_node<T, Traits>() : right->find(std::forward<U>(value), comp);
 			}
 			else
 			{
@@ -114,11 +150,34 @@ namespace detail
 		/**
 		* Gets a pointer to the left child of this node.
 		*/
-		const_intrusive_rb_ptr<T> const& get_left() const { return left; }
+		const_intrusive_pointer const& get_left() const { return left; }
 		/**
 		* Gets a pointer to the right child of this node.
 		*/
-		const_intrusive_rb_ptr<T> const& get_right() const { return right; }
+		const_intrusive_pointer const& get_right() const { return right; }
+		/**
+		* Returns the number of nodes in the subtree rooted at this node, including itself.
+		*/
+		std::size_t size() const WENDA_NOEXCEPT { return count; }
+		/**
+		* Recomputes the size and the augmented value of this node from its children.
+		* This must be called after modifying the children of a node that is not shared, see redblack_tree_transient.
+		*/
+		void update_aggregates()
+		{
+			count = subtree_size(left) + subtree_size(right) + 1;
+			this->update_summary(data, left, right);
+		}
+		/**
+		* Gets a modifiable reference to the left child pointer of this node.
+		* This may only be used on nodes that are not shared, see redblack_tree_transient.
+		*/
+		const_intrusive_pointer& mutable_left() { return left; }
+		/**
+		* Gets a modifiable reference to the right child pointer of this node.
+		* This may only be used on nodes that are not shared, see redblack_tree_transient.
+		*/
+		const_intrusive_pointer& mutable_right() { return right; }
 	};
 
 	/**
@@ -127,36 +186,27 @@ namespace detail
 	* @param colour The colour to be given to the returned pointer.
 	* @param left The left child of the node.
 	* @param right The right child of the node.
+	* @param allocator The allocator with which to allocate the node. It is stored in the node.
 	* @returns A smart pointer to a newly created node with the given data.
 	*/
-	template<typename T, typename U>
-	intrusive_rb_ptr<T> make_redblack_node(U&& data, NodeColour colour = NodeColour::Red,
-		const_intrusive_rb_ptr<T> left = make_null_redblack_node<T>(), const_intrusive_rb_ptr<T> right = make_null_redblack_node<T>())
+	template<typename T, typename Traits = default_node_traits<T>, typename U>
+	intrusive_rb_ptr<T, Traits> make_redblack_node(U&& data, NodeColour colour = NodeColour::Red,
+		const_intrusive_rb_ptr<T, Traits> left = make_null_redblack_node<T, Traits>(),
+		const_intrusive_rb_ptr<T, Traits> right = make_null_redblack_node<T, Traits>(),
+		typename Traits::allocator_type const& allocator = typename Traits::allocator_type())
 	{
-		rb_pointer<T> rb = new redblack_node<T>(std::forward<U>(data), std::move(left), std::move(right));
+		rb_pointer<T, Traits> rb = allocate_node<redblack_node<T, Traits>>(allocator, std::forward<U>(data), std::move(left), std::move(right));
 		rb.set_value(static_cast<std::uint_fast32_t>(colour));
 		return rb;
 	}
 
-	/**
-	* Creates a null redblack node (that is, a node with no content) of  the given @p colour.
-	* @param colour The colour of the node to create.
-	*/
-	template<typename T>
-	const_rb_pointer<T> make_null_redblack_node(NodeColour colour = NodeColour::Black) WENDA_NOEXCEPT
-	{
-		const_rb_pointer<T> ptr(nullptr);
-		ptr.set_value(static_cast<std::uint_fast32_t>(colour));
-		return ptr;
-	}
-
 	/**
 	* Returns a value indicating whether there is any data stored in the node.
 	* @param The node to test.
 	* @returns True if the node is a leaf, that is, there is no data. Otherwise false.
 	*/
-	template<typename T>
-	bool is_leaf(const_rb_pointer<T> node) WENDA_NOEXCEPT
+	template<typename Node>
+	bool is_leaf(packed_ptr<Node> const& node) WENDA_NOEXCEPT
 	{
 		if (!node)
 		{
@@ -170,44 +220,48 @@ namespace detail
 	* Gets a value indicating whether the given @p node is a leaf (or null) node.
 	* @returns True if the node is null, otherwise false.
 	*/
-	template<typename T>
-	bool is_leaf(const_intrusive_rb_ptr<T> const& node) WENDA_NOEXCEPT
+	template<typename Node, typename Deleter>
+	bool is_leaf(intrusive_packed_ptr<Node, Deleter> const& node) WENDA_NOEXCEPT
 	{
 		return is_leaf(node.get());
 	}
 
-	template<typename T>
-	bool is_leaf(intrusive_rb_ptr<T> const& node) WENDA_NOEXCEPT
+	/**
+	* Returns the number of nodes in the subtree rooted at the given node, in constant time.
+	* @param node The root of the subtree. Can be null, in which case the subtree is empty.
+	*/
+	template<typename Node>
+	std::size_t subtree_size(packed_ptr<Node> const& node) WENDA_NOEXCEPT
 	{
-		return is_leaf(node.get());
+		return node ? node->size() : 0;
 	}
 
 	/**
-	* Gets the colour associated to the given node pointer.
-	* @param node The pointer for which to get the colour. Can be null.
+	* Returns the number of nodes in the subtree rooted at the given node, in constant time.
+	* @param node The root of the subtree. Can be null, in which case the subtree is empty.
 	*/
-	template<typename T>
-	NodeColour colour(const_rb_pointer<T> node) WENDA_NOEXCEPT
+	template<typename Node, typename Deleter>
+	std::size_t subtree_size(intrusive_packed_ptr<Node, Deleter> const& node) WENDA_NOEXCEPT
 	{
-		return static_cast<NodeColour>(node.get_value());
+		return subtree_size(node.get());
 	}
 
 	/**
 	* Gets the colour associated to the given node pointer.
 	* @param node The pointer for which to get the colour. Can be null.
 	*/
-	template<typename T>
-	NodeColour colour(intrusive_rb_ptr<T> const& node) WENDA_NOEXCEPT
+	template<typename Node>
+	NodeColour colour(packed_ptr<Node> const& node) WENDA_NOEXCEPT
 	{
-		return colour(node.get());
+		return static_cast<NodeColour>(node.get_value());
 	}
 
 	/**
 	* Gets the colour associated to the given node pointer.
 	* @param node The pointer for which to get the colour. Can be null.
 	*/
-	template<typename T>
-	NodeColour colour(const_intrusive_rb_ptr<T> const& node) WENDA_NOEXCEPT
+	template<typename Node, typename Deleter>
+	NodeColour colour(intrusive_packed_ptr<Node, Deleter> const& node) WENDA_NOEXCEPT
 	{
 		return colour(node.get());
 	}
@@ -217,20 +271,14 @@ namespace detail
 	* @param node A reference to the node for which to set the colour.
 	* @param colour The colour to be set.
 	*/
-	template<typename T>
-	void set_colour(const_rb_pointer<T>& node, NodeColour colour)
-	{
-		node.set_value(static_cast <std::uint_fast32_t>(colour));
-	}
-
-	template<typename T>
-	void set_colour(intrusive_rb_ptr<T>& node, NodeColour colour)
+	template<typename Node>
+	void set_colour(packed_ptr<Node>& node, NodeColour colour)
 	{
 		node.set_value(static_cast <std::uint_fast32_t>(colour));
 	}
 
-	template<typename T>
-	void set_colour(const_intrusive_rb_ptr<T>& node, NodeColour colour)
+	template<typename Node, typename Deleter>
+	void set_colour(intrusive_packed_ptr<Node, Deleter>& node, NodeColour colour)
 	{
 		node.set_value(static_cast <std::uint_fast32_t>(colour));
 	}
@@ -240,15 +288,15 @@ namespace detail
 	* @param pointer A pointer to the node for which to change the colour.
 	* @returns A pointer to the same node, but coloured black.
 	*/
-	template<typename T>
-	const_intrusive_rb_ptr<T> make_black(const_rb_pointer<T> pointer)
+	template<typename T, typename Traits>
+	const_intrusive_rb_ptr<T, Traits> make_black(packed_ptr<const redblack_node<T, Traits>> pointer)
 	{
 		set_colour(pointer, NodeColour::Black);
 		return pointer;
 	}
 
-	template<typename T>
-	const_intrusive_rb_ptr<T> make_black(const_intrusive_rb_ptr<T> pointer)
+	template<typename T, typename Traits>
+	const_intrusive_rb_ptr<T, Traits> make_black(intrusive_packed_ptr<const redblack_node<T, Traits>, node_deleter<redblack_node<T, Traits>>> pointer)
 	{
 		set_colour(pointer, NodeColour::Black);
 		return pointer;
@@ -259,8 +307,8 @@ namespace detail
 	* @param A pointer to the node for which to change the colour.
 	* @returns A pointer tothe same node, but coloured red.
 	*/
-	template<typename T>
-	const_intrusive_rb_ptr<T> make_red(const_rb_pointer<T> pointer)
+	template<typename T, typename Traits>
+	const_intrusive_rb_ptr<T, Traits> make_red(packed_ptr<const redblack_node<T, Traits>> pointer)
 	{
 		set_colour(pointer, NodeColour::Red);
 		return pointer;
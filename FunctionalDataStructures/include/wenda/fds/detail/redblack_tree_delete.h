@@ -7,88 +7,94 @@
 */
 
 #include "../FDS_common.h"
+#include "../three_way_compare.h"
 #include "redblack_tree_data.h"
 #include "redblack_tree_balance.h"
 
+#include <cassert>
+#include <tuple>
+
 WENDA_FDS_NAMESPACE_BEGIN
 
 namespace detail
 {
 	/**
 	* Extended balance operation as described in http://matt.might.net/articles/red-black-delete/ to balance
-	* trees after a bubble operation. This handles double blacks and negative blacks, and may recursively call itself
-	* once in the case of a negative black.
+	* trees after a bubble operation. This handles double blacks and negative blacks, and may call balance()
+	* once more in the case of a negative black.
 	* @sa balance()
 	*/
-	template<typename T, typename U>
-	intrusive_rb_ptr<T> bubble_balance(NodeColour node_colour, U&& value, const_intrusive_rb_ptr<T> left, const_intrusive_rb_ptr<T> right)
+	template<typename T, typename Traits = default_node_traits<T>, typename U>
+	intrusive_rb_ptr<T, Traits> bubble_balance(NodeColour node_colour, U&& value,
+		const_intrusive_rb_ptr<T, Traits> left, const_intrusive_rb_ptr<T, Traits> right,
+		typename Traits::allocator_type const& allocator = typename Traits::allocator_type())
 	{
+		const_rb_pointer<T, Traits> dummy = nullptr;
+
 		if (node_colour == NodeColour::DoubleBlack)
 		{
-			const_rb_pointer<T> dummy;
-
 			if (colour(left) == NodeColour::NegativeBlack)
 			{
-				assert(left->get_left());
-				assert(left->get_right());
-				assert(colour(left->get_left()) == NodeColour::Black);
-				assert(colour(left->get_right()) == NodeColour::Black);
-
-				auto newLeft = balance<T>(NodeColour::Black, left->get_data(), make_red(left->get_left().get()), left->get_right()->get_left(), dummy);
-				auto newRight = make_redblack_node<T>(std::forward<U>(value), NodeColour::Black, left->get_right(), std::move(right));
-				return make_redblack_node<T>(left->get_right()->get_data(), NodeColour::Black, std::move(newLeft), std::move(newRight));
+				// BB (-B a x (B b y c)) z d => B (balance B (R a) x b) y (B c z d)
+				assert(colour(left->get_left()) == NodeColour::Black && !is_leaf(left->get_left()));
+				assert(colour(left->get_right()) == NodeColour::Black && !is_leaf(left->get_right()));
+
+				auto const& middle = left->get_right();
+				auto newLeft = balance<T, Traits>(NodeColour::Black, left->get_data(), make_red(left->get_left().get()), middle->get_left(), dummy, allocator);
+				auto newRight = make_redblack_node<T, Traits>(std::forward<U>(value), NodeColour::Black, middle->get_right(), std::move(right), allocator);
+				return make_redblack_node<T, Traits>(middle->get_data(), NodeColour::Black, std::move(newLeft), std::move(newRight), allocator);
 			}
 			else if (colour(right) == NodeColour::NegativeBlack)
 			{
-				assert(right->get_left());
-				assert(right->get_right());
-				assert(colour(right->get_left()) == NodeColour::Black);
-				assert(colour(right->get_right()) == NodeColour::Black);
-
-				auto newRight = balance<T>(NodeColour::Black, right->get_data(), make_red(right->get_right().get()), right->get_left()->get_right(), dummy);
-				auto newLeft = make_redblack_node<T>(std::forward<U>(value), NodeColour::Black, right->get_left(), std::move(left));
-				return make_redblack_node<T>(right->get_left()->get_data(), NodeColour::Black, std::move(newLeft), std::move(newRight));
+				// BB a x (-B (B b y c) z d) => B (B a x b) y (balance B c z (R d))
+				assert(colour(right->get_left()) == NodeColour::Black && !is_leaf(right->get_left()));
+				assert(colour(right->get_right()) == NodeColour::Black && !is_leaf(right->get_right()));
+
+				auto const& middle = right->get_left();
+				auto newLeft = make_redblack_node<T, Traits>(std::forward<U>(value), NodeColour::Black, std::move(left), middle->get_left(), allocator);
+				auto newRight = balance<T, Traits>(NodeColour::Black, right->get_data(), middle->get_right(), make_red(right->get_right().get()), dummy, allocator);
+				return make_redblack_node<T, Traits>(middle->get_data(), NodeColour::Black, std::move(newLeft), std::move(newRight), allocator);
 			}
 		}
 
-		const_rb_pointer<T> dummy = nullptr;
-		return balance(node_colour, std::forward<U>(value), std::move(left), std::move(right), dummy);
+		return balance<T, Traits>(node_colour, std::forward<U>(value), std::move(left), std::move(right), dummy, allocator);
 	}
 
-	template<typename T, typename U>
-	intrusive_rb_ptr<T> bubble(NodeColour node_colour, U&& value, const_intrusive_rb_ptr<T> left, const_intrusive_rb_ptr<T> right)
+	/**
+	* Creates a node with the given children, one of which may be double black after a removal.
+	* The extra black is moved from the children to the new node, which is then rebalanced by bubble_balance().
+	*/
+	template<typename T, typename Traits = default_node_traits<T>, typename U>
+	intrusive_rb_ptr<T, Traits> bubble(NodeColour node_colour, U&& value,
+		const_intrusive_rb_ptr<T, Traits> left, const_intrusive_rb_ptr<T, Traits> right,
+		typename Traits::allocator_type const& allocator = typename Traits::allocator_type())
 	{
 		if (colour(left) == NodeColour::DoubleBlack || colour(right) == NodeColour::DoubleBlack)
 		{
-			const_rb_pointer<T> inserted_dummy = nullptr;
 			set_colour(left, colour(left) - NodeColour::Black);
 			set_colour(right, colour(right) - NodeColour::Black);
 
-			return balance(node_colour + NodeColour::Black, std::forward<U>(value), std::move(left), std::move(right), inserted_dummy);
+			return bubble_balance<T, Traits>(node_colour + NodeColour::Black, std::forward<U>(value), std::move(left), std::move(right), allocator);
 		}
 		else
 		{
-			return make_redblack_node<T>(std::forward<U>(value), node_colour, std::move(left), std::move(right));
+			return make_redblack_node<T, Traits>(std::forward<U>(value), node_colour, std::move(left), std::move(right), allocator);
 		}
 	}
 
-	template<typename T>
-	const_intrusive_rb_ptr<T> remove_node(const_rb_pointer<T> node)
+	/**
+	* Returns the subtree replacing the given node once it is removed.
+	* The replacement may be a double black leaf, which must be bubbled up by the caller.
+	* @param node The node to remove, which must have at most one child.
+	* Nodes with two children are removed by find_delete_node(), which replaces their value by that of their successor.
+	*/
+	template<typename T, typename Traits = default_node_traits<T>>
+	const_intrusive_rb_ptr<T, Traits> remove_node(const_rb_pointer<T, Traits> node,
+		typename Traits::allocator_type const& = typename Traits::allocator_type())
 	{
-		if (node->get_left() && node->get_right())
-		{
-			// two children case
-			// remove the maximum descendant of the left child,
-			// and write its value into the current node.
-			auto max = node->get_left()->maximum();
-
-			auto removed = remove_node(max);
-
-			auto newLeft = make_redblack_node<T>(node->get_left()->get_data(), colour(node->get_left()), node->get_left()->get_left(), removed);
+		assert(!node->get_left() || !node->get_right());
 
-			return make_redblack_node<T>(max->get_data(), colour(node), newLeft, node->get_right());
-		}
-		else if (node->get_left() || node->get_right())
+		if (node->get_left() || node->get_right())
 		{
 			// one child case. The child must be red, the parent black (otherwise violates RB condition).
 			auto child = node->get_left() ? node->get_left() : node->get_right();
@@ -101,38 +107,78 @@ namespace detail
 		{
 			// no children
 			// return an empty node with the correct colour.
-			return make_null_redblack_node<T>(colour(node) + NodeColour::Black);
+			return make_null_redblack_node<T, Traits>(colour(node) + NodeColour::Black);
 		}
 	}
 
-    template<typename T, typename U, typename Compare>
-	std::tuple<const_intrusive_rb_ptr<T>, bool> 
-	find_delete_node(const_rb_pointer<T> tree, U&& value, Compare const& compare)
+	/**
+	* Removes the element equivalent to @p value from the given tree.
+	* The search path is recorded in a bounded buffer while descending with a single comparison per level, see search_order().
+	* If the element has two children, the descent continues to its successor, which is the node actually removed,
+	* and whose value replaces that of the element. The path is then rebuilt once from the removed node to the root,
+	* bubbling up the extra black left by the removal of a black node.
+	* @param tree The root of the tree.
+	* @param value The key of the element to remove, which is compared with the elements of the tree.
+	* @param compare The comparison function of the tree.
+	* @param allocator The allocator with which to allocate the new nodes.
+	* @returns A tuple of the new root, which may be double black, and a boolean indicating whether an element was removed.
+	* If no element was removed, the new root is null, and nothing is allocated.
+	*/
+	template<typename T, typename Traits, typename U, typename Compare>
+	std::tuple<const_intrusive_rb_ptr<T, Traits>, bool>
+	find_delete_node(const_rb_pointer<T, Traits> tree, U const& value, Compare const& compare,
+		typename Traits::allocator_type const& allocator)
 	{
-		if (!tree)
-		{
-			return std::make_tuple(make_null_redblack_node<T>(), false);
-		}
+		typedef std::tuple<const_intrusive_rb_ptr<T, Traits>, bool> return_t;
 
-		const_intrusive_rb_ptr<T> newTree;
-		bool deleted;
+		const_rb_pointer<T, Traits> path[redblack_max_height];
+		bool wentLeft[redblack_max_height];
+		std::size_t depth = 0;
+		std::size_t candidate = redblack_max_height;
+		bool found = false;
 
-		if (compare(value, tree->get_data()))
+		for (auto node = tree; node; depth++)
 		{
-			std::tie(newTree, deleted) = find_delete_node(tree->get_left().get(), std::forward<U>(value), compare);
+			assert(depth < redblack_max_height);
+			path[depth] = node;
+
+			// the candidate is the last node not greater than the value. If it is equivalent to the value, the descent
+			// continues through its right child, and thus ends at its successor.
+			auto order = found ? -1 : search_order(compare, value, node->get_data());
+			wentLeft[depth] = order < 0;
+
+			if (wentLeft[depth])
+			{
+				node = node->get_left().get();
+			}
+			else
+			{
+				candidate = depth;
+				found = order == 0;
+				node = node->get_right().get();
+			}
 		}
-		else if (compare(tree->get_data(), value))
+
+		if (!found && (candidate == redblack_max_height || !candidate_equivalent(compare, path[candidate]->get_data(), value)))
 		{
-			std::tie(newTree, deleted) = find_delete_node(tree->get_right().get(), std::forward<U>(value), compare);
+			return return_t(const_intrusive_rb_ptr<T, Traits>(), false);
 		}
-		else
+
+		// the last node of the path is either the element itself, if it has no right child, or its successor.
+		auto removed = path[--depth];
+		auto subtree = remove_node<T, Traits>(removed, allocator);
+
+		while (depth-- > 0)
 		{
-			newTree = remove_node(std::move(tree));
-			deleted = true;
+			auto parent = path[depth];
+			auto const& data = depth == candidate ? removed->get_data() : parent->get_data();
+
+			subtree = wentLeft[depth]
+				? bubble<T, Traits>(colour(parent), data, std::move(subtree), parent->get_right(), allocator)
+				: bubble<T, Traits>(colour(parent), data, parent->get_left(), std::move(subtree), allocator);
 		}
 
-		typedef std::tuple<const_intrusive_rb_ptr<T>, bool> return_t;
-		return return_t(newTree, deleted);
+		return return_t(std::move(subtree), true);
 	}
 }
 
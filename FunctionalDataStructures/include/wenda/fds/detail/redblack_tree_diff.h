@@ -0,0 +1,413 @@
+#ifndef WENDA_FDS_DETAIL_REDBLACK_TREE_DIFF_H_INCLUDED
+#define WENDA_FDS_DETAIL_REDBLACK_TREE_DIFF_H_INCLUDED
+
+/**
+* @file redblack_tree_diff.h
+* This file implements the comparison of two versions of a red-black tree.
+* Both trees are walked in order at the same time, and whenever both walks reach the same node,
+* the subtree rooted at that node is skipped, as it holds the same elements in both trees.
+* As versions derived from one another share every subtree off their update paths, comparing them
+* visits O(k log n) nodes for k differences, instead of all the elements of both trees.
+* For trees caching a hash of their subtrees, see @ref hash_augmentation, subtrees of equal sizes and hashes
+* which are not shared are compared element by element with operator==, which is cheaper than walking them,
+* and skipped if they hold equal elements. Subtrees with different hashes are known to differ.
+* The changes found between two versions are also merged into a third version here, see merge_changes().
+*/
+
+#include "../FDS_common.h"
+#include "redblack_tree_data.h"
+#include "redblack_tree_iterator.h"
+
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+WENDA_FDS_NAMESPACE_BEGIN
+
+namespace detail
+{
+	/**
+	* This class implements an in-order walk over a tree, which may skip whole subtrees.
+	* The walk holds a stack of pending subtrees. A subtree is either pending as a whole, or only its root and right child are
+	* pending, after its left child has been expanded.
+	*/
+	template<typename T, typename Traits>
+	class diff_cursor
+	{
+	public:
+		typedef redblack_node<T, Traits> const* node_pointer;
+	private:
+		struct frame
+		{
+			node_pointer node;
+			bool whole; ///< Whether the whole subtree is pending, or only its root and right child.
+		};
+
+		frame stack[redblack_max_height + 1];
+		std::size_t depth;
+
+		void push_subtree(node_pointer node) WENDA_NOEXCEPT
+		{
+			if (node)
+			{
+				assert(depth <= redblack_max_height);
+				stack[depth++] = frame{ node, true };
+			}
+		}
+	public:
+		/**
+		* Initializes a walk over the tree rooted at the given node.
+		*/
+		explicit diff_cursor(node_pointer root) WENDA_NOEXCEPT
+			: depth(0)
+		{
+			push_subtree(root);
+		}
+
+		/**
+		* Returns a value indicating whether the walk is over.
+		*/
+		bool empty() const WENDA_NOEXCEPT
+		{
+			return depth == 0;
+		}
+
+		/**
+		* Returns the node at the top of the stack.
+		*/
+		node_pointer node() const WENDA_NOEXCEPT
+		{
+			return stack[depth - 1].node;
+		}
+
+		/**
+		* Returns a value indicating whether the whole subtree at the top of the stack is pending.
+		* Otherwise, the next element of the walk is the one held by node().
+		*/
+		bool whole() const WENDA_NOEXCEPT
+		{
+			return stack[depth - 1].whole;
+		}
+
+		/**
+		* Returns the number of elements pending in the subtree at the top of the stack.
+		*/
+		std::size_t pending_size() const WENDA_NOEXCEPT
+		{
+			auto node = this->node();
+			return whole() ? node->size() : subtree_size(node->get_right()) + 1;
+		}
+
+		/**
+		* Replaces the whole subtree at the top of the stack by its root and right child, followed by its left child.
+		*/
+		void expand() WENDA_NOEXCEPT
+		{
+			auto& top = stack[depth - 1];
+			assert(top.whole);
+
+			top.whole = false;
+			push_subtree(top.node->get_left().get().get());
+		}
+
+		/**
+		* Moves past the element held by node(), whose left child must have been visited.
+		*/
+		void advance() WENDA_NOEXCEPT
+		{
+			assert(!whole());
+			push_subtree(stack[--depth].node->get_right().get().get());
+		}
+
+		/**
+		* Skips all the elements pending at the top of the stack.
+		*/
+		void skip() WENDA_NOEXCEPT
+		{
+			--depth;
+		}
+	};
+
+	/**
+	* Returns a value indicating whether the given subtrees hold the same elements, which is only known if they are the same node.
+	*/
+	template<typename T, typename Traits, typename Node>
+	bool same_subtree(Node const* left, Node const* right, std::false_type) WENDA_NOEXCEPT
+	{
+		return left == right;
+	}
+
+	/**
+	* Returns a value indicating whether the given subtrees hold the same elements.
+	* Subtrees of different sizes or hashes differ, otherwise their elements are compared in order with operator==,
+	* as equal hashes are only very likely to be those of equal elements.
+	*/
+	template<typename T, typename Traits, typename Node>
+	bool same_subtree(Node const* left, Node const* right, std::true_type)
+	{
+		if (left == right)
+		{
+			return true;
+		}
+
+		if (left->size() != right->size() || left->get_summary() != right->get_summary())
+		{
+			return false;
+		}
+
+		redblack_tree_iterator<T, Traits> left_element(left, true);
+		redblack_tree_iterator<T, Traits> right_element(right, true);
+
+		for (auto count = left->size(); count != 0; count--, ++left_element, ++right_element)
+		{
+			if (!(*left_element == *right_element))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	/**
+	* Returns a value indicating whether the trees with the given roots are known to hold different elements,
+	* which is only the case for trees caching a hash of their elements, whose hashes differ.
+	*/
+	template<typename Node>
+	bool known_different(Node const*, Node const*, std::false_type) WENDA_NOEXCEPT
+	{
+		return false;
+	}
+
+	template<typename Node>
+	bool known_different(Node const* left, Node const* right, std::true_type) WENDA_NOEXCEPT
+	{
+		return left && right && left->get_summary() != right->get_summary();
+	}
+
+	/**
+	* Walks two trees in order at the same time, reporting the differences between them to @p visitor.
+	* Subtrees shared by both trees are skipped without being visited.
+	* @param older The root of the first tree.
+	* @param newer The root of the second tree.
+	* @param compare The comparison function of the trees.
+	* @param visitor The visitor to which the differences are reported. It must implement:
+	* - removed(element), called for the elements of @p older which have no equivalent in @p newer;
+	* - added(element), called for the elements of @p newer which have no equivalent in @p older;
+	* - changed(old_element, new_element), called for the equivalent elements which are not equal by operator==.
+	* Each function returns a boolean indicating whether to continue the walk.
+	* @returns False if the walk was stopped by the visitor, true otherwise.
+	*/
+	template<typename T, typename Traits, typename Compare, typename Visitor>
+	bool diff(const_rb_pointer<T, Traits> older, const_rb_pointer<T, Traits> newer, Compare const& compare, Visitor& visitor)
+	{
+		diff_cursor<T, Traits> left(older.get());
+		diff_cursor<T, Traits> right(newer.get());
+
+		while (!left.empty() || !right.empty())
+		{
+			if (!left.empty() && !right.empty() && (left.whole() && right.whole()
+				? same_subtree<T, Traits>(left.node(), right.node(), is_hash_augmentation<typename Traits::augmentation_type>())
+				: left.node() == right.node() && !left.whole() && !right.whole()))
+			{
+				left.skip();
+				right.skip();
+				continue;
+			}
+
+			// expand the larger of the pending subtrees first, as it may contain the other one.
+			if (!left.empty() && left.whole() && (right.empty() || !right.whole() || left.pending_size() >= right.pending_size()))
+			{
+				left.expand();
+				continue;
+			}
+
+			if (!right.empty() && right.whole())
+			{
+				right.expand();
+				continue;
+			}
+
+			if (right.empty() || (!left.empty() && compare(left.node()->get_data(), right.node()->get_data())))
+			{
+				if (!visitor.removed(left.node()->get_data()))
+				{
+					return false;
+				}
+
+				left.advance();
+			}
+			else if (left.empty() || compare(right.node()->get_data(), left.node()->get_data()))
+			{
+				if (!visitor.added(right.node()->get_data()))
+				{
+					return false;
+				}
+
+				right.advance();
+			}
+			else
+			{
+				if (!(left.node()->get_data() == right.node()->get_data()) && !visitor.changed(left.node()->get_data(), right.node()->get_data()))
+				{
+					return false;
+				}
+
+				left.advance();
+				right.advance();
+			}
+		}
+
+		return true;
+	}
+
+	/**
+	* Visitor for diff() forwarding the differences to three functions.
+	*/
+	template<typename Removed, typename Added, typename Changed>
+	struct diff_function_visitor
+	{
+		Removed& on_removed;
+		Added& on_added;
+		Changed& on_changed;
+
+		template<typename T>
+		bool removed(T const& element)
+		{
+			on_removed(element);
+			return true;
+		}
+
+		template<typename T>
+		bool added(T const& element)
+		{
+			on_added(element);
+			return true;
+		}
+
+		template<typename T>
+		bool changed(T const& old_element, T const& new_element)
+		{
+			on_changed(old_element, new_element);
+			return true;
+		}
+	};
+
+	/**
+	* Visitor for diff() stopping at the first difference.
+	*/
+	struct diff_equal_visitor
+	{
+		template<typename T>
+		bool removed(T const&) const WENDA_NOEXCEPT
+		{
+			return false;
+		}
+
+		template<typename T>
+		bool added(T const&) const WENDA_NOEXCEPT
+		{
+			return false;
+		}
+
+		template<typename T>
+		bool changed(T const&, T const&) const WENDA_NOEXCEPT
+		{
+			return false;
+		}
+	};
+
+	/**
+	* This struct records the change of the element of one key between a base version and a newer version of a tree.
+	*/
+	template<typename T>
+	struct version_change
+	{
+		T const* base; ///< The element of the base version, or null if the key was added.
+		T const* changed; ///< The element of the newer version, or null if the key was removed.
+
+		/**
+		* Returns the element of either version, which is used to order the changes by key.
+		*/
+		T const& element() const WENDA_NOEXCEPT
+		{
+			return changed ? *changed : *base;
+		}
+	};
+
+	/**
+	* Visitor for diff() recording the differences in a vector of @ref version_change, in increasing order.
+	*/
+	template<typename T>
+	struct diff_change_recorder
+	{
+		std::vector<version_change<T>>& changes;
+
+		bool removed(T const& element)
+		{
+			changes.push_back(version_change<T>{ &element, nullptr });
+			return true;
+		}
+
+		bool added(T const& element)
+		{
+			changes.push_back(version_change<T>{ nullptr, &element });
+			return true;
+		}
+
+		bool changed(T const& old_element, T const& new_element)
+		{
+			changes.push_back(version_change<T>{ &old_element, &new_element });
+			return true;
+		}
+	};
+
+	/**
+	* Returns a value indicating whether the given elements, either of which may be null, are the same.
+	*/
+	template<typename T>
+	bool same_element(T const* left, T const* right)
+	{
+		return left == right || (left && right && *left == *right);
+	}
+
+	/**
+	* Merges the changes made by a version of a tree to its base version into another version derived from the same base.
+	* @param changes The changes made by the merged version, in increasing order.
+	* @param find The function returning a pointer to the element of the other version equivalent to a given element,
+	* or null if there is none.
+	* @param resolver The function called with pointers to the base, current and changed elements of the keys changed differently
+	* by both versions, any of which may be null if the key is absent from that version. It returns a pointer to the element to keep,
+	* or null to remove the key.
+	* @param apply The function called as apply(current, target) for each key to change in the other version, where @p current is
+	* the element of the other version, and @p target the element to replace it with. Either may be null.
+	*/
+	template<typename T, typename Find, typename Resolver, typename Apply>
+	void merge_changes(std::vector<version_change<T>> const& changes, Find& find, Resolver& resolver, Apply& apply)
+	{
+		for (auto const& change : changes)
+		{
+			T const* current = find(change.element());
+
+			if (same_element(current, change.base))
+			{
+				// the key is unchanged in the other version.
+				apply(current, change.changed);
+			}
+			else if (!same_element(current, change.changed))
+			{
+				T const* resolved = resolver(change.base, current, change.changed);
+
+				if (resolved != current)
+				{
+					apply(current, resolved);
+				}
+			}
+		}
+	}
+}
+
+WENDA_FDS_NAMESPACE_END
+
+#endif // WENDA_FDS_DETAIL_REDBLACK_TREE_DIFF_H_INCLUDED
\ No newline at end of file
@@ -2,9 +2,13 @@
 #define WENDA_FDS_DETAIL_REDBLACK_TREE_ITERATOR_H_INCLUDED
 
 #include "../FDS_common.h"
+#include "../three_way_compare.h"
 #include "redblack_tree_data.h"
 
-#include <stack>
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
 
 WENDA_FDS_NAMESPACE_BEGIN
 
@@ -13,94 +17,266 @@ namespace detail {
 	/**
 	* This class implements an iterator for the red-black tree.
 	* The iterators for red-black trees model bidirectional iterators.
+	* The iterator stores the path from the root of the tree to the current element in a fixed array,
+	* so that it never allocates, and copying it only copies the part of the path in use.
 	* @tparam T The type of the elements in the tree.
+	* @tparam Traits The @ref node_traits of the nodes of the tree.
 	*/
-	template<typename T>
+	template<typename T, typename Traits>
 	class redblack_tree_iterator
 		: public std::iterator<std::bidirectional_iterator_tag, T, std::ptrdiff_t, T const*, T const&>
 	{
-		const_rb_pointer<T> current;
-		std::stack<const_rb_pointer<T>> stack;
-		bool goRight;
+	public:
+		typedef redblack_node<T, Traits> const* node_pointer; ///< The type of the pointers to the nodes of the path.
+
+	private:
+		node_pointer root; ///< The root of the tree, from which the end iterator is decremented.
+		std::size_t depth; ///< The length of the path, which is zero for the end iterator.
+		node_pointer path[redblack_max_height]; ///< The nodes from the root to the current element.
+
+		node_pointer current() const WENDA_NOEXCEPT
+		{
+			return depth == 0 ? nullptr : path[depth - 1];
+		}
 
-		void next()
+		void push_leftmost(node_pointer node) WENDA_NOEXCEPT
 		{
-			if (goRight)
+			for (; node; node = node->get_left().get().get())
 			{
-				goRight = false;
-				current = current->get_right().get();
+				push(node);
 			}
+		}
 
-			while (current)
+		void push_rightmost(node_pointer node) WENDA_NOEXCEPT
+		{
+			for (; node; node = node->get_right().get().get())
 			{
-				stack.push(current);
-				current = current->get_left().get();
+				push(node);
 			}
+		}
 
-			if (stack.empty())
+		void next() WENDA_NOEXCEPT
+		{
+			if (depth == 0)
 			{
-				current = make_null_redblack_node<T>();
+				// incrementing the end iterator leaves it unchanged.
+				return;
 			}
-			else
+
+			auto right = path[depth - 1]->get_right().get().get();
+
+			if (right)
 			{
-				current = stack.top();
-				stack.pop();
-				goRight = true;
+				push_leftmost(right);
+				return;
 			}
+
+			// go up until the current node is a left child; its parent is the next element.
+			node_pointer child;
+
+			do
+			{
+				child = path[--depth];
+			} while (depth != 0 && path[depth - 1]->get_right().get().get() == child);
 		}
-	public:
-		redblack_tree_iterator() = default;
 
-		redblack_tree_iterator(redblack_tree_iterator const& other)
-			: current(other.current), goRight(other.goRight), stack(other.stack)
-		{}
+		void previous() WENDA_NOEXCEPT
+		{
+			if (depth == 0)
+			{
+				push_rightmost(root);
+				return;
+			}
 
-		redblack_tree_iterator(redblack_tree_iterator&& other)
-			: current(std::move(other.current)), goRight(std::move(other.goRight)), stack(std::move(other.stack))
+			auto left = path[depth - 1]->get_left().get().get();
+
+			if (left)
+			{
+				push_rightmost(left);
+				return;
+			}
+
+			// go up until the current node is a right child; its parent is the previous element.
+			node_pointer child;
+
+			do
+			{
+				child = path[--depth];
+			} while (depth != 0 && path[depth - 1]->get_left().get().get() == child);
+		}
+	public:
+		/**
+		* Initializes an end iterator which does not belong to any tree.
+		*/
+		redblack_tree_iterator() WENDA_NOEXCEPT
+			: root(nullptr), depth(0)
 		{}
 
-		explicit redblack_tree_iterator(const_rb_pointer<T> node, bool traverse = false)
-			: current(node), goRight(false)
+		/**
+		* Initializes the end iterator of the tree with the given root.
+		* The path to an element may then be built with push().
+		* @param root The root of the tree, which may be null.
+		* @param traverse If true, the iterator is positioned on the smallest element of the tree instead.
+		*/
+		explicit redblack_tree_iterator(const_rb_pointer<T, Traits> root, bool traverse = false) WENDA_NOEXCEPT
+			: root(root.get()), depth(0)
 		{
 			if (traverse)
 			{
-				next();
+				push_leftmost(this->root);
 			}
 		}
 
+		redblack_tree_iterator(redblack_tree_iterator const& other) WENDA_NOEXCEPT
+			: root(other.root), depth(other.depth)
+		{
+			std::copy(other.path, other.path + depth, path);
+		}
+
+		redblack_tree_iterator& operator=(redblack_tree_iterator const& other) WENDA_NOEXCEPT
+		{
+			root = other.root;
+			depth = other.depth;
+			std::copy(other.path, other.path + depth, path);
+			return *this;
+		}
+
+		/**
+		* Appends the given node to the path of the iterator, which then points to it.
+		* The node must be a child of the current node, or the root if the iterator is an end iterator.
+		*/
+		void push(node_pointer node) WENDA_NOEXCEPT
+		{
+			path[depth++] = node;
+		}
+
+		/**
+		* Returns the number of nodes in the path of the iterator.
+		*/
+		std::size_t path_length() const WENDA_NOEXCEPT
+		{
+			return depth;
+		}
+
+		/**
+		* Shortens the path of the iterator to its first @p length nodes, so that it points to the last of them.
+		*/
+		void truncate(std::size_t length) WENDA_NOEXCEPT
+		{
+			depth = length;
+		}
+
 		T const& operator*() const WENDA_NOEXCEPT
 		{
-			return current->get_data();
+			return path[depth - 1]->get_data();
 		}
 
 		T const* operator->() const WENDA_NOEXCEPT
 		{
-			return std::addressof(current->get_data());
+			return std::addressof(path[depth - 1]->get_data());
 		}
 
-		bool operator==(redblack_tree_iterator const& other) WENDA_NOEXCEPT
+		bool operator==(redblack_tree_iterator const& other) const WENDA_NOEXCEPT
 		{
-			return current == other.current;
+			return current() == other.current();
 		}
 
-		bool operator!=(redblack_tree_iterator const& other) WENDA_NOEXCEPT
+		bool operator!=(redblack_tree_iterator const& other) const WENDA_NOEXCEPT
 		{
-			return current != other.current;
+			return current() != other.current();
 		}
 
-		redblack_tree_iterator& operator++()
+		redblack_tree_iterator& operator++() WENDA_NOEXCEPT
 		{
 			next();
 			return *this;
 		}
 
-		redblack_tree_iterator operator++(int)
+		redblack_tree_iterator operator++(int) WENDA_NOEXCEPT
 		{
 			redblack_tree_iterator _this = *this;
 			next();
 			return _this;
 		}
+
+		redblack_tree_iterator& operator--() WENDA_NOEXCEPT
+		{
+			previous();
+			return *this;
+		}
+
+		redblack_tree_iterator operator--(int) WENDA_NOEXCEPT
+		{
+			redblack_tree_iterator _this = *this;
+			previous();
+			return _this;
+		}
 	};
+
+	/**
+	* Returns an iterator to the element of the given tree that is equivalent to @p value, or the end iterator.
+	* @param root The root of the tree.
+	* @param value The value to find.
+	* @param compare The comparison function of the tree.
+	*/
+	template<typename T, typename Traits, typename U, typename Compare>
+	redblack_tree_iterator<T, Traits> find_iterator(const_rb_pointer<T, Traits> root, U const& value, Compare const& compare) WENDA_NOEXCEPT
+	{
+		redblack_tree_iterator<T, Traits> result(root);
+		auto node = root.get();
+
+		while (node)
+		{
+			result.push(node);
+
+			auto order = three_way_order(compare, value, node->get_data());
+
+			if (order < 0)
+			{
+				node = node->get_left().get().get();
+			}
+			else if (order > 0)
+			{
+				node = node->get_right().get().get();
+			}
+			else
+			{
+				return result;
+			}
+		}
+
+		return redblack_tree_iterator<T, Traits>(root);
+	}
+
+	/**
+	* Returns the node of the given tree holding an element equivalent to @p value, or null.
+	* This is the lookup used by find(), without building the path of an iterator.
+	*/
+	template<typename T, typename Traits, typename U, typename Compare>
+	redblack_node<T, Traits> const* find_node(const_rb_pointer<T, Traits> root, U const& value, Compare const& compare) WENDA_NOEXCEPT
+	{
+		auto node = root.get();
+
+		while (node)
+		{
+			auto order = three_way_order(compare, value, node->get_data());
+
+			if (order < 0)
+			{
+				node = node->get_left().get().get();
+			}
+			else if (order > 0)
+			{
+				node = node->get_right().get().get();
+			}
+			else
+			{
+				return node;
+			}
+		}
+
+		return nullptr;
+	}
 }
 
 WENDA_FDS_NAMESPACE_END
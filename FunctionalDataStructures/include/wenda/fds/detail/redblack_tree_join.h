@@ -0,0 +1,401 @@
+#ifndef WENDA_FDS_DETAIL_REDBLACK_TREE_JOIN_H_INCLUDED
+#define WENDA_FDS_DETAIL_REDBLACK_TREE_JOIN_H_INCLUDED
+
+/**
+* @file redblack_tree_join.h
+* This file implements the join and split primitives of red-black trees, and the set operations built on them,
+* following Blelloch, Ferizovic and Sun, "Just Join for Parallel Ordered Sets".
+* The black height of every subtree is carried along with it, so that joining two trees costs
+* O(|h(left) - h(right)| + 1), and the set operations run in O(m log(n/m + 1)) for trees of sizes m <= n.
+* Subtrees that are not affected by an operation are shared with the result, not copied.
+*/
+
+#include "../FDS_common.h"
+#include "../task_pool.h"
+#include "../three_way_compare.h"
+#include "redblack_tree_data.h"
+#include "redblack_tree_balance.h"
+
+#include <cstddef>
+#include <tuple>
+#include <utility>
+
+WENDA_FDS_NAMESPACE_BEGIN
+
+namespace detail
+{
+	/**
+	* Subtrees with at least this black height are processed in parallel by the set operations.
+	* Such a subtree holds at least 2^8 - 1 elements.
+	*/
+	const std::size_t parallel_black_height = 8;
+
+	/**
+	* This struct holds a subtree together with its black height.
+	* The black height is the number of black nodes on any path from the root of the subtree to a leaf,
+	* counting the root itself if it is black. The empty subtree has a black height of 0.
+	*/
+	template<typename T, typename Traits>
+	struct redblack_subtree
+	{
+		const_intrusive_rb_ptr<T, Traits> root;
+		std::size_t black_height;
+	};
+
+	/**
+	* Returns the empty subtree.
+	*/
+	template<typename T, typename Traits>
+	redblack_subtree<T, Traits> make_empty_subtree() WENDA_NOEXCEPT
+	{
+		return redblack_subtree<T, Traits>{ make_null_redblack_node<T, Traits>(), 0 };
+	}
+
+	/**
+	* Returns the given tree together with its black height, which is computed by walking down its left spine.
+	*/
+	template<typename T, typename Traits>
+	redblack_subtree<T, Traits> make_subtree(intrusive_packed_ptr<const redblack_node<T, Traits>, node_deleter<redblack_node<T, Traits>>> const& root) WENDA_NOEXCEPT
+	{
+		std::size_t height = 0;
+
+		for (auto node = root.get(); !is_leaf(node); node = node->get_left().get())
+		{
+			if (colour(node) == NodeColour::Black)
+			{
+				height++;
+			}
+		}
+
+		return redblack_subtree<T, Traits>{ root, height };
+	}
+
+	/**
+	* Returns the left child of the root of the given non-empty subtree.
+	*/
+	template<typename T, typename Traits>
+	redblack_subtree<T, Traits> left_subtree(redblack_subtree<T, Traits> const& tree) WENDA_NOEXCEPT
+	{
+		return redblack_subtree<T, Traits>{ tree.root->get_left(),
+			tree.black_height - (colour(tree.root) == NodeColour::Black ? 1 : 0) };
+	}
+
+	/**
+	* Returns the right child of the root of the given non-empty subtree.
+	*/
+	template<typename T, typename Traits>
+	redblack_subtree<T, Traits> right_subtree(redblack_subtree<T, Traits> const& tree) WENDA_NOEXCEPT
+	{
+		return redblack_subtree<T, Traits>{ tree.root->get_right(),
+			tree.black_height - (colour(tree.root) == NodeColour::Black ? 1 : 0) };
+	}
+
+	/**
+	* Colours the root of the given subtree black, which is free as the colour is held by the pointer.
+	*/
+	template<typename T, typename Traits>
+	void make_root_black(redblack_subtree<T, Traits>& tree) WENDA_NOEXCEPT
+	{
+		if (!is_leaf(tree.root) && colour(tree.root) == NodeColour::Red)
+		{
+			set_colour(tree.root, NodeColour::Black);
+			tree.black_height++;
+		}
+	}
+
+	/**
+	* Returns a value indicating whether both subtrees are the same, in which case the set operations need not look into them.
+	*/
+	template<typename T, typename Traits>
+	bool is_same_subtree(redblack_subtree<T, Traits> const& left, redblack_subtree<T, Traits> const& right) WENDA_NOEXCEPT
+	{
+		return left.root.get().get() == right.root.get().get();
+	}
+
+	/**
+	* Joins @p right to the right spine of @p left, which is at least as high.
+	* @param left The left tree.
+	* @param height The black height of the left tree.
+	* @param value The value to place between the trees.
+	* @param right The right tree. Its root must be black.
+	* @param right_height The black height of the right tree.
+	* @param allocator The allocator with which to allocate the new nodes.
+	* @returns A tree of black height @p height, whose root may be red with a red right child.
+	*/
+	template<typename T, typename Traits, typename U>
+	const_intrusive_rb_ptr<T, Traits> join_right(const_intrusive_rb_ptr<T, Traits> const& left, std::size_t height, U&& value,
+		const_intrusive_rb_ptr<T, Traits> const& right, std::size_t right_height, typename Traits::allocator_type const& allocator)
+	{
+		if (height == right_height && colour(left) != NodeColour::Red)
+		{
+			return make_redblack_node<T, Traits>(std::forward<U>(value), NodeColour::Red, left, right, allocator);
+		}
+
+		auto node_colour = colour(left);
+		auto child_height = height - (node_colour == NodeColour::Black ? 1 : 0);
+		auto joined = join_right<T, Traits>(left->get_right(), child_height, std::forward<U>(value), right, right_height, allocator);
+		const_rb_pointer<T, Traits> unused;
+
+		return balance<T, Traits>(node_colour, left->get_data(), left->get_left(), std::move(joined), unused, allocator);
+	}
+
+	/**
+	* Joins @p left to the left spine of @p right, which is at least as high.
+	* This is the mirror image of join_right().
+	*/
+	template<typename T, typename Traits, typename U>
+	const_intrusive_rb_ptr<T, Traits> join_left(const_intrusive_rb_ptr<T, Traits> const& left, std::size_t left_height, U&& value,
+		const_intrusive_rb_ptr<T, Traits> const& right, std::size_t height, typename Traits::allocator_type const& allocator)
+	{
+		if (height == left_height && colour(right) != NodeColour::Red)
+		{
+			return make_redblack_node<T, Traits>(std::forward<U>(value), NodeColour::Red, left, right, allocator);
+		}
+
+		auto node_colour = colour(right);
+		auto child_height = height - (node_colour == NodeColour::Black ? 1 : 0);
+		auto joined = join_left<T, Traits>(left, left_height, std::forward<U>(value), right->get_left(), child_height, allocator);
+		const_rb_pointer<T, Traits> unused;
+
+		return balance<T, Traits>(node_colour, right->get_data(), std::move(joined), right->get_right(), unused, allocator);
+	}
+
+	/**
+	* Returns a tree holding the elements of @p left, then @p value, then the elements of @p right.
+	* Every element of @p left must be less than @p value, which must be less than every element of @p right.
+	* @param left The tree holding the smaller elements.
+	* @param value The value to place between the trees.
+	* @param right The tree holding the greater elements.
+	* @param allocator The allocator with which to allocate the new nodes.
+	*/
+	template<typename T, typename Traits, typename U>
+	redblack_subtree<T, Traits> join(redblack_subtree<T, Traits> left, U&& value, redblack_subtree<T, Traits> right,
+		typename Traits::allocator_type const& allocator)
+	{
+		make_root_black(left);
+		make_root_black(right);
+
+		redblack_subtree<T, Traits> result;
+
+		if (left.black_height > right.black_height)
+		{
+			result.root = join_right<T, Traits>(left.root, left.black_height, std::forward<U>(value), right.root, right.black_height, allocator);
+			result.black_height = left.black_height;
+
+			if (colour(result.root) == NodeColour::Red && !is_leaf(result.root->get_right()) && colour(result.root->get_right()) == NodeColour::Red)
+			{
+				make_root_black(result);
+			}
+		}
+		else if (left.black_height < right.black_height)
+		{
+			result.root = join_left<T, Traits>(left.root, left.black_height, std::forward<U>(value), right.root, right.black_height, allocator);
+			result.black_height = right.black_height;
+
+			if (colour(result.root) == NodeColour::Red && !is_leaf(result.root->get_left()) && colour(result.root->get_left()) == NodeColour::Red)
+			{
+				make_root_black(result);
+			}
+		}
+		else
+		{
+			result.root = make_redblack_node<T, Traits>(std::forward<U>(value), NodeColour::Red, std::move(left.root), std::move(right.root), allocator);
+			result.black_height = left.black_height;
+		}
+
+		return result;
+	}
+
+	/**
+	* Splits the given tree around the value equivalent to @p value.
+	* @returns A tuple holding the tree of the elements less than @p value, a pointer to the element
+	* equivalent to @p value or null if there is none, and the tree of the elements greater than @p value.
+	*/
+	template<typename T, typename Traits, typename U, typename Compare>
+	std::tuple<redblack_subtree<T, Traits>, const_rb_pointer<T, Traits>, redblack_subtree<T, Traits>>
+		split(redblack_subtree<T, Traits> const& tree, U const& value, Compare const& compare,
+		typename Traits::allocator_type const& allocator)
+	{
+		typedef std::tuple<redblack_subtree<T, Traits>, const_rb_pointer<T, Traits>, redblack_subtree<T, Traits>> return_t;
+
+		if (is_leaf(tree.root))
+		{
+			return return_t(make_empty_subtree<T, Traits>(), make_null_redblack_node<T, Traits>(), make_empty_subtree<T, Traits>());
+		}
+
+		auto const& data = tree.root->get_data();
+		auto order = three_way_order(compare, value, data);
+
+		if (order < 0)
+		{
+			auto result = split(left_subtree(tree), value, compare, allocator);
+			std::get<2>(result) = join<T, Traits>(std::move(std::get<2>(result)), data, right_subtree(tree), allocator);
+			return result;
+		}
+		else if (order > 0)
+		{
+			auto result = split(right_subtree(tree), value, compare, allocator);
+			std::get<0>(result) = join<T, Traits>(left_subtree(tree), data, std::move(std::get<0>(result)), allocator);
+			return result;
+		}
+		else
+		{
+			return return_t(left_subtree(tree), tree.root.get(), right_subtree(tree));
+		}
+	}
+
+	/**
+	* Removes the greatest element of the given non-empty tree.
+	* @returns A tuple holding the remaining tree and a pointer to the removed element, which remains
+	* valid as long as @p tree is.
+	*/
+	template<typename T, typename Traits>
+	std::tuple<redblack_subtree<T, Traits>, const_rb_pointer<T, Traits>>
+		split_last(redblack_subtree<T, Traits> const& tree, typename Traits::allocator_type const& allocator)
+	{
+		if (is_leaf(tree.root->get_right()))
+		{
+			return std::make_tuple(left_subtree(tree), tree.root.get());
+		}
+
+		auto result = split_last(right_subtree(tree), allocator);
+		std::get<0>(result) = join<T, Traits>(left_subtree(tree), tree.root->get_data(), std::move(std::get<0>(result)), allocator);
+		return result;
+	}
+
+	/**
+	* Returns a tree holding the elements of @p left followed by the elements of @p right.
+	* Every element of @p left must be less than every element of @p right.
+	*/
+	template<typename T, typename Traits>
+	redblack_subtree<T, Traits> join(redblack_subtree<T, Traits> const& left, redblack_subtree<T, Traits> const& right,
+		typename Traits::allocator_type const& allocator)
+	{
+		if (is_leaf(left.root))
+		{
+			return right;
+		}
+
+		if (is_leaf(right.root))
+		{
+			return left;
+		}
+
+		redblack_subtree<T, Traits> rest;
+		const_rb_pointer<T, Traits> last;
+
+		std::tie(rest, last) = split_last(left, allocator);
+		return join<T, Traits>(std::move(rest), last->get_data(), right, allocator);
+	}
+
+	/**
+	* Runs the two given functions on the given pool if the subtree is high enough, and sequentially otherwise.
+	*/
+	template<typename First, typename Second>
+	void fork_join(task_pool* pool, std::size_t black_height, First&& first, Second&& second)
+	{
+		if (pool && black_height >= parallel_black_height)
+		{
+			pool->invoke(std::forward<First>(first), std::forward<Second>(second));
+		}
+		else
+		{
+			first();
+			second();
+		}
+	}
+
+	/**
+	* Returns the union of the given trees. Of two equivalent elements, the one of @p left is kept.
+	* @param pool The pool on which to process large subtrees in parallel, or null.
+	*/
+	template<typename T, typename Traits, typename Compare>
+	redblack_subtree<T, Traits> set_union(redblack_subtree<T, Traits> const& left, redblack_subtree<T, Traits> const& right,
+		Compare const& compare, typename Traits::allocator_type const& allocator, task_pool* pool)
+	{
+		if (is_leaf(left.root) || is_same_subtree(left, right))
+		{
+			return right;
+		}
+
+		if (is_leaf(right.root))
+		{
+			return left;
+		}
+
+		redblack_subtree<T, Traits> rightLess, rightGreater, less, greater;
+		std::tie(rightLess, std::ignore, rightGreater) = split(right, left.root->get_data(), compare, allocator);
+
+		fork_join(pool, left.black_height,
+			[&]() { less = set_union(left_subtree(left), rightLess, compare, allocator, pool); },
+			[&]() { greater = set_union(right_subtree(left), rightGreater, compare, allocator, pool); });
+
+		return join<T, Traits>(std::move(less), left.root->get_data(), std::move(greater), allocator);
+	}
+
+	/**
+	* Returns the intersection of the given trees. The elements of @p left are kept.
+	* @param pool The pool on which to process large subtrees in parallel, or null.
+	*/
+	template<typename T, typename Traits, typename Compare>
+	redblack_subtree<T, Traits> set_intersection(redblack_subtree<T, Traits> const& left, redblack_subtree<T, Traits> const& right,
+		Compare const& compare, typename Traits::allocator_type const& allocator, task_pool* pool)
+	{
+		if (is_leaf(left.root) || is_leaf(right.root))
+		{
+			return make_empty_subtree<T, Traits>();
+		}
+
+		if (is_same_subtree(left, right))
+		{
+			return left;
+		}
+
+		redblack_subtree<T, Traits> rightLess, rightGreater, less, greater;
+		const_rb_pointer<T, Traits> found;
+		std::tie(rightLess, found, rightGreater) = split(right, left.root->get_data(), compare, allocator);
+
+		fork_join(pool, left.black_height,
+			[&]() { less = set_intersection(left_subtree(left), rightLess, compare, allocator, pool); },
+			[&]() { greater = set_intersection(right_subtree(left), rightGreater, compare, allocator, pool); });
+
+		if (found)
+		{
+			return join<T, Traits>(std::move(less), left.root->get_data(), std::move(greater), allocator);
+		}
+
+		return join<T, Traits>(less, greater, allocator);
+	}
+
+	/**
+	* Returns the elements of @p left that have no equivalent in @p right.
+	* @param pool The pool on which to process large subtrees in parallel, or null.
+	*/
+	template<typename T, typename Traits, typename Compare>
+	redblack_subtree<T, Traits> set_difference(redblack_subtree<T, Traits> const& left, redblack_subtree<T, Traits> const& right,
+		Compare const& compare, typename Traits::allocator_type const& allocator, task_pool* pool)
+	{
+		if (is_leaf(left.root) || is_same_subtree(left, right))
+		{
+			return make_empty_subtree<T, Traits>();
+		}
+
+		if (is_leaf(right.root))
+		{
+			return left;
+		}
+
+		redblack_subtree<T, Traits> leftLess, leftGreater, less, greater;
+		std::tie(leftLess, std::ignore, leftGreater) = split(left, right.root->get_data(), compare, allocator);
+
+		fork_join(pool, right.black_height,
+			[&]() { less = set_difference(leftLess, left_subtree(right), compare, allocator, pool); },
+			[&]() { greater = set_difference(leftGreater, right_subtree(right), compare, allocator, pool); });
+
+		return join<T, Traits>(less, greater, allocator);
+	}
+}
+
+WENDA_FDS_NAMESPACE_END
+
+#endif // WENDA_FDS_DETAIL_REDBLACK_TREE_JOIN_H_INCLUDED
\ No newline at end of file
@@ -0,0 +1,162 @@
+#ifndef WENDA_FDS_DETAIL_REDBLACK_TREE_ORDER_H_INCLUDED
+#define WENDA_FDS_DETAIL_REDBLACK_TREE_ORDER_H_INCLUDED
+
+/**
+* @file redblack_tree_order.h
+* This file implements the order statistics of red-black trees, which use the subtree sizes
+* stored in the nodes to locate elements by position in O(log n), and the positioning of iterators
+* at the bounds of ranges of values.
+*/
+
+#include "../FDS_common.h"
+#include "redblack_tree_data.h"
+#include "redblack_tree_iterator.h"
+
+#include <cstddef>
+
+WENDA_FDS_NAMESPACE_BEGIN
+
+namespace detail
+{
+	/**
+	* Returns the number of elements of the given subtree that are less than @p value.
+	* @param node The root of the subtree.
+	* @param value The value to compare the elements to.
+	* @param compare The comparison function of the tree.
+	*/
+	template<typename T, typename Traits, typename U, typename Compare>
+	std::size_t rank(const_rb_pointer<T, Traits> node, U const& value, Compare const& compare)
+	{
+		std::size_t result = 0;
+
+		while (node)
+		{
+			if (compare(node->get_data(), value))
+			{
+				result += subtree_size(node->get_left()) + 1;
+				node = node->get_right().get();
+			}
+			else
+			{
+				node = node->get_left().get();
+			}
+		}
+
+		return result;
+	}
+
+	/**
+	* Returns the node holding the element at position @p index in the given subtree.
+	* @param node The root of the subtree.
+	* @param index The position of the element, which must be less than the size of the subtree.
+	*/
+	template<typename T, typename Traits>
+	const_rb_pointer<T, Traits> select(const_rb_pointer<T, Traits> node, std::size_t index) WENDA_NOEXCEPT
+	{
+		for (;;)
+		{
+			auto leftSize = subtree_size(node->get_left());
+
+			if (index < leftSize)
+			{
+				node = node->get_left().get();
+			}
+			else if (index > leftSize)
+			{
+				index -= leftSize + 1;
+				node = node->get_right().get();
+			}
+			else
+			{
+				return node;
+			}
+		}
+	}
+
+	/**
+	* Returns an iterator to the element at position @p index in the given tree.
+	* @param root The root of the tree.
+	* @param index The position of the element, which must be less than the size of the tree.
+	*/
+	template<typename T, typename Traits>
+	redblack_tree_iterator<T, Traits> select_iterator(const_rb_pointer<T, Traits> root, std::size_t index) WENDA_NOEXCEPT
+	{
+		redblack_tree_iterator<T, Traits> result(root);
+		auto node = root;
+
+		for (;;)
+		{
+			result.push(node.get());
+			auto leftSize = subtree_size(node->get_left());
+
+			if (index < leftSize)
+			{
+				node = node->get_left().get();
+			}
+			else if (index > leftSize)
+			{
+				index -= leftSize + 1;
+				node = node->get_right().get();
+			}
+			else
+			{
+				return result;
+			}
+		}
+	}
+
+	/**
+	* Returns an iterator to the first element of the given tree for which @p after returns true, in O(log n).
+	* The elements must be partitioned with respect to @p after: it must return false for a prefix of them, and true for the rest.
+	* The element found is the last node of the search path for which @p after returns true.
+	* @param root The root of the tree.
+	* @param after The predicate indicating whether an element is part of the suffix.
+	* @returns An iterator to the first element of the suffix, or the end iterator if it is empty.
+	*/
+	template<typename T, typename Traits, typename Predicate>
+	redblack_tree_iterator<T, Traits> partition_point(const_rb_pointer<T, Traits> root, Predicate const& after)
+	{
+		redblack_tree_iterator<T, Traits> result(root);
+		std::size_t length = 0;
+
+		for (auto node = root; node;)
+		{
+			result.push(node.get());
+
+			if (after(node->get_data()))
+			{
+				length = result.path_length();
+				node = node->get_left().get();
+			}
+			else
+			{
+				node = node->get_right().get();
+			}
+		}
+
+		result.truncate(length);
+		return result;
+	}
+
+	/**
+	* Returns an iterator to the first element of the given subtree that is not less than @p value.
+	*/
+	template<typename T, typename Traits, typename U, typename Compare>
+	redblack_tree_iterator<T, Traits> lower_bound(const_rb_pointer<T, Traits> node, U const& value, Compare const& compare)
+	{
+		return partition_point<T, Traits>(node, [&](T const& element) { return !compare(element, value); });
+	}
+
+	/**
+	* Returns an iterator to the first element of the given subtree that is greater than @p value.
+	*/
+	template<typename T, typename Traits, typename U, typename Compare>
+	redblack_tree_iterator<T, Traits> upper_bound(const_rb_pointer<T, Traits> node, U const& value, Compare const& compare)
+	{
+		return partition_point<T, Traits>(node, [&](T const& element) { return compare(value, element); });
+	}
+}
+
+WENDA_FDS_NAMESPACE_END
+
+#endif // WENDA_FDS_DETAIL_REDBLACK_TREE_ORDER_H_INCLUDED
\ No newline at end of file
@@ -0,0 +1,167 @@
+#ifndef WENDA_FDS_DETAIL_REDBLACK_TREE_PARALLEL_H_INCLUDED
+#define WENDA_FDS_DETAIL_REDBLACK_TREE_PARALLEL_H_INCLUDED
+
+/**
+* @file redblack_tree_parallel.h
+* This file implements the bulk operations over whole red-black trees, which process
+* the two children of large subtrees in parallel.
+*/
+
+#include "../FDS_common.h"
+#include "../task_pool.h"
+#include "redblack_tree_data.h"
+#include "redblack_tree_join.h"
+#include "redblack_tree_reduce.h"
+
+#include <utility>
+
+WENDA_FDS_NAMESPACE_BEGIN
+
+namespace detail
+{
+	/**
+	* Reduces the given subtree in order, processing large subtrees in parallel.
+	* Each subtree is folded with @p function starting from @p identity, and the partial
+	* results of adjacent subtrees are merged with @p combine.
+	* @param tree The subtree to reduce.
+	* @param function The function folding an element into a partial result.
+	* @param identity The neutral element of @p combine.
+	* @param combine The associative function merging two partial results.
+	* @param pool The pool on which to process large subtrees in parallel, or null.
+	*/
+	template<typename T, typename Traits, typename Function, typename Seed, typename Combine>
+	Seed parallel_reduce(redblack_subtree<T, Traits> const& tree, Function& function, Seed const& identity, Combine& combine, task_pool* pool)
+	{
+		if (is_leaf(tree.root))
+		{
+			return identity;
+		}
+
+		if (!pool || tree.black_height < parallel_black_height)
+		{
+			return reduce(*tree.root, function, identity);
+		}
+
+		Seed left(identity), right(identity);
+
+		pool->invoke(
+			[&]() { left = parallel_reduce(left_subtree(tree), function, identity, combine, pool); },
+			[&]() { right = parallel_reduce(right_subtree(tree), function, identity, combine, pool); });
+
+		return combine(function(std::move(left), tree.root->get_data()), std::move(right));
+	}
+
+	/**
+	* Returns the black height of the children of the given node.
+	* @param node The node, which must not be a leaf.
+	* @param black_height The black height of the subtree rooted at @p node.
+	*/
+	template<typename T, typename Traits>
+	std::size_t child_black_height(const_rb_pointer<T, Traits> node, std::size_t black_height) WENDA_NOEXCEPT
+	{
+		return black_height - (colour(node) == NodeColour::Black ? 1 : 0);
+	}
+
+	/**
+	* Returns a tree of the same shape as the given subtree, holding the images of its elements by @p function.
+	* The subtree is walked through plain pointers, so that reading it does not update any reference count.
+	* @param node The root of the subtree to map.
+	* @param black_height The black height of the subtree.
+	* @param function The function to apply to the elements. It must preserve their order.
+	* @param allocator The allocator with which to allocate the nodes of the new tree.
+	* @param pool The pool on which to process large subtrees in parallel, or null.
+	* @tparam R The type of the elements of the new tree.
+	* @tparam RTraits The node traits of the new tree.
+	*/
+	template<typename R, typename RTraits, typename T, typename Traits, typename Function>
+	const_intrusive_rb_ptr<R, RTraits> map_values(const_rb_pointer<T, Traits> node, std::size_t black_height, Function& function,
+		typename RTraits::allocator_type const& allocator, task_pool* pool)
+	{
+		if (is_leaf(node))
+		{
+			return make_null_redblack_node<R, RTraits>();
+		}
+
+		auto height = child_black_height<T, Traits>(node, black_height);
+		const_intrusive_rb_ptr<R, RTraits> left, right;
+
+		fork_join(pool, black_height,
+			[&]() { left = map_values<R, RTraits, T, Traits>(node->get_left().get(), height, function, allocator, pool); },
+			[&]() { right = map_values<R, RTraits, T, Traits>(node->get_right().get(), height, function, allocator, pool); });
+
+		return make_redblack_node<R, RTraits>(function(node->get_data()), colour(node), std::move(left), std::move(right), allocator);
+	}
+
+	/**
+	* This struct holds the result of filtering a subtree.
+	* If no element was removed, the result is the original subtree, which is not referenced
+	* until it is needed, so that unchanged subtrees are filtered without updating any reference count.
+	*/
+	template<typename T, typename Traits>
+	struct filter_result
+	{
+		redblack_subtree<T, Traits> tree; ///< The filtered subtree, if it differs from the original.
+		bool unchanged; ///< Whether every element of the subtree was kept.
+	};
+
+	/**
+	* Returns the filtered subtree held by @p result, given the original subtree.
+	*/
+	template<typename T, typename Traits>
+	redblack_subtree<T, Traits> filtered_subtree(filter_result<T, Traits>&& result, const_rb_pointer<T, Traits> node, std::size_t black_height)
+	{
+		if (result.unchanged)
+		{
+			return redblack_subtree<T, Traits>{ const_intrusive_rb_ptr<T, Traits>(node), black_height };
+		}
+
+		return std::move(result.tree);
+	}
+
+	/**
+	* Filters the elements of the given subtree satisfying @p predicate, as a balanced tree.
+	* Subtrees in which every element satisfies the predicate are shared with the result.
+	* @param node The root of the subtree to filter.
+	* @param black_height The black height of the subtree.
+	* @param predicate The predicate selecting the elements to keep.
+	* @param allocator The allocator with which to allocate the new nodes.
+	* @param pool The pool on which to process large subtrees in parallel, or null.
+	*/
+	template<typename T, typename Traits, typename Predicate>
+	filter_result<T, Traits> filter(const_rb_pointer<T, Traits> node, std::size_t black_height, Predicate& predicate,
+		typename Traits::allocator_type const& allocator, task_pool* pool)
+	{
+		if (is_leaf(node))
+		{
+			return filter_result<T, Traits>{ redblack_subtree<T, Traits>(), true };
+		}
+
+		auto height = child_black_height<T, Traits>(node, black_height);
+		filter_result<T, Traits> left, right;
+
+		fork_join(pool, black_height,
+			[&]() { left = filter<T, Traits>(node->get_left().get(), height, predicate, allocator, pool); },
+			[&]() { right = filter<T, Traits>(node->get_right().get(), height, predicate, allocator, pool); });
+
+		bool keep = predicate(node->get_data());
+
+		if (keep && left.unchanged && right.unchanged)
+		{
+			return filter_result<T, Traits>{ redblack_subtree<T, Traits>(), true };
+		}
+
+		auto less = filtered_subtree<T, Traits>(std::move(left), node->get_left().get(), height);
+		auto greater = filtered_subtree<T, Traits>(std::move(right), node->get_right().get(), height);
+
+		if (keep)
+		{
+			return filter_result<T, Traits>{ join<T, Traits>(std::move(less), node->get_data(), std::move(greater), allocator), false };
+		}
+
+		return filter_result<T, Traits>{ join<T, Traits>(less, greater, allocator), false };
+	}
+}
+
+WENDA_FDS_NAMESPACE_END
+
+#endif // WENDA_FDS_DETAIL_REDBLACK_TREE_PARALLEL_H_INCLUDED
\ No newline at end of file
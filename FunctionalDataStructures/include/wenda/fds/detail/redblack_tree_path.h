@@ -0,0 +1,247 @@
+#ifndef WENDA_FDS_DETAIL_REDBLACK_TREE_PATH_H_INCLUDED
+#define WENDA_FDS_DETAIL_REDBLACK_TREE_PATH_H_INCLUDED
+
+/**
+* @file redblack_tree_path.h
+* This file implements the search paths recorded by the persistent updates of red-black trees.
+* An update first records the path from the root to the position of a key in a bounded buffer,
+* and then rebuilds the path once from the bottom up, sharing every subtree off the path.
+*/
+
+#include "../FDS_common.h"
+#include "../three_way_compare.h"
+#include "redblack_tree_data.h"
+#include "redblack_tree_balance.h"
+#include "redblack_tree_iterator.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <utility>
+
+WENDA_FDS_NAMESPACE_BEGIN
+
+namespace detail
+{
+	/**
+	* This struct holds the path from the root of a tree to the position of a key.
+	*/
+	template<typename T, typename Traits>
+	struct search_path
+	{
+		const_rb_pointer<T, Traits> nodes[redblack_max_height]; ///< The nodes of the path, starting from the root.
+		bool went_left[redblack_max_height]; ///< Whether the path continues through the left child of each node.
+		std::size_t depth; ///< The number of nodes on the path.
+		bool found; ///< Whether the last node of the path holds an element equivalent to the key.
+
+		/**
+		* Returns the last node of the path.
+		*/
+		const_rb_pointer<T, Traits> back() const WENDA_NOEXCEPT
+		{
+			assert(depth > 0);
+			return nodes[depth - 1];
+		}
+	};
+
+	/**
+	* Records the path from @p root to the element equivalent to @p key, or to the leaf where it would be inserted.
+	* The descent makes a single comparison per level, see search_order().
+	* @param path Set to the path. If an equivalent element is found, it is the last node of the path.
+	*/
+	template<typename T, typename Traits, typename K, typename Compare>
+	void find_path(search_path<T, Traits>& path, const_rb_pointer<T, Traits> root, K const& key, Compare const& compare)
+	{
+		std::size_t candidate = redblack_max_height;
+		path.depth = 0;
+		path.found = false;
+
+		for (auto node = root; node; path.depth++)
+		{
+			assert(path.depth < redblack_max_height);
+			path.nodes[path.depth] = node;
+
+			// the candidate is the last node not greater than the key, which is the only one that may be equivalent to it.
+			auto order = search_order(compare, key, node->get_data());
+
+			if (order == 0)
+			{
+				path.depth++;
+				path.found = true;
+				return;
+			}
+
+			path.went_left[path.depth] = order < 0;
+
+			if (order < 0)
+			{
+				node = node->get_left().get();
+			}
+			else
+			{
+				candidate = path.depth;
+				node = node->get_right().get();
+			}
+		}
+
+		if (candidate != redblack_max_height && candidate_equivalent(compare, path.nodes[candidate]->get_data(), key))
+		{
+			path.depth = candidate + 1;
+			path.found = true;
+		}
+	}
+
+	/**
+	* Updates the path to the inserted node once balance() has rebuilt the subtree above it.
+	* balance() only rebuilds the top two levels of a subtree, so that the path continues from one of the nodes
+	* of the three top levels of the new subtree, which is either the inserted node, or already on the path.
+	* @param reversed The path from the inserted node to the root of the previous subtree, from the bottom up.
+	* It is extended to the root of the new subtree.
+	* @param root The root of the new subtree.
+	* @param inserted The inserted node, which may have been rebuilt by balance().
+	*/
+	template<typename T, typename Traits>
+	void retrace_inserted(search_path<T, Traits>& reversed, const_rb_pointer<T, Traits> root, const_rb_pointer<T, Traits> inserted) WENDA_NOEXCEPT
+	{
+		// the top levels of the new subtree, in breadth-first order, so that the parent of levels[i] is levels[(i - 1) / 2].
+		const_rb_pointer<T, Traits> levels[7];
+		levels[0] = root;
+
+		for (std::size_t i = 0; i < 7; i++)
+		{
+			if (i > 0)
+			{
+				auto parent = levels[(i - 1) / 2];
+				levels[i] = !parent ? const_rb_pointer<T, Traits>() : i % 2 == 1 ? parent->get_left().get() : parent->get_right().get();
+			}
+
+			auto node = levels[i];
+
+			if (!node)
+			{
+				continue;
+			}
+
+			std::size_t kept = 0;
+
+			if (node.get() == inserted.get())
+			{
+				reversed.nodes[0] = inserted;
+				kept = 1;
+			}
+			else
+			{
+				// the nodes reused below the rebuilt levels are at most two levels below the previous root.
+				for (auto k = reversed.depth; k-- > 0 && k + 3 >= reversed.depth;)
+				{
+					if (reversed.nodes[k].get() == node.get())
+					{
+						kept = k + 1;
+						break;
+					}
+				}
+			}
+
+			if (kept != 0)
+			{
+				reversed.depth = kept;
+
+				for (auto ancestor = i; ancestor != 0;)
+				{
+					ancestor = (ancestor - 1) / 2;
+					reversed.nodes[reversed.depth++] = levels[ancestor];
+				}
+
+				return;
+			}
+		}
+
+		assert(false && "the inserted node must be in the top levels of the rebuilt subtree, or below a node of the path.");
+	}
+
+	/**
+	* Inserts a red leaf holding @p value at the end of the given path, which must not have found an equivalent element,
+	* and rebalances each node of the path on the way back up.
+	* @param inserted Set to the path from the new root to the node holding the inserted value.
+	* @returns The new root, which may be red.
+	*/
+	template<typename T, typename Traits, typename U>
+	const_intrusive_rb_ptr<T, Traits> insert_at(search_path<T, Traits> const& path, U&& value,
+		typename Traits::allocator_type const& allocator, search_path<T, Traits>& inserted)
+	{
+		assert(!path.found);
+
+		const_intrusive_rb_ptr<T, Traits> subtree = make_redblack_node<T, Traits>(std::forward<U>(value),
+			NodeColour::Red, make_null_redblack_node<T, Traits>(), make_null_redblack_node<T, Traits>(), allocator);
+		const_rb_pointer<T, Traits> node = subtree.get();
+
+		// the path is built from the bottom up as the subtree grows, and reversed at the end.
+		inserted.nodes[0] = node;
+		inserted.depth = 1;
+		inserted.found = true;
+
+		for (auto depth = path.depth; depth-- > 0;)
+		{
+			auto parent = path.nodes[depth];
+
+			subtree = path.went_left[depth]
+				? balance<T, Traits>(colour(parent), parent->get_data(), std::move(subtree), parent->get_right(), node, allocator)
+				: balance<T, Traits>(colour(parent), parent->get_data(), parent->get_left(), std::move(subtree), node, allocator);
+
+			retrace_inserted(inserted, subtree.get(), node);
+		}
+
+		std::reverse(inserted.nodes, inserted.nodes + inserted.depth);
+		return subtree;
+	}
+
+	/**
+	* Returns an iterator to the last node of the given path.
+	* @param root The root of the tree, which must be the first node of the path. It may differ from it by its colour.
+	*/
+	template<typename T, typename Traits>
+	redblack_tree_iterator<T, Traits> path_iterator(const_rb_pointer<T, Traits> root, search_path<T, Traits> const& path) WENDA_NOEXCEPT
+	{
+		assert(path.depth > 0 && path.nodes[0].get() == root.get());
+
+		redblack_tree_iterator<T, Traits> result(root);
+
+		for (std::size_t i = 0; i < path.depth; i++)
+		{
+			result.push(path.nodes[i].get());
+		}
+
+		return result;
+	}
+
+	/**
+	* Replaces the element found at the end of the given path by @p value, which must be equivalent to it.
+	* As the order of the elements is unchanged, the nodes of the path are copied with their colours and no rebalancing is needed.
+	* @returns The new root.
+	*/
+	template<typename T, typename Traits, typename U>
+	const_intrusive_rb_ptr<T, Traits> replace_at(search_path<T, Traits> const& path, U&& value,
+		typename Traits::allocator_type const& allocator)
+	{
+		assert(path.found);
+
+		auto node = path.back();
+		const_intrusive_rb_ptr<T, Traits> subtree = make_redblack_node<T, Traits>(std::forward<U>(value),
+			colour(node), node->get_left(), node->get_right(), allocator);
+
+		for (auto depth = path.depth - 1; depth-- > 0;)
+		{
+			auto parent = path.nodes[depth];
+
+			subtree = path.went_left[depth]
+				? make_redblack_node<T, Traits>(parent->get_data(), colour(parent), std::move(subtree), parent->get_right(), allocator)
+				: make_redblack_node<T, Traits>(parent->get_data(), colour(parent), parent->get_left(), std::move(subtree), allocator);
+		}
+
+		return subtree;
+	}
+}
+
+WENDA_FDS_NAMESPACE_END
+
+#endif // WENDA_FDS_DETAIL_REDBLACK_TREE_PATH_H_INCLUDED
\ No newline at end of file
@@ -4,7 +4,7 @@
 /**
 * @file redblack_tree_reduce.h
 * This file implements the basic reduction function
-* for red-black nodes.
+* for red-black nodes, and the aggregation of the values cached by augmented nodes.
 */
 
 #include "../FDS_common.h"
@@ -22,8 +22,8 @@ namespace detail
 	* @param function The aggregation function.
 	* @param seed The initial value to pass to the aggregation function.
 	*/
-	template<typename T, typename Function, typename Seed>
-	typename std::decay<Seed>::type reduce(redblack_node<T> const& node, Function&& function, Seed seed)
+	template<typename T, typename Traits, typename Function, typename Seed>
+	typename std::decay<Seed>::type reduce(redblack_node<T, Traits> const& node, Function&& function, Seed seed)
 	{
 		if (node.get_left())
 		{
@@ -39,6 +39,102 @@ namespace detail
 
 		return seed;
 	}
+
+	/**
+	* Returns the value cached for the given subtree by the augmentation policy of its nodes.
+	* @param node The root of the subtree. Can be null, in which case the identity is returned.
+	*/
+	template<typename T, typename Traits>
+	typename Traits::augmentation_type::value_type aggregate(const_rb_pointer<T, Traits> node)
+	{
+		return node ? node->get_summary() : Traits::augmentation_type::identity();
+	}
+
+	/**
+	* Aggregates the elements of the given subtree that are not less than @p lower, in O(log n).
+	* This combines the cached values of the subtrees to the right of the search path for @p lower.
+	*/
+	template<typename T, typename Traits, typename U, typename Compare>
+	typename Traits::augmentation_type::value_type aggregate_from(const_rb_pointer<T, Traits> node, U const& lower, Compare const& compare)
+	{
+		typedef typename Traits::augmentation_type augmentation;
+		auto result = augmentation::identity();
+
+		while (node)
+		{
+			if (compare(node->get_data(), lower))
+			{
+				node = node->get_right().get();
+			}
+			else
+			{
+				auto right = augmentation::combine(augmentation::lift(node->get_data()), aggregate<T, Traits>(node->get_right().get()));
+				result = augmentation::combine(right, result);
+				node = node->get_left().get();
+			}
+		}
+
+		return result;
+	}
+
+	/**
+	* Aggregates the elements of the given subtree that are less than @p upper, in O(log n).
+	* This combines the cached values of the subtrees to the left of the search path for @p upper.
+	*/
+	template<typename T, typename Traits, typename U, typename Compare>
+	typename Traits::augmentation_type::value_type aggregate_below(const_rb_pointer<T, Traits> node, U const& upper, Compare const& compare)
+	{
+		typedef typename Traits::augmentation_type augmentation;
+		auto result = augmentation::identity();
+
+		while (node)
+		{
+			if (compare(node->get_data(), upper))
+			{
+				auto left = augmentation::combine(aggregate<T, Traits>(node->get_left().get()), augmentation::lift(node->get_data()));
+				result = augmentation::combine(result, left);
+				node = node->get_right().get();
+			}
+			else
+			{
+				node = node->get_left().get();
+			}
+		}
+
+		return result;
+	}
+
+	/**
+	* Aggregates the elements of the given subtree that are not less than @p lower and less than @p upper, in O(log n).
+	* The subtree is descended to the highest node of the range, below which the range is split into
+	* the elements of its left subtree not less than @p lower, and the elements of its right subtree less than @p upper.
+	*/
+	template<typename T, typename Traits, typename U, typename V, typename Compare>
+	typename Traits::augmentation_type::value_type aggregate_range(const_rb_pointer<T, Traits> node, U const& lower, V const& upper,
+		Compare const& compare)
+	{
+		typedef typename Traits::augmentation_type augmentation;
+
+		while (node)
+		{
+			if (compare(node->get_data(), lower))
+			{
+				node = node->get_right().get();
+			}
+			else if (!compare(node->get_data(), upper))
+			{
+				node = node->get_left().get();
+			}
+			else
+			{
+				auto left = aggregate_from<T, Traits>(node->get_left().get(), lower, compare);
+				auto right = aggregate_below<T, Traits>(node->get_right().get(), upper, compare);
+				return augmentation::combine(augmentation::combine(left, augmentation::lift(node->get_data())), right);
+			}
+		}
+
+		return augmentation::identity();
+	}
 }
 
 WENDA_FDS_NAMESPACE_END
@@ -0,0 +1,225 @@
+#ifndef WENDA_FDS_DETAIL_REDBLACK_TREE_TRANSIENT_H_INCLUDED
+#define WENDA_FDS_DETAIL_REDBLACK_TREE_TRANSIENT_H_INCLUDED
+
+/**
+* @file redblack_tree_transient.h
+* This file implements the in-place insertion algorithm used by transient red-black trees.
+* Nodes that are only referenced by the transient are modified in place, while shared nodes
+* are copied along the insertion path, as in the persistent algorithm.
+*/
+
+#include "../FDS_common.h"
+#include "../three_way_compare.h"
+#include "redblack_tree_data.h"
+
+#include <utility>
+
+WENDA_FDS_NAMESPACE_BEGIN
+
+namespace detail
+{
+	/**
+	* Returns a modifiable pointer to the node held by @p slot.
+	* If the node is shared, it is first replaced in @p slot by a copy, which shares its children.
+	* @param slot A pointer owned by the caller, which is not reachable from any other version.
+	* @param allocator The allocator with which to allocate the copy.
+	*/
+	template<typename T, typename Traits>
+	redblack_node<T, Traits>* make_unique_node(const_intrusive_rb_ptr<T, Traits>& slot,
+		typename Traits::allocator_type const& allocator)
+	{
+		auto node = slot.get();
+
+		if (!is_unique_reference(node.get()))
+		{
+			slot = make_redblack_node<T, Traits>(node->get_data(), colour(slot), node->get_left(), node->get_right(), allocator);
+		}
+
+		return const_cast<redblack_node<T, Traits>*>(slot.get().get());
+	}
+
+	/**
+	* Rebalances the subtree held by @p slot in place, after an insertion in one of its children.
+	* This implements the same four cases as balance(), but rearranges the existing nodes instead of
+	* creating new ones, and recomputes the sizes and augmented values of the rearranged nodes. The nodes involved are all on the insertion path, and are thus owned by the transient.
+	* @param slot The pointer to the root of the subtree, which is owned by the transient.
+	* @param allocator The allocator with which to copy the nodes that turn out to be shared.
+	*/
+	template<typename T, typename Traits>
+	void balance_transient(const_intrusive_rb_ptr<T, Traits>& slot, typename Traits::allocator_type const& allocator)
+	{
+		if (colour(slot) != NodeColour::Black)
+		{
+			return;
+		}
+
+		auto node = make_unique_node<T, Traits>(slot, allocator);
+		auto& left = node->get_left();
+		auto& right = node->get_right();
+
+		if (colour(left) == NodeColour::Red && !is_leaf(left))
+		{
+			if (colour(left->get_left()) == NodeColour::Red && !is_leaf(left->get_left()))
+			{
+				// the left child becomes the root, with the node as its right child.
+				auto top = std::move(slot);
+				auto middle = std::move(node->mutable_left());
+				auto middleNode = make_unique_node<T, Traits>(middle, allocator);
+
+				node->mutable_left() = std::move(middleNode->mutable_right());
+				set_colour(top, NodeColour::Black);
+				set_colour(middleNode->mutable_left(), NodeColour::Black);
+				middleNode->mutable_right() = std::move(top);
+				node->update_aggregates();
+				middleNode->update_aggregates();
+				set_colour(middle, NodeColour::Red);
+				slot = std::move(middle);
+				return;
+			}
+
+			if (colour(left->get_right()) == NodeColour::Red && !is_leaf(left->get_right()))
+			{
+				// the right child of the left child becomes the root.
+				auto top = std::move(slot);
+				auto lower = std::move(node->mutable_left());
+				auto lowerNode = make_unique_node<T, Traits>(lower, allocator);
+				auto middle = std::move(lowerNode->mutable_right());
+				auto middleNode = make_unique_node<T, Traits>(middle, allocator);
+
+				lowerNode->mutable_right() = std::move(middleNode->mutable_left());
+				node->mutable_left() = std::move(middleNode->mutable_right());
+				set_colour(lower, NodeColour::Black);
+				set_colour(top, NodeColour::Black);
+				middleNode->mutable_left() = std::move(lower);
+				middleNode->mutable_right() = std::move(top);
+				lowerNode->update_aggregates();
+				node->update_aggregates();
+				middleNode->update_aggregates();
+				set_colour(middle, NodeColour::Red);
+				slot = std::move(middle);
+				return;
+			}
+		}
+
+		if (colour(right) == NodeColour::Red && !is_leaf(right))
+		{
+			if (colour(right->get_left()) == NodeColour::Red && !is_leaf(right->get_left()))
+			{
+				// the left child of the right child becomes the root.
+				auto top = std::move(slot);
+				auto upper = std::move(node->mutable_right());
+				auto upperNode = make_unique_node<T, Traits>(upper, allocator);
+				auto middle = std::move(upperNode->mutable_left());
+				auto middleNode = make_unique_node<T, Traits>(middle, allocator);
+
+				node->mutable_right() = std::move(middleNode->mutable_left());
+				upperNode->mutable_left() = std::move(middleNode->mutable_right());
+				set_colour(top, NodeColour::Black);
+				set_colour(upper, NodeColour::Black);
+				middleNode->mutable_left() = std::move(top);
+				middleNode->mutable_right() = std::move(upper);
+				node->update_aggregates();
+				upperNode->update_aggregates();
+				middleNode->update_aggregates();
+				set_colour(middle, NodeColour::Red);
+				slot = std::move(middle);
+				return;
+			}
+
+			if (colour(right->get_right()) == NodeColour::Red && !is_leaf(right->get_right()))
+			{
+				// the right child becomes the root, with the node as its left child.
+				auto top = std::move(slot);
+				auto middle = std::move(node->mutable_right());
+				auto middleNode = make_unique_node<T, Traits>(middle, allocator);
+
+				node->mutable_right() = std::move(middleNode->mutable_left());
+				set_colour(top, NodeColour::Black);
+				set_colour(middleNode->mutable_right(), NodeColour::Black);
+				middleNode->mutable_left() = std::move(top);
+				node->update_aggregates();
+				middleNode->update_aggregates();
+				set_colour(middle, NodeColour::Red);
+				slot = std::move(middle);
+				return;
+			}
+		}
+	}
+
+	/**
+	* Inserts the given value in the subtree held by @p slot, modifying in place the nodes owned by the transient.
+	* Shared nodes are only copied if the value is actually inserted below them.
+	* @param slot The pointer to the root of the subtree. It must be owned by the transient.
+	* @param value The value to insert.
+	* @param compare The comparison function of the tree.
+	* @param allocator The allocator with which to allocate the new nodes.
+	* @param element Set to the node holding the inserted value, or the equivalent existing value.
+	* @returns True if the value was inserted, false if an equivalent value was already present.
+	*/
+	template<typename T, typename Traits, typename U, typename Compare>
+	bool insert_transient(const_intrusive_rb_ptr<T, Traits>& slot, U&& value, Compare const& compare,
+		typename Traits::allocator_type const& allocator, const_rb_pointer<T, Traits>& element)
+	{
+		if (is_leaf(slot))
+		{
+			slot = make_redblack_node<T, Traits>(std::forward<U>(value), NodeColour::Red,
+				make_null_redblack_node<T, Traits>(), make_null_redblack_node<T, Traits>(), allocator);
+			element = slot.get();
+			return true;
+		}
+
+		auto node = slot.get();
+		bool goLeft;
+
+		auto order = three_way_order(compare, value, node->get_data());
+
+		if (order < 0)
+		{
+			goLeft = true;
+		}
+		else if (order > 0)
+		{
+			goLeft = false;
+		}
+		else
+		{
+			element = node;
+			return false;
+		}
+
+		if (is_unique_reference(node.get()))
+		{
+			auto mutableNode = const_cast<redblack_node<T, Traits>*>(node.get());
+			auto& child = goLeft ? mutableNode->mutable_left() : mutableNode->mutable_right();
+
+			if (!insert_transient<T, Traits>(child, std::forward<U>(value), compare, allocator, element))
+			{
+				return false;
+			}
+
+			mutableNode->update_aggregates();
+		}
+		else
+		{
+			auto child = goLeft ? node->get_left() : node->get_right();
+
+			if (!insert_transient<T, Traits>(child, std::forward<U>(value), compare, allocator, element))
+			{
+				return false;
+			}
+
+			const_intrusive_rb_ptr<T, Traits> copy = goLeft
+				? make_redblack_node<T, Traits>(node->get_data(), colour(slot), std::move(child), node->get_right(), allocator)
+				: make_redblack_node<T, Traits>(node->get_data(), colour(slot), node->get_left(), std::move(child), allocator);
+
+			slot = std::move(copy);
+		}
+
+		balance_transient<T, Traits>(slot, allocator);
+		return true;
+	}
+}
+
+WENDA_FDS_NAMESPACE_END
+
+#endif // WENDA_FDS_DETAIL_REDBLACK_TREE_TRANSIENT_H_INCLUDED
\ No newline at end of file
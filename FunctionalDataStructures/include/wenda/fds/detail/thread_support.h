@@ -0,0 +1,160 @@
+#ifndef WENDA_FDS_DETAIL_THREAD_SUPPORT_H_INCLUDED
+#define WENDA_FDS_DETAIL_THREAD_SUPPORT_H_INCLUDED
+
+#include "../FDS_common.h"
+
+#include <mutex>
+
+/**
+* @file thread_support.h
+* This file implements the thread-exit callbacks and the process-wide objects used by the pools and reclaimers.
+* Visual Studio 2013 neither initializes function-local statics thread-safely, nor supports thread-local
+* objects with constructors or destructors, so these are built from @ref WENDA_THREAD_LOCAL pointers,
+* std::call_once, and fiber-local storage callbacks.
+*/
+
+#if defined(_MSC_VER) && _MSC_VER < 1900
+// declared here rather than by including <windows.h>, whose min and max macros break the other headers.
+extern "C" __declspec(dllimport) unsigned long __stdcall FlsAlloc(void(__stdcall* callback)(void*));
+extern "C" __declspec(dllimport) int __stdcall FlsSetValue(unsigned long index, void* value);
+#endif
+
+WENDA_FDS_NAMESPACE_BEGIN
+
+namespace detail
+{
+	/**
+	* This struct records a function to call when the current thread exits.
+	* Records are stored in @ref WENDA_THREAD_LOCAL variables, and registered through at_thread_exit().
+	*/
+	struct thread_exit_callback
+	{
+		void(*function)(); ///< The function to call.
+		thread_exit_callback* next; ///< The previously registered callback of the thread, or null.
+	};
+
+	/**
+	* Returns the head of the list of callbacks registered on the current thread.
+	*/
+	inline thread_exit_callback*& thread_exit_callbacks() WENDA_NOEXCEPT
+	{
+		static WENDA_THREAD_LOCAL thread_exit_callback* head = nullptr;
+		return head;
+	}
+
+	/**
+	* Calls the callbacks registered on the current thread, in reverse order of registration.
+	* Callbacks registered by the callbacks themselves are also called.
+	*/
+	inline void run_thread_exit_callbacks()
+	{
+		auto& head = thread_exit_callbacks();
+
+		while (auto callback = head)
+		{
+			head = callback->next;
+			callback->function();
+		}
+	}
+
+#if defined(_MSC_VER) && _MSC_VER < 1900
+	inline void __stdcall thread_exit_fls_callback(void*)
+	{
+		run_thread_exit_callbacks();
+	}
+
+	/**
+	* Holds the fiber-local storage slot whose callback runs the thread-exit callbacks.
+	*/
+	template<typename = void>
+	struct thread_exit_slot
+	{
+		static std::once_flag flag;
+		static unsigned long index;
+
+		static void attach()
+		{
+			std::call_once(flag, []() { index = FlsAlloc(&thread_exit_fls_callback); });
+
+			// the callback is only invoked for threads on which the slot is not null.
+			FlsSetValue(index, reinterpret_cast<void*>(1));
+		}
+	};
+
+	template<typename T>
+	std::once_flag thread_exit_slot<T>::flag;
+
+	template<typename T>
+	unsigned long thread_exit_slot<T>::index = 0;
+
+	inline void attach_thread_exit_callbacks()
+	{
+		thread_exit_slot<>::attach();
+	}
+#else
+	struct thread_exit_guard
+	{
+		~thread_exit_guard()
+		{
+			run_thread_exit_callbacks();
+		}
+	};
+
+	inline void attach_thread_exit_callbacks()
+	{
+		static thread_local thread_exit_guard guard;
+		(void)guard;
+	}
+#endif
+
+	/**
+	* Registers @p callback to be called when the current thread exits.
+	* @param callback A record in a @ref WENDA_THREAD_LOCAL variable, which must not be registered already.
+	*/
+	inline void at_thread_exit(thread_exit_callback& callback)
+	{
+		auto& head = thread_exit_callbacks();
+
+		if (!head)
+		{
+			attach_thread_exit_callbacks();
+		}
+
+		callback.next = head;
+		head = &callback;
+	}
+
+	/**
+	* Holds an object of type @p T that is created on first use and never destroyed.
+	* The flag is a static data member rather than a function-local static, as those are not initialized
+	* thread-safely by Visual Studio 2013.
+	* @tparam Tag Distinguishes objects of the same type.
+	*/
+	template<typename T, typename Tag = T>
+	struct process_singleton
+	{
+		static std::once_flag flag;
+		static T* instance;
+
+		/**
+		* Returns the object, creating it with @p create if this is the first call.
+		* @param create A function returning a pointer to a new object of type @p T.
+		*/
+		template<typename Create>
+		static T& get(Create create)
+		{
+			std::call_once(flag, [&]() { instance = create(); });
+			return *instance;
+		}
+	};
+
+	template<typename T, typename Tag>
+	std::once_flag process_singleton<T, Tag>::flag;
+
+	template<typename T, typename Tag>
+	T* process_singleton<T, Tag>::instance = nullptr;
+}
+
+WENDA_FDS_NAMESPACE_END
+
+#endif // WENDA_FDS_DETAIL_THREAD_SUPPORT_H_INCLUDED
\ No newline at end of file
@@ -0,0 +1,425 @@
+#ifndef WENDA_FDS_EPOCH_H_INCLUDED
+#define WENDA_FDS_EPOCH_H_INCLUDED
+
+#include "FDS_common.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "detail/thread_support.h"
+
+/**
+* @file epoch.h
+* This file implements epoch-based reclamation for versions of the persistent data structures
+* that are shared between a writer thread and many reader threads.
+* The writer publishes versions in an @ref epoch_published slot. Readers access the published version
+* by reference inside an @ref epoch_guard, so that reading does not update any reference count,
+* and in particular does not contend on the reference count of the root.
+* When the writer replaces a version, the old version is retired to the @ref epoch_domain, which
+* releases it (and thereby its nodes) only once every reader that could still see it has left its guard.
+*/
+
+WENDA_FDS_NAMESPACE_BEGIN
+
+namespace detail
+{
+	/**
+	* The size of the cache lines on which the participants are placed.
+	*/
+	static const std::size_t epoch_cache_line_size = 64;
+
+	struct epoch_participant;
+
+	/**
+	* This struct holds the members of @ref epoch_participant, whose padding is computed from its size.
+	*/
+	struct epoch_participant_state
+	{
+		std::atomic<std::uint64_t> epoch; ///< The epoch observed by the thread, or 0 outside of a guard.
+		std::atomic<bool> in_use; ///< Whether the participant is attached to a thread.
+		epoch_participant* next; ///< The next participant of the domain.
+		std::size_t depth; ///< The number of nested guards. Only accessed by the attached thread.
+
+		epoch_participant_state() WENDA_NOEXCEPT
+			: epoch(0), in_use(true), next(nullptr), depth(0)
+		{}
+	};
+
+	/**
+	* This struct records the state of a thread participating in the epoch domain.
+	* Participants are padded and aligned to a cache line, so that readers entering and leaving
+	* their guards do not contend with each other.
+	*/
+	struct WENDA_ALIGNAS(64) epoch_participant
+		: epoch_participant_state
+	{
+		char padding[epoch_cache_line_size - sizeof(epoch_participant_state) % epoch_cache_line_size];
+	};
+
+	static_assert(sizeof(epoch_participant) % epoch_cache_line_size == 0, "Participants must fill whole cache lines.");
+
+	/**
+	* This struct records an object retired to the epoch domain.
+	*/
+	struct epoch_retired
+	{
+		std::uint64_t epoch; ///< The epoch during which the object was retired.
+		void const* object; ///< The retired object.
+		void(*destroy)(void const*); ///< Destroys the retired object.
+	};
+
+	template<typename T>
+	void destroy_retired(void const* object)
+	{
+		delete static_cast<T const*>(object);
+	}
+}
+
+/**
+* This class implements the epoch domain, which keeps track of the readers and retired objects.
+* There is a single domain in the process, obtained through instance().
+* An object retired during epoch e is destroyed once the global epoch reaches e + 2. The global epoch
+* only advances when every active reader has observed the current epoch, so that no reader can
+* still hold a reference to the object at that point.
+*/
+class epoch_domain
+{
+	static const std::size_t collect_threshold = 16;
+
+	std::atomic<std::uint64_t> global_epoch;
+	std::atomic<detail::epoch_participant*> participants;
+	std::mutex retired_mutex;
+	std::vector<detail::epoch_retired> retired;
+
+	/**
+	* This struct records the participant attached to a thread, which is released when the thread exits.
+	*/
+	struct thread_participant
+	{
+		detail::epoch_participant* participant;
+		detail::thread_exit_callback exit;
+	};
+
+	static thread_participant& local_participant() WENDA_NOEXCEPT
+	{
+		static WENDA_THREAD_LOCAL thread_participant local = { nullptr, { nullptr, nullptr } };
+		return local;
+	}
+
+	static void release_participant()
+	{
+		auto participant = local_participant().participant;
+		participant->epoch.store(0, std::memory_order_release);
+		participant->in_use.store(false, std::memory_order_release);
+	}
+
+	epoch_domain() WENDA_NOEXCEPT
+		: global_epoch(1), participants(nullptr)
+	{}
+
+	detail::epoch_participant* acquire_participant()
+	{
+		for (auto participant = participants.load(std::memory_order_acquire); participant; participant = participant->next)
+		{
+			bool in_use = false;
+
+			if (!participant->in_use.load(std::memory_order_relaxed) &&
+				participant->in_use.compare_exchange_strong(in_use, true, std::memory_order_acquire))
+			{
+				return participant;
+			}
+		}
+
+		// participants are never freed, so the padding needed to align them to a cache line is simply lost.
+		auto line = detail::epoch_cache_line_size;
+		auto memory = reinterpret_cast<std::uintptr_t>(::operator new(sizeof(detail::epoch_participant) + line - 1));
+		auto participant = ::new (reinterpret_cast<void*>((memory + line - 1) / line * line)) detail::epoch_participant();
+		auto head = participants.load(std::memory_order_relaxed);
+
+		do
+		{
+			participant->next = head;
+		} while (!participants.compare_exchange_weak(head, participant, std::memory_order_release, std::memory_order_relaxed));
+
+		return participant;
+	}
+public:
+	epoch_domain(epoch_domain const&) = delete;
+	epoch_domain& operator=(epoch_domain const&) = delete;
+
+	/**
+	* Returns the epoch domain of the process.
+	* The domain, and the participants of the threads, are never destroyed.
+	*/
+	static epoch_domain& instance()
+	{
+		return detail::process_singleton<epoch_domain>::get([]() { return new epoch_domain(); });
+	}
+
+	/**
+	* Returns the participant attached to the current thread.
+	*/
+	detail::epoch_participant* current_participant()
+	{
+		auto& local = local_participant();
+
+		if (!local.participant)
+		{
+			local.participant = acquire_participant();
+			local.exit.function = &release_participant;
+			detail::at_thread_exit(local.exit);
+		}
+
+		return local.participant;
+	}
+
+	/**
+	* Marks the current thread as reading in the current epoch.
+	* Prefer using @ref epoch_guard.
+	*/
+	void enter(detail::epoch_participant* participant) WENDA_NOEXCEPT
+	{
+		if (participant->depth++ == 0)
+		{
+			participant->epoch.store(global_epoch.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+			// the announcement must be visible before any shared pointer is read.
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+		}
+	}
+
+	/**
+	* Marks the current thread as no longer reading.
+	* Prefer using @ref epoch_guard.
+	*/
+	void leave(detail::epoch_participant* participant) WENDA_NOEXCEPT
+	{
+		if (--participant->depth == 0)
+		{
+			participant->epoch.store(0, std::memory_order_release);
+		}
+	}
+
+	/**
+	* Advances the global epoch if every active reader has observed it.
+	* @returns True if the epoch was advanced.
+	*/
+	bool try_advance() WENDA_NOEXCEPT
+	{
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		auto epoch = global_epoch.load(std::memory_order_relaxed);
+
+		for (auto participant = participants.load(std::memory_order_acquire); participant; participant = participant->next)
+		{
+			auto observed = participant->epoch.load(std::memory_order_acquire);
+
+			if (observed != 0 && observed != epoch)
+			{
+				return false;
+			}
+		}
+
+		return global_epoch.compare_exchange_strong(epoch, epoch + 1, std::memory_order_acq_rel);
+	}
+
+	/**
+	* Retires an object, which is destroyed once no reader can still access it.
+	* The object must no longer be reachable by readers entering a guard.
+	* @param object The object to retire. It must have been allocated with new.
+	*/
+	template<typename T>
+	void retire(T const* object)
+	{
+		std::size_t count;
+
+		{
+			std::lock_guard<std::mutex> lock(retired_mutex);
+			retired.push_back(detail::epoch_retired{ global_epoch.load(std::memory_order_seq_cst), object, &detail::destroy_retired<T> });
+			count = retired.size();
+		}
+
+		if (count >= collect_threshold)
+		{
+			collect();
+		}
+	}
+
+	/**
+	* Tries to advance the epoch, and destroys the retired objects that are no longer accessible.
+	* @returns The number of objects that were destroyed.
+	*/
+	std::size_t collect()
+	{
+		try_advance();
+		auto epoch = global_epoch.load(std::memory_order_acquire);
+
+		std::vector<detail::epoch_retired> expired;
+
+		{
+			std::lock_guard<std::mutex> lock(retired_mutex);
+
+			auto kept = retired.begin();
+
+			for (auto it = retired.begin(); it != retired.end(); ++it)
+			{
+				if (it->epoch + 2 <= epoch)
+				{
+					expired.push_back(*it);
+				}
+				else
+				{
+					*kept++ = *it;
+				}
+			}
+
+			retired.erase(kept, retired.end());
+		}
+
+		for (auto const& entry : expired)
+		{
+			entry.destroy(entry.object);
+		}
+
+		return expired.size();
+	}
+
+	/**
+	* Waits until all the objects retired so far have been destroyed.
+	* This must not be called from inside a guard.
+	*/
+	void synchronize()
+	{
+		for (;;)
+		{
+			collect();
+
+			{
+				std::lock_guard<std::mutex> lock(retired_mutex);
+
+				if (retired.empty())
+				{
+					return;
+				}
+			}
+
+			std::this_thread::yield();
+		}
+	}
+
+	/**
+	* Returns the number of retired objects waiting to be destroyed.
+	*/
+	std::size_t pending()
+	{
+		std::lock_guard<std::mutex> lock(retired_mutex);
+		return retired.size();
+	}
+};
+
+/**
+* This class implements a scope during which the current thread may read the versions
+* published in @ref epoch_published slots. Guards may be nested.
+*/
+class epoch_guard
+{
+	epoch_domain& domain;
+	detail::epoch_participant* participant;
+public:
+	/**
+	* Enters the current epoch.
+	*/
+	epoch_guard()
+		: domain(epoch_domain::instance()), participant(domain.current_participant())
+	{
+		domain.enter(participant);
+	}
+
+	epoch_guard(epoch_guard const&) = delete;
+	epoch_guard& operator=(epoch_guard const&) = delete;
+
+	/**
+	* Leaves the epoch. References obtained during the guard must no longer be used.
+	*/
+	~epoch_guard()
+	{
+		domain.leave(participant);
+	}
+};
+
+/**
+* This class implements a slot through which a writer publishes versions of a persistent data structure to readers.
+* Readers access the published version without updating any reference count, and the versions replaced by
+* the writer are only released once no reader can access them anymore.
+* Publishing must be serialized by the caller, typically by having a single writer thread.
+* @tparam Structure The type of the published data structure, for example a @ref redblack_tree.
+*/
+template<typename Structure>
+class epoch_published
+{
+	std::atomic<Structure const*> current;
+public:
+	/**
+	* Initializes a new slot publishing the given version.
+	*/
+	explicit epoch_published(Structure initial = Structure())
+		: current(new Structure(std::move(initial)))
+	{}
+
+	epoch_published(epoch_published const&) = delete;
+	epoch_published& operator=(epoch_published const&) = delete;
+
+	/**
+	* Releases the published version. There must not be any reader accessing the slot.
+	*/
+	~epoch_published()
+	{
+		delete current.load(std::memory_order_relaxed);
+	}
+
+	/**
+	* Returns the published version.
+	* The reference may be used until the end of the given guard.
+	*/
+	Structure const& load(epoch_guard const&) const WENDA_NOEXCEPT
+	{
+		return *current.load(std::memory_order_acquire);
+	}
+
+	/**
+	* Returns the published version. This may only be called by the writer.
+	*/
+	Structure const& get() const WENDA_NOEXCEPT
+	{
+		return *current.load(std::memory_order_relaxed);
+	}
+
+	/**
+	* Returns a copy of the published version, which may be used outside of a guard.
+	*/
+	Structure snapshot() const
+	{
+		epoch_guard guard;
+		return load(guard);
+	}
+
+	/**
+	* Publishes a new version, and retires the previous one.
+	* @param version The version to publish.
+	*/
+	void publish(Structure version)
+	{
+		auto next = new Structure(std::move(version));
+		auto previous = current.exchange(next, std::memory_order_acq_rel);
+		epoch_domain::instance().retire(previous);
+	}
+};
+
+WENDA_FDS_NAMESPACE_END
+
+#endif // WENDA_FDS_EPOCH_H_INCLUDED
\ No newline at end of file
@@ -7,36 +7,49 @@
 #include <iterator>
 
 #include "intrusive_ptr.h"
+#include "node_pool.h"
+#include "node_traits.h"
 
 WENDA_FDS_NAMESPACE_BEGIN
 
+template<typename Container, typename Hash, typename KeyEqual>
+class intern_table;
+
 namespace detail
 {
-    template<typename T>
+    template<typename T, typename Traits = default_node_traits<T>>
 	struct forward_list_node;
 
-    template<typename T>
+    template<typename T, typename Traits = default_node_traits<T>>
 	class forward_list_iterator;
 
+	/**
+	* The type of the smart pointer used to hold the nodes of a @ref forward_list.
+	* Nodes are returned to the allocator they were allocated with when released.
+	*/
+	template<typename T, typename Traits = default_node_traits<T>>
+	using forward_list_node_ptr = intrusive_ptr<forward_list_node<T, Traits>, forward_list_node<T, Traits>*, forward_list_node<T, Traits> const*,
+		node_deleter<forward_list_node<T, Traits>>>;
+
 	/**
 	* This class implements a way of holding a next pointer to a @ref forward_list_node.
 	*/
-    template<typename T>
+    template<typename T, typename Traits = default_node_traits<T>>
 	class forward_list_next
 	{
-		friend class forward_list_iterator<T>;
+		friend class forward_list_iterator<T, Traits>;
 	protected:
-		intrusive_ptr<forward_list_node<T>> next;
+		forward_list_node_ptr<T, Traits> next;
 
 		forward_list_next() WENDA_NOEXCEPT
 			: next(nullptr)
 		{}
 
-		forward_list_next(intrusive_ptr<forward_list_node<T>> const& next)
+		forward_list_next(forward_list_node_ptr<T, Traits> const& next)
 			: next(next)
 		{}
 
-		forward_list_next(intrusive_ptr<forward_list_node<T>>&& next) WENDA_NOEXCEPT
+		forward_list_next(forward_list_node_ptr<T, Traits>&& next) WENDA_NOEXCEPT
 			: next(std::move(next))
 		{}
 
@@ -64,43 +77,102 @@ namespace detail
 	/**
 	* This class implements a forward list node.
 	* @tparam T The type of the value held by the node.
+	* @tparam Traits The @ref node_traits of the node, which determine how it is allocated and reference counted.
 	*/
-    template<typename T>
+    template<typename T, typename Traits>
 	struct forward_list_node
-		: intrusive_refcount, forward_list_next<T>
+		: Traits::refcount_type, allocator_holder<typename Traits::allocator_type>, forward_list_next<T, Traits>
 	{
+		typedef typename Traits::allocator_type allocator_type; ///< The allocator used for the nodes.
+
 		T value;
 
-		forward_list_node(T value, intrusive_ptr<forward_list_node<T>> next)
-			: value(std::move(value)), forward_list_next(std::move(next))
+		forward_list_node(allocator_type const& allocator, T value, forward_list_node_ptr<T, Traits> next)
+			: allocator_holder<allocator_type>(allocator), forward_list_next<T, Traits>(std::move(next)), value(std::move(value))
+		{
+		}
+
+		/**
+		* Returns the pointer to the following node, or null.
+		*/
+		forward_list_node_ptr<T, Traits> const& get_next() const WENDA_NOEXCEPT
+		{
+			return this->next;
+		}
+
+		/**
+		* Returns the pointer to the following node.
+		* This may only be used to link a node that has not been shared yet.
+		*/
+		forward_list_node_ptr<T, Traits>& next_node() WENDA_NOEXCEPT
 		{
+			return this->next;
 		}
 	};
 
+	/**
+	* Returns a pointer to a new node holding the given @p value, and pointing to @p next.
+	* @param value The value to be stored in the node.
+	* @param next The node following the new node, or null.
+	* @param allocator The allocator with which to allocate the node. It is stored in the node.
+	*/
+	template<typename T, typename Traits, typename U>
+	forward_list_node_ptr<T, Traits> make_forward_list_node(U&& value, forward_list_node_ptr<T, Traits> const& next,
+		typename Traits::allocator_type const& allocator)
+	{
+		return forward_list_node_ptr<T, Traits>(allocate_node<forward_list_node<T, Traits>>(allocator, std::forward<U>(value), next));
+	}
+
+	/**
+	* Returns a pointer to a chain of new nodes holding the elements of the given range, in order,
+	* and followed by @p tail. The nodes are allocated in a single pass, and linked without
+	* any additional reference count update.
+	* @param first The beginning of the range.
+	* @param last The end of the range.
+	* @param tail The node following the last new node, or null. It is shared, not copied.
+	* @param allocator The allocator with which to allocate the nodes.
+	*/
+	template<typename T, typename Traits, typename InputIterator>
+	forward_list_node_ptr<T, Traits> make_forward_list_chain(InputIterator first, InputIterator last,
+		forward_list_node_ptr<T, Traits> tail, typename Traits::allocator_type const& allocator)
+	{
+		forward_list_node_ptr<T, Traits> head(nullptr);
+		auto slot = &head;
+
+		for (; first != last; ++first)
+		{
+			*slot = make_forward_list_node<T, Traits>(*first, nullptr, allocator);
+			slot = &(*slot)->next_node();
+		}
+
+		*slot = std::move(tail);
+		return head;
+	}
+
 	/**
 	* This class implements an iterator for @ref forward_list_iterator.
 	* This iterator models a forward iterator.
 	*/
-    template<typename T>
+    template<typename T, typename Traits>
 	class forward_list_iterator
-		: std::iterator<std::forward_iterator_tag, T, std::ptrdiff_t, T const*, T const&>
+		: public std::iterator<std::forward_iterator_tag, T, std::ptrdiff_t, T const*, T const&>
 	{
-		forward_list_next<T> const* current;
+		forward_list_next<T, Traits> const* current;
 	public:
 		forward_list_iterator() = default;
 
-		explicit WENDA_CONSTEXPR forward_list_iterator(forward_list_next<T> const* current) WENDA_NOEXCEPT
+		explicit WENDA_CONSTEXPR forward_list_iterator(forward_list_next<T, Traits> const* current) WENDA_NOEXCEPT
 			: current(current)
 		{}
 
 		WENDA_CONSTEXPR reference operator*() const WENDA_NOEXCEPT
 		{
-			return static_cast<forward_list_node<T> const*>(current)->value;
+			return static_cast<forward_list_node<T, Traits> const*>(current)->value;
 		}
 
 		WENDA_CONSTEXPR pointer operator->() const WENDA_NOEXCEPT
 		{
-			return std::addressof(static_cast<forward_list_node<T> const*>(current)->value);
+			return std::addressof(static_cast<forward_list_node<T, Traits> const*>(current)->value);
 		}
 
 		forward_list_iterator& operator++() WENDA_NOEXCEPT
@@ -112,16 +184,16 @@ namespace detail
 		forward_list_iterator operator++(int) WENDA_NOEXCEPT
 		{
 			auto r = *this;
-			current = &current->next;
+			current = current->next.get();
 			return r;
 		}
 
-		bool operator==(forward_list_iterator<T> const& other) WENDA_NOEXCEPT
+		bool operator==(forward_list_iterator const& other) const WENDA_NOEXCEPT
 		{
 			return current == other.current;
 		}
 
-		bool operator!=(forward_list_iterator<T> const& other) WENDA_NOEXCEPT
+		bool operator!=(forward_list_iterator const& other) const WENDA_NOEXCEPT
 		{
 			return current != other.current;
 		}
@@ -133,20 +205,28 @@ namespace detail
 * programming languages.
 * The @ref forward_list shares the common nodes when possible. 
 * @tparam The type of the elements contained in the list.
+* @tparam Allocator The allocator used to allocate the nodes of the list. A copy of it is
+* stored in every node, so that nodes shared between lists are released correctly.
+* @tparam RefCountPolicy The policy used to update the reference counts of the nodes.
+* Use @ref nonatomic_refcount_policy for lists that are confined to a single thread.
 */
-template<typename T>
+template<typename T, typename Allocator = node_pool_allocator<T>, typename RefCountPolicy = default_refcount_policy>
 class forward_list
-	: detail::forward_list_next<T>
+	: detail::forward_list_next<T, detail::node_traits<Allocator, RefCountPolicy>>, detail::allocator_holder<Allocator>
 {
-	friend class detail::forward_list_iterator<T>;
+	typedef detail::node_traits<Allocator, RefCountPolicy> traits_type;
+	typedef detail::allocator_holder<Allocator> allocator_base;
+
+	friend class detail::forward_list_iterator<T, traits_type>;
+	template<typename, typename, typename> friend class intern_table;
 
-	forward_list(intrusive_ptr<detail::forward_list_node<T>> const& next)
-		: forward_list_next(next)
+	forward_list(detail::forward_list_node_ptr<T, traits_type> const& next, Allocator const& allocator)
+		: forward_list_next(next), allocator_base(allocator)
 	{
 	}
 
-	forward_list(intrusive_ptr<detail::forward_list_node<T>> &&next)
-		: forward_list_next(std::move(next))
+	forward_list(detail::forward_list_node_ptr<T, traits_type> &&next, Allocator const& allocator)
+		: forward_list_next(std::move(next)), allocator_base(allocator)
 	{
 	}
 public:
@@ -154,7 +234,29 @@ public:
 	* Defauld constructor, constructs an empty container.
 	*/
 	forward_list() WENDA_NOEXCEPT
-		: forward_list_next(nullptr)
+		: forward_list_next(nullptr), allocator_base(Allocator())
+	{
+	}
+
+	/**
+	* Constructs an empty container, whose nodes will be allocated with the given @p allocator.
+	*/
+	explicit forward_list(Allocator const& allocator) WENDA_NOEXCEPT
+		: forward_list_next(nullptr), allocator_base(allocator)
+	{
+	}
+
+	/**
+	* Constructs a list holding the elements of the given range, in the same order.
+	* The nodes are allocated in a single pass over the range.
+	* This constructor only participates in overload resolution if @p InputIterator is an iterator type.
+	* @param first The beginning of the range.
+	* @param last The end of the range.
+	* @param allocator The allocator with which to allocate the nodes.
+	*/
+	template<typename InputIterator, typename = typename std::iterator_traits<InputIterator>::iterator_category>
+	forward_list(InputIterator first, InputIterator last, Allocator const& allocator = Allocator())
+		: forward_list_next(detail::make_forward_list_chain<T, traits_type>(first, last, nullptr, allocator)), allocator_base(allocator)
 	{
 	}
 
@@ -162,16 +264,16 @@ public:
 	* Copy constructor.
 	* Constructs a new @ref forward_list referencing the elements from the @p other list.
 	*/
-	forward_list(forward_list<T> const& other)
-		: forward_list_next(other)
+	forward_list(forward_list const& other)
+		: forward_list_next(other), allocator_base(other)
 	{}
 
 	/**
 	* Move constructor.
 	* Constructs a new @ref forward_list referencing the elements from the @p other list.
 	*/
-	forward_list(forward_list<T>&& other) WENDA_NOEXCEPT
-		: forward_list_next(std::move(other.next))
+	forward_list(forward_list&& other) WENDA_NOEXCEPT
+		: forward_list_next(std::move(other.next)), allocator_base(other)
 	{}
 
 	/**
@@ -181,6 +283,7 @@ public:
 	forward_list& operator=(forward_list const& other)
 	{
 		forward_list_next::operator=(other);
+		allocator_base::operator=(other);
 		return *this;
 	}
 
@@ -191,20 +294,31 @@ public:
 	forward_list& operator=(forward_list&& other)
 	{
 		forward_list_next::operator=(std::move(other));
+		allocator_base::operator=(other);
 		return *this;
 	}
 
 	typedef T value_type; ///< The type of the elements contained in the list.
-	typedef detail::forward_list_iterator<T> iterator; ///< The type of the iterator used to enumerate the list.
+	typedef Allocator allocator_type; ///< The type of the allocator of the list.
+	typedef detail::forward_list_iterator<T, traits_type> iterator; ///< The type of the iterator used to enumerate the list.
+
+	/**
+	* Returns a copy of the allocator used to allocate the nodes of the list.
+	*/
+	Allocator get_allocator() const WENDA_NOEXCEPT
+	{
+		return allocator_base::get_allocator();
+	}
 
 	/**
 	* Returns a new list with the given @p value prepended to the current list.
 	* @param value The value to prepend to the list. It is copied into the list.
 	* @returns A new list with the value prepended.
 	*/
-	forward_list<T> push_front(T const& value) const
+	forward_list push_front(T const& value) const
 	{
-		return forward_list<T>(make_intrusive<detail::forward_list_node<T>> (value, next));
+		auto allocator = get_allocator();
+		return forward_list(detail::make_forward_list_node<T, traits_type>(value, next, allocator), allocator);
 	}
 
 	/**
@@ -212,9 +326,10 @@ public:
 	* @param value The value to prepend to the list. It is moved into the list.
 	* @returns A new list with the value prepended.
 	*/
-	forward_list<T> push_front(T&& value) const
+	forward_list push_front(T&& value) const
 	{
-		return forward_list<T>(make_intrusive<detail::forward_list_node<T>>(std::move(value), next));
+		auto allocator = get_allocator();
+		return forward_list(detail::make_forward_list_node<T, traits_type>(std::move(value), next, allocator), allocator);
 	}
 
 	/**
@@ -223,9 +338,24 @@ public:
 	* @returns A new list with the constructed value prepended.
 	*/
     template<typename... Args>
-	forward_list<T> emplace_front(Args... args) const
+	forward_list emplace_front(Args... args) const
+	{
+		auto allocator = get_allocator();
+		return forward_list(detail::make_forward_list_node<T, traits_type>(T(std::forward<Args>(args)...), next, allocator), allocator);
+	}
+
+	/**
+	* Returns a new list with the elements of the given range prepended to the current list, in order.
+	* The new nodes are allocated in a single pass over the range, and share the current list as their tail.
+	* @param first The beginning of the range.
+	* @param last The end of the range.
+	* @returns A new list starting with the elements of the range, followed by the elements of this list.
+	*/
+	template<typename InputIterator>
+	forward_list prepend_range(InputIterator first, InputIterator last) const
 	{
-		return forward_list<T>(make_intrusive<detail::forward_list_node<T>>(T(std::forward<Args>(args)...), next));
+		auto allocator = get_allocator();
+		return forward_list(detail::make_forward_list_chain<T, traits_type>(first, last, next, allocator), allocator);
 	}
 
 	/**
@@ -0,0 +1,428 @@
+#ifndef WENDA_FDS_INTERN_TABLE_H_INCLUDED
+#define WENDA_FDS_INTERN_TABLE_H_INCLUDED
+
+#include "FDS_common.h"
+
+#include <cstddef>
+#include <functional>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "forward_list.h"
+#include "redblack_tree.h"
+
+/**
+* @file intern_table.h
+* This file implements intern tables, which share the equal nodes of containers that were built independently.
+* A table holds a canonical node for every distinct node it has seen, identified by its element and its children.
+* As the children are canonical themselves, equal subtrees (or tails of lists) that were interned in the same table
+* are the same node, so that containers holding heavily overlapping content store it only once, and compare
+* equal by pointer where they have the same shape.
+* The nodes held by a table remain alive as long as the table, until they are released by collect().
+* A table is not thread-safe, and nodes created in a @ref region_scope must not be interned, as the region
+* destroys them regardless of the references held by the table.
+*/
+
+WENDA_FDS_NAMESPACE_BEGIN
+
+namespace detail
+{
+	/**
+	* Combines the hash of a pointer and its packed value with the given hash.
+	*/
+	template<typename T>
+	std::size_t combine_pointer_hash(std::size_t hash, T const* pointer, std::uint_fast32_t value) WENDA_NOEXCEPT
+	{
+		auto pointerHash = std::hash<T const*>()(pointer) ^ static_cast<std::size_t>(value);
+		return hash ^ (pointerHash + 0x9e3779b9 + (hash << 6) + (hash >> 2));
+	}
+}
+
+/**
+* This class implements an intern table for the nodes of a persistent container.
+* It is specialized for @ref redblack_tree and @ref forward_list.
+* @tparam Container The type of the containers whose nodes are interned.
+* @tparam Hash The hash function of the elements of the container.
+* @tparam KeyEqual The equality of the elements of the container. Only nodes with equal elements are shared.
+*/
+template<typename Container, typename Hash = std::hash<typename Container::value_type>,
+	typename KeyEqual = std::equal_to<typename Container::value_type>>
+class intern_table;
+
+/**
+* This class implements an intern table for the nodes of red-black trees.
+* A node is identified by its element and its children, including their colours, which are held by the pointers to them.
+*/
+template<typename T, typename Compare, typename Allocator, typename RefCountPolicy, typename Augmentation, typename Hash, typename KeyEqual>
+class intern_table<redblack_tree<T, Compare, Allocator, RefCountPolicy, Augmentation>, Hash, KeyEqual>
+{
+public:
+	typedef redblack_tree<T, Compare, Allocator, RefCountPolicy, Augmentation> container_type; ///< The type of the interned trees.
+private:
+	typedef typename container_type::traits_type traits_type;
+	typedef detail::redblack_node<T, traits_type> node_type;
+	typedef detail::const_rb_pointer<T, traits_type> node_pointer;
+	typedef detail::const_intrusive_rb_ptr<T, traits_type> node_ptr;
+
+	/**
+	* This struct holds the element and children identifying a node.
+	*/
+	struct node_key
+	{
+		T const* data;
+		node_ptr const* left;
+		node_ptr const* right;
+
+		/**
+		* Returns the key of @p node, or @p lookup if @p node is null, which stands for the key being looked up.
+		*/
+		static node_key of(node_ptr const& node, node_key const* lookup)
+		{
+			return node ? node_key{ &node->get_data(), &node->get_left(), &node->get_right() } : *lookup;
+		}
+	};
+
+	/**
+	* Hashes the element and children of a node.
+	*/
+	struct node_hasher
+	{
+		node_key const* lookup;
+
+		std::size_t operator()(node_ptr const& node) const
+		{
+			auto key = node_key::of(node, lookup);
+			auto hash = Hash()(*key.data);
+			hash = detail::combine_pointer_hash(hash, key.left->get().get(), key.left->get_value());
+			return detail::combine_pointer_hash(hash, key.right->get().get(), key.right->get_value());
+		}
+	};
+
+	/**
+	* Compares the elements and children of two nodes.
+	*/
+	struct node_equal
+	{
+		node_key const* lookup;
+
+		bool operator()(node_ptr const& left, node_ptr const& right) const
+		{
+			auto first = node_key::of(left, lookup);
+			auto second = node_key::of(right, lookup);
+			return *first.left == *second.left && *first.right == *second.right && KeyEqual()(*first.data, *second.data);
+		}
+	};
+
+	// the hash and equality of the nodes refer to the lookup key, so that the table is neither copied nor moved.
+	node_key lookup; ///< The key of the node being looked up, which is represented by a null pointer.
+	std::unordered_set<node_ptr, node_hasher, node_equal> nodes; ///< The canonical nodes, by element and children.
+
+	typename std::unordered_set<node_ptr, node_hasher, node_equal>::iterator find(T const& data, node_ptr const& left, node_ptr const& right)
+	{
+		lookup = node_key{ &data, &left, &right };
+		return nodes.find(node_ptr());
+	}
+
+	bool is_canonical(node_pointer node)
+	{
+		auto existing = find(node->get_data(), node->get_left(), node->get_right());
+		return existing != nodes.end() && existing->get().get() == node.get();
+	}
+
+	node_ptr intern_node(node_pointer node, Allocator const& allocator)
+	{
+		if (is_leaf(node) || is_canonical(node))
+		{
+			return node;
+		}
+
+		auto left = intern_node(node->get_left().get(), allocator);
+		auto right = intern_node(node->get_right().get(), allocator);
+		auto existing = find(node->get_data(), left, right);
+
+		if (existing != nodes.end())
+		{
+			node_ptr result = *existing;
+			detail::set_colour(result, detail::colour(node));
+			return result;
+		}
+
+		// the node itself becomes canonical if its children already were.
+		node_ptr result = left == node->get_left() && right == node->get_right()
+			? node_ptr(node)
+			: node_ptr(detail::make_redblack_node<T, traits_type>(node->get_data(), detail::colour(node), std::move(left), std::move(right), allocator));
+
+		nodes.insert(result);
+		return result;
+	}
+public:
+	/**
+	* Initializes a new empty table.
+	*/
+	intern_table()
+		: nodes(0, node_hasher{ &lookup }, node_equal{ &lookup })
+	{}
+
+	intern_table(intern_table const&) = delete;
+	intern_table& operator=(intern_table const&) = delete;
+
+	/**
+	* Returns a tree holding the same elements as @p tree, in the same shape, whose nodes are canonical.
+	* Subtrees that are already canonical are not visited, so that interning a version derived from an interned
+	* tree takes time proportional to the number of nodes created since.
+	*/
+	container_type intern(container_type const& tree)
+	{
+		auto allocator = tree.get_allocator();
+		return container_type(intern_node(tree.root.get(), allocator), allocator);
+	}
+
+	/**
+	* Returns the number of canonical nodes held by the table.
+	*/
+	std::size_t size() const WENDA_NOEXCEPT
+	{
+		return nodes.size();
+	}
+
+	/**
+	* Releases the canonical nodes which are only referenced by the table, and by other such nodes.
+	*/
+	void collect()
+	{
+		std::vector<node_type const*> unused;
+
+		for (auto const& node : nodes)
+		{
+			if (is_unique_reference(node.get().get()))
+			{
+				unused.push_back(node.get().get());
+			}
+		}
+
+		while (!unused.empty())
+		{
+			auto node = unused.back();
+			node_type const* children[] = { node->get_left().get().get(), node->get_right().get().get() };
+			unused.pop_back();
+
+			// releases the node, and thus the references it holds on its children.
+			nodes.erase(find(node->get_data(), node->get_left(), node->get_right()));
+
+			for (auto child : children)
+			{
+				if (child && is_canonical(child) && is_unique_reference(child))
+				{
+					unused.push_back(child);
+				}
+			}
+		}
+	}
+
+	/**
+	* Releases all the nodes held by the table. The trees returned by the table remain valid.
+	*/
+	void clear()
+	{
+		nodes.clear();
+	}
+};
+
+/**
+* This class implements an intern table for the nodes of forward lists.
+* A node is identified by its element and the node following it, so that lists sharing a suffix share its nodes.
+*/
+template<typename T, typename Allocator, typename RefCountPolicy, typename Hash, typename KeyEqual>
+class intern_table<forward_list<T, Allocator, RefCountPolicy>, Hash, KeyEqual>
+{
+public:
+	typedef forward_list<T, Allocator, RefCountPolicy> container_type; ///< The type of the interned lists.
+private:
+	typedef detail::node_traits<Allocator, RefCountPolicy> traits_type;
+	typedef detail::forward_list_node<T, traits_type> node_type;
+	typedef detail::forward_list_node_ptr<T, traits_type> node_ptr;
+
+	/**
+	* This struct holds the element and next node identifying a node.
+	*/
+	struct node_key
+	{
+		T const* value;
+		node_ptr const* next;
+
+		/**
+		* Returns the key of @p node, or @p lookup if @p node is null, which stands for the key being looked up.
+		*/
+		static node_key of(node_ptr const& node, node_key const* lookup)
+		{
+			return node ? node_key{ &node->value, &node->get_next() } : *lookup;
+		}
+	};
+
+	/**
+	* Hashes the element and next node of a node.
+	*/
+	struct node_hasher
+	{
+		node_key const* lookup;
+
+		std::size_t operator()(node_ptr const& node) const
+		{
+			auto key = node_key::of(node, lookup);
+			return detail::combine_pointer_hash(Hash()(*key.value), key.next->get(), 0);
+		}
+	};
+
+	/**
+	* Compares the elements and next nodes of two nodes.
+	*/
+	struct node_equal
+	{
+		node_key const* lookup;
+
+		bool operator()(node_ptr const& left, node_ptr const& right) const
+		{
+			auto first = node_key::of(left, lookup);
+			auto second = node_key::of(right, lookup);
+			return *first.next == *second.next && KeyEqual()(*first.value, *second.value);
+		}
+	};
+
+	// the hash and equality of the nodes refer to the lookup key, so that the table is neither copied nor moved.
+	node_key lookup; ///< The key of the node being looked up, which is represented by a null pointer.
+	std::unordered_set<node_ptr, node_hasher, node_equal> nodes; ///< The canonical nodes, by element and next node.
+
+	typename std::unordered_set<node_ptr, node_hasher, node_equal>::iterator find(T const& value, node_ptr const& next)
+	{
+		lookup = node_key{ &value, &next };
+		return nodes.find(node_ptr());
+	}
+
+	bool is_canonical(node_type const* node)
+	{
+		auto existing = find(node->value, node->get_next());
+		return existing != nodes.end() && existing->get() == node;
+	}
+
+	/**
+	* Returns the canonical node holding @p value followed by @p next, which must be canonical.
+	* @param node A node holding @p value, which is made canonical if it is followed by @p next and no canonical node exists.
+	*/
+	template<typename U>
+	node_ptr intern_node(U&& value, node_ptr&& next, node_type const* node, Allocator const& allocator)
+	{
+		auto existing = find(value, next);
+
+		if (existing != nodes.end())
+		{
+			return *existing;
+		}
+
+		// the nodes of the table are never modified, so that the list may hold them as modifiable nodes.
+		node_ptr result = node && node->get_next() == next
+			? node_ptr(const_cast<node_type*>(node))
+			: detail::make_forward_list_node<T, traits_type>(std::forward<U>(value), next, allocator);
+
+		nodes.insert(result);
+		return result;
+	}
+public:
+	/**
+	* Initializes a new empty table.
+	*/
+	intern_table()
+		: nodes(0, node_hasher{ &lookup }, node_equal{ &lookup })
+	{}
+
+	intern_table(intern_table const&) = delete;
+	intern_table& operator=(intern_table const&) = delete;
+
+	/**
+	* Returns a list holding the same elements as @p list, whose nodes are canonical.
+	* The walk stops at the first canonical node, so that interning a list built by prepending elements to an
+	* interned list takes time proportional to the number of elements prepended.
+	*/
+	container_type intern(container_type const& list)
+	{
+		std::vector<node_type const*> pending;
+		auto node = list.next.get();
+
+		for (; node && !is_canonical(node); node = node->get_next().get())
+		{
+			pending.push_back(node);
+		}
+
+		auto allocator = list.get_allocator();
+		node_ptr head(const_cast<node_type*>(node));
+
+		for (auto current = pending.rbegin(); current != pending.rend(); ++current)
+		{
+			head = intern_node((*current)->value, std::move(head), *current, allocator);
+		}
+
+		return container_type(std::move(head), allocator);
+	}
+
+	/**
+	* Returns the list holding @p value followed by the elements of @p list, whose nodes are canonical.
+	* If the table already holds a node for @p value followed by the interned @p list, it is returned, and nothing is allocated.
+	*/
+	container_type push_front(container_type const& list, T const& value)
+	{
+		auto allocator = list.get_allocator();
+		auto tail = intern(list);
+		return container_type(intern_node(value, std::move(tail.next), nullptr, allocator), allocator);
+	}
+
+	/**
+	* Returns the number of canonical nodes held by the table.
+	*/
+	std::size_t size() const WENDA_NOEXCEPT
+	{
+		return nodes.size();
+	}
+
+	/**
+	* Releases the canonical nodes which are only referenced by the table, and by other such nodes.
+	*/
+	void collect()
+	{
+		std::vector<node_type const*> unused;
+
+		for (auto const& node : nodes)
+		{
+			if (is_unique_reference(node.get()))
+			{
+				unused.push_back(node.get());
+			}
+		}
+
+		while (!unused.empty())
+		{
+			auto node = unused.back();
+			auto next = node->get_next().get();
+			unused.pop_back();
+
+			// releases the node, and thus the reference it holds on the next node.
+			nodes.erase(find(node->value, node->get_next()));
+
+			if (next && is_canonical(next) && is_unique_reference(next))
+			{
+				unused.push_back(next);
+			}
+		}
+	}
+
+	/**
+	* Releases all the nodes held by the table. The lists returned by the table remain valid.
+	*/
+	void clear()
+	{
+		nodes.clear();
+	}
+};
+
+WENDA_FDS_NAMESPACE_END
+
+#endif // WENDA_FDS_INTERN_TABLE_H_INCLUDED
\ No newline at end of file
@@ -12,10 +12,13 @@ WENDA_FDS_NAMESPACE_BEGIN
 * This class implements an @ref intrusive_ptr with a small integral value packed inside it.
 * It is essentially a combination of @ref intrusive_ptr and @ref packed_ptr.
 * The integral value is packed in the alignment bits of the raw pointer.
+* @tparam T The type pointed to by this pointer.
+* @tparam Deleter The deleter invoked with the packed pointer when the last reference is released.
+* Pointers to @p T and to const @p T share the same deleter, so that they remain convertible.
 */
-template<typename T>
+template<typename T, typename Deleter = packed_ptr_deleter<typename std::remove_const<T>::type>>
 class intrusive_packed_ptr
-	: public intrusive_ptr<T, packed_ptr<T>, packed_ptr<const T>, packed_ptr_deleter<T>>
+	: public intrusive_ptr<T, packed_ptr<T>, packed_ptr<const T>, Deleter>
 {
 public:
 	/**
@@ -91,7 +94,7 @@ public:
 	* Converts from a compatible pointer type.
 	*/
 	template<typename U, typename SFINAE = typename std::enable_if<std::is_convertible<U*, T*>::value>::type>
-	intrusive_packed_ptr(intrusive_packed_ptr<U> const& other)
+	intrusive_packed_ptr(intrusive_packed_ptr<U, Deleter> const& other)
 		: intrusive_ptr(other.get())
 	{}
 
@@ -100,7 +103,7 @@ public:
 	* Converts from a compatible pointer type.
 	*/
 	template<typename U, typename SFINAE = typename std::enable_if<std::is_convertible<U*, T*>::value>::type>
-	intrusive_packed_ptr(intrusive_packed_ptr<U>&& other)
+	intrusive_packed_ptr(intrusive_packed_ptr<U, Deleter>&& other)
 		: intrusive_ptr(std::move(other.get()))
 	{}
 
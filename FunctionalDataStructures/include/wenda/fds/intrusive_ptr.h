@@ -5,6 +5,7 @@
 #include <type_traits>
 #include <atomic>
 #include <cstddef>
+#include <utility>
 
 WENDA_FDS_NAMESPACE_BEGIN
 
@@ -94,7 +95,7 @@ public:
 		using std::swap;
 
 		intrusive_ptr temp(other);
-		swap(*this, temp);
+		swap(pointer, temp.pointer);
 		return *this;
 	}
 
@@ -102,8 +103,9 @@ public:
 	{
 		using std::swap;
 
-		pointer = other.pointer;
-		other.pointer = nullptr;
+		// the previously held pointer is released by temp.
+		intrusive_ptr temp(std::move(other));
+		swap(pointer, temp.pointer);
 
 		return *this;
 	}
@@ -147,7 +149,7 @@ public:
 
 		intrusive_ptr temp(other);
 
-		swap(*this, temp);
+		swap(pointer, temp.pointer);
 
 		return *this;
 	}
@@ -159,8 +161,10 @@ public:
 		typename SFINAE = std::enable_if<std::is_convertible<UPtr, pointer_t>::value>::type>
 	intrusive_ptr& operator=(intrusive_ptr<U, UPtr, UConstPtr, Deleter>&& other) WENDA_NOEXCEPT
 	{
-		pointer = other.pointer;
-		other.pointer = nullptr;
+		using std::swap;
+
+		intrusive_ptr temp(std::move(other));
+		swap(pointer, temp.pointer);
 
 		return *this;
 	}
@@ -297,33 +301,170 @@ intrusive_ptr<T> const_pointer_cast(intrusive_ptr<U>&& pointer) WENDA_NOEXCEPT
 	return intrusive_ptr<T>(std::move(pointer));
 }
 
-class intrusive_refcount
+/**
+* Reference counting policy using sequentially consistent atomic operations.
+* This is the strongest (and slowest) policy, kept for code that relies on the
+* reference count being a synchronization point.
+*/
+struct seq_cst_refcount_policy
 {
-	friend std::size_t add_reference(intrusive_refcount const*);
-    friend std::size_t remove_reference(intrusive_refcount const* obj);
+	typedef std::atomic_size_t counter_type;
 
-	mutable std::atomic_size_t counter;
-public:
-	intrusive_refcount() WENDA_NOEXCEPT
-		: counter(0)
+	static std::size_t increment(counter_type& counter, std::size_t count) WENDA_NOEXCEPT
 	{
+		return counter += count;
 	}
 
-	intrusive_refcount(intrusive_refcount const& other) WENDA_NOEXCEPT
-		: counter(0)
+	static std::size_t decrement(counter_type& counter) WENDA_NOEXCEPT
+	{
+		return --counter;
+	}
+
+	static std::size_t load(counter_type const& counter) WENDA_NOEXCEPT
 	{
+		return counter.load();
 	}
 };
 
-inline std::size_t add_reference(intrusive_refcount const* obj) WENDA_NOEXCEPT
+/**
+* Reference counting policy for objects shared between threads.
+* Increments are relaxed, as a new reference can only be created from an existing one.
+* Decrements release, and the thread dropping the last reference acquires before
+* the object is destroyed, so that all previous accesses happen before the destruction.
+*/
+struct atomic_refcount_policy
 {
-    return ++(obj->counter);
-}
+	typedef std::atomic_size_t counter_type;
+
+	static std::size_t increment(counter_type& counter, std::size_t count) WENDA_NOEXCEPT
+	{
+		return counter.fetch_add(count, std::memory_order_relaxed) + count;
+	}
+
+	static std::size_t decrement(counter_type& counter) WENDA_NOEXCEPT
+	{
+		auto result = counter.fetch_sub(1, std::memory_order_release) - 1;
+
+		if (result == 0)
+		{
+			std::atomic_thread_fence(std::memory_order_acquire);
+		}
+
+		return result;
+	}
 
-inline std::size_t remove_reference(intrusive_refcount const* obj) WENDA_NOEXCEPT
+	static std::size_t load(counter_type const& counter) WENDA_NOEXCEPT
+	{
+		return counter.load(std::memory_order_acquire);
+	}
+};
+
+/**
+* Reference counting policy for objects confined to a single thread.
+* The counter is a plain integer: versions using this policy must not be shared
+* (or released) across threads without external synchronization.
+*/
+struct nonatomic_refcount_policy
 {
-	return --(obj->counter);
-}
+	typedef std::size_t counter_type;
+
+	static std::size_t increment(counter_type& counter, std::size_t count) WENDA_NOEXCEPT
+	{
+		return counter += count;
+	}
+
+	static std::size_t decrement(counter_type& counter) WENDA_NOEXCEPT
+	{
+		return --counter;
+	}
+
+	static std::size_t load(counter_type const& counter) WENDA_NOEXCEPT
+	{
+		return counter;
+	}
+};
+
+/**
+* Indicates whether objects counted with the given policy may be shared between threads.
+*/
+template<typename Policy>
+struct is_thread_safe_refcount_policy
+	: std::true_type
+{};
+
+template<>
+struct is_thread_safe_refcount_policy<nonatomic_refcount_policy>
+	: std::false_type
+{};
+
+/**
+* The reference counting policy used when none is specified.
+*/
+typedef atomic_refcount_policy default_refcount_policy;
+
+/**
+* This class implements an intrusive reference count that can be used as a base class
+* for objects held by @ref intrusive_ptr.
+* @tparam Policy The policy determining how the counter is updated, one of
+* @ref atomic_refcount_policy, @ref seq_cst_refcount_policy or @ref nonatomic_refcount_policy.
+*/
+template<typename Policy>
+class basic_intrusive_refcount
+{
+	mutable typename Policy::counter_type counter;
+public:
+	typedef Policy refcount_policy; ///< The policy used to update the counter.
+
+	basic_intrusive_refcount() WENDA_NOEXCEPT
+		: counter(0)
+	{
+	}
+
+	basic_intrusive_refcount(basic_intrusive_refcount const& other) WENDA_NOEXCEPT
+		: counter(0)
+	{
+	}
+
+	friend std::size_t add_reference(basic_intrusive_refcount const* obj) WENDA_NOEXCEPT
+	{
+		return Policy::increment(obj->counter, 1);
+	}
+
+	/**
+	* Adds @p count references to the given object at once.
+	*/
+	friend std::size_t add_reference(basic_intrusive_refcount const* obj, std::size_t count) WENDA_NOEXCEPT
+	{
+		return Policy::increment(obj->counter, count);
+	}
+
+	friend std::size_t remove_reference(basic_intrusive_refcount const* obj) WENDA_NOEXCEPT
+	{
+		return Policy::decrement(obj->counter);
+	}
+
+	/**
+	* Returns the number of references currently held on the given object.
+	*/
+	friend std::size_t reference_count(basic_intrusive_refcount const* obj) WENDA_NOEXCEPT
+	{
+		return Policy::load(obj->counter);
+	}
+
+	/**
+	* Returns a value indicating whether the caller holds the only reference to the given object,
+	* in which case it may modify the object in place.
+	*/
+	friend bool is_unique_reference(basic_intrusive_refcount const* obj) WENDA_NOEXCEPT
+	{
+		return Policy::load(obj->counter) == 1;
+	}
+};
+
+/**
+* The intrusive reference count using the default policy.
+*/
+typedef basic_intrusive_refcount<default_refcount_policy> intrusive_refcount;
 
 WENDA_FDS_NAMESPACE_END
 
@@ -0,0 +1,65 @@
+#ifndef WENDA_FDS_ITERATOR_RANGE_H_INCLUDED
+#define WENDA_FDS_ITERATOR_RANGE_H_INCLUDED
+
+#include "FDS_common.h"
+
+#include <utility>
+
+/**
+* @file iterator_range.h
+* This file implements a view over a range delimited by two iterators, so that the
+* ranges returned by the data structures may be used in range-based for loops.
+*/
+
+WENDA_FDS_NAMESPACE_BEGIN
+
+/**
+* This class represents the range of elements between two iterators.
+* It does not own the elements: the data structure they belong to must outlive the range.
+* @tparam Iterator The type of the iterators.
+*/
+template<typename Iterator>
+class iterator_range
+{
+	Iterator first;
+	Iterator last;
+public:
+	typedef Iterator iterator; ///< The type of the iterators.
+
+	/**
+	* Initializes a new range from the given iterators.
+	* @param first An iterator to the first element of the range.
+	* @param last An iterator one past the last element of the range.
+	*/
+	iterator_range(Iterator first, Iterator last)
+		: first(std::move(first)), last(std::move(last))
+	{}
+
+	/**
+	* Returns an iterator to the first element of the range.
+	*/
+	Iterator begin() const
+	{
+		return first;
+	}
+
+	/**
+	* Returns an iterator one past the last element of the range.
+	*/
+	Iterator end() const
+	{
+		return last;
+	}
+
+	/**
+	* Tests whether there are any elements in the range.
+	*/
+	bool empty() const
+	{
+		return first == last;
+	}
+};
+
+WENDA_FDS_NAMESPACE_END
+
+#endif // WENDA_FDS_ITERATOR_RANGE_H_INCLUDED
\ No newline at end of file
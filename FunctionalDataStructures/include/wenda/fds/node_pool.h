@@ -0,0 +1,375 @@
+#ifndef WENDA_FDS_NODE_POOL_H_INCLUDED
+#define WENDA_FDS_NODE_POOL_H_INCLUDED
+
+#include "FDS_common.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <mutex>
+#include <type_traits>
+
+#include "detail/thread_support.h"
+
+/**
+* @file node_pool.h
+* This file implements a fixed-size block pool from which the nodes of the
+* persistent data structures are allocated.
+* Blocks are grouped into size classes. Each thread keeps a small cache of free blocks
+* for every size class, and exchanges them in batches with a central free list
+* shared by all threads. A block may be freed by any thread, not only the one that allocated it:
+* it simply lands in the cache of the freeing thread.
+* Memory obtained by the pool is retained for the lifetime of the process.
+*/
+
+WENDA_FDS_NAMESPACE_BEGIN
+
+namespace detail
+{
+	/**
+	* The alignment of the blocks of the node pool, which is enough for any fundamental type.
+	*/
+	static const std::size_t node_pool_alignment = std::alignment_of<std::max_align_t>::value;
+
+	/**
+	* This struct represents a free block in the node pool.
+	* Free blocks are chained into batches, and batches are chained in the central free list.
+	*/
+	struct pool_block
+	{
+		pool_block* next; ///< The next free block in the same batch, or null.
+		pool_block* next_batch; ///< The next batch in the central free list. Only meaningful for the first block of a batch.
+		std::size_t batch_count; ///< The number of blocks in the batch. Only meaningful for the first block of a batch.
+	};
+
+	/**
+	* This class implements the central free list of a size class.
+	* It is shared by all threads, and hands out blocks in batches to amortize the locking cost.
+	*/
+	class pool_central_list
+	{
+		std::mutex mutex;
+		pool_block* batches;
+		std::size_t block_size;
+		std::size_t batch_size;
+
+		pool_block* allocate_slab()
+		{
+			// slabs are never freed, so the padding needed to align them is simply lost.
+			auto memory = reinterpret_cast<std::uintptr_t>(::operator new(block_size * batch_size + node_pool_alignment - 1));
+			char* slab = reinterpret_cast<char*>((memory + node_pool_alignment - 1) / node_pool_alignment * node_pool_alignment);
+
+			for (std::size_t i = 0; i < batch_size - 1; i++)
+			{
+				reinterpret_cast<pool_block*>(slab + i * block_size)->next = reinterpret_cast<pool_block*>(slab + (i + 1) * block_size);
+			}
+
+			reinterpret_cast<pool_block*>(slab + (batch_size - 1) * block_size)->next = nullptr;
+
+			auto batch = reinterpret_cast<pool_block*>(slab);
+			batch->batch_count = batch_size;
+			return batch;
+		}
+	public:
+		/**
+		* Initializes a new empty central list.
+		* @param block_size The size in bytes of the blocks managed by this list.
+		* @param batch_size The number of blocks in a freshly allocated batch.
+		*/
+		pool_central_list(std::size_t block_size, std::size_t batch_size) WENDA_NOEXCEPT
+			: batches(nullptr), block_size(block_size), batch_size(batch_size)
+		{}
+
+		/**
+		* Takes a batch of free blocks from the list, allocating a new slab if the list is empty.
+		* @returns The first block of the batch. Its batch_count member is set to the length of the chain.
+		*/
+		pool_block* acquire_batch()
+		{
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+
+				if (batches)
+				{
+					auto batch = batches;
+					batches = batch->next_batch;
+					return batch;
+				}
+			}
+
+			return allocate_slab();
+		}
+
+		/**
+		* Returns a batch of free blocks to the list.
+		* @param batch The first block of a chain of free blocks.
+		* @param count The number of blocks in the chain.
+		*/
+		void release_batch(pool_block* batch, std::size_t count) WENDA_NOEXCEPT
+		{
+			batch->batch_count = count;
+
+			std::lock_guard<std::mutex> lock(mutex);
+			batch->next_batch = batches;
+			batches = batch;
+		}
+	};
+
+	/**
+	* This class implements the pool for blocks of a given size.
+	* All members are static: there is a single pool per size class in the process.
+	* @tparam BlockSize The size in bytes of the blocks. It must be a multiple of @ref node_pool_alignment,
+	* and at least the size of @ref pool_block.
+	*/
+	template<std::size_t BlockSize>
+	class node_pool_size_class
+	{
+		static_assert(BlockSize >= sizeof(pool_block), "Block size must be large enough to hold a free block.");
+		static_assert(BlockSize % node_pool_alignment == 0, "Block size must preserve the alignment of the blocks.");
+
+		static const std::size_t batch_size = 8192 / BlockSize < 16 ? 16 : 8192 / BlockSize;
+
+		/**
+		* The per-thread cache. It is trivially destructible so that it stays usable
+		* while the thread is being torn down.
+		*/
+		struct thread_cache
+		{
+			pool_block* head;
+			std::size_t count;
+			bool registered;
+			bool released;
+			thread_exit_callback exit; ///< Returns the cached blocks when the thread exits.
+		};
+
+		/**
+		* Returns the cached blocks of the thread to the central list when the thread exits.
+		*/
+		static void release_cache()
+		{
+			auto& cache = local_cache();
+
+			if (cache.head)
+			{
+				central().release_batch(cache.head, cache.count);
+			}
+
+			cache.head = nullptr;
+			cache.count = 0;
+			cache.released = true;
+		}
+
+		static pool_central_list& central() WENDA_NOEXCEPT
+		{
+			// intentionally leaked, so that nodes may still be released during static destruction.
+			return process_singleton<pool_central_list, node_pool_size_class>::get([]() { return new pool_central_list(BlockSize, batch_size); });
+		}
+
+		static thread_cache& local_cache() WENDA_NOEXCEPT
+		{
+			static WENDA_THREAD_LOCAL thread_cache cache = { nullptr, 0, false, false, { nullptr, nullptr } };
+			return cache;
+		}
+
+		static void register_cache(thread_cache& cache)
+		{
+			cache.exit.function = &release_cache;
+			at_thread_exit(cache.exit);
+			cache.registered = true;
+		}
+
+		static void* allocate_slow(thread_cache& cache)
+		{
+			if (cache.released)
+			{
+				// the thread is exiting, do not repopulate the cache.
+				auto batch = central().acquire_batch();
+
+				if (batch->next)
+				{
+					central().release_batch(batch->next, batch->batch_count - 1);
+				}
+
+				return batch;
+			}
+
+			if (!cache.registered)
+			{
+				register_cache(cache);
+			}
+
+			auto batch = central().acquire_batch();
+			cache.head = batch->next;
+			cache.count = batch->batch_count - 1;
+			return batch;
+		}
+
+		static void deallocate_slow(thread_cache& cache, pool_block* block) WENDA_NOEXCEPT
+		{
+			if (cache.released)
+			{
+				block->next = nullptr;
+				central().release_batch(block, 1);
+				return;
+			}
+
+			// keep one batch in the cache, hand the other one back to the central list.
+			auto batch = cache.head;
+			auto last = batch;
+
+			for (std::size_t i = 1; i < batch_size; i++)
+			{
+				last = last->next;
+			}
+
+			cache.head = last->next;
+			cache.count -= batch_size;
+			last->next = nullptr;
+
+			central().release_batch(batch, batch_size);
+
+			block->next = cache.head;
+			cache.head = block;
+			cache.count++;
+		}
+	public:
+		/**
+		* Allocates a block of @p BlockSize bytes from the pool.
+		* @returns A pointer to uninitialized memory, suitably aligned for any fundamental type.
+		*/
+		static void* allocate()
+		{
+			auto& cache = local_cache();
+
+			if (!cache.head)
+			{
+				return allocate_slow(cache);
+			}
+
+			auto block = cache.head;
+			cache.head = block->next;
+			cache.count--;
+			return block;
+		}
+
+		/**
+		* Returns a block to the pool. The block may have been allocated by any thread.
+		* @param pointer A pointer to a block previously obtained from allocate().
+		*/
+		static void deallocate(void* pointer) WENDA_NOEXCEPT
+		{
+			auto& cache = local_cache();
+			auto block = static_cast<pool_block*>(pointer);
+
+			if (!cache.registered)
+			{
+				register_cache(cache);
+			}
+
+			if (cache.count >= 2 * batch_size || cache.released)
+			{
+				deallocate_slow(cache, block);
+				return;
+			}
+
+			block->next = cache.head;
+			cache.head = block;
+			cache.count++;
+		}
+	};
+
+	/**
+	* Computes the size class used to allocate objects of type @p T from the node pool.
+	*/
+	template<typename T>
+	struct node_pool_block_size
+	{
+		static const std::size_t minimum_size = sizeof(T) < sizeof(pool_block) ? sizeof(pool_block) : sizeof(T);
+		static const std::size_t value = (minimum_size + node_pool_alignment - 1) / node_pool_alignment * node_pool_alignment;
+	};
+
+	/**
+	* Determines whether objects of type @p T are allocated from the node pool,
+	* or fall back to the global heap.
+	*/
+	template<typename T>
+	struct is_node_pool_allocated
+		: std::integral_constant<bool,
+		    sizeof(T) <= 256 && std::alignment_of<T>::value <= std::alignment_of<std::max_align_t>::value>
+	{};
+}
+
+/**
+* This class implements a standard allocator that allocates single objects from the node pool.
+* Requests for arrays, or for types too large or over-aligned for the pool, are forwarded to the global heap.
+* The allocator is stateless, and all instances compare equal.
+* @tparam T The type of the objects to allocate.
+*/
+template<typename T>
+class node_pool_allocator
+{
+	typedef detail::node_pool_size_class<detail::node_pool_block_size<T>::value> size_class;
+public:
+	typedef T value_type;
+	typedef T* pointer;
+	typedef T const* const_pointer;
+	typedef std::size_t size_type;
+	typedef std::ptrdiff_t difference_type;
+
+	template<typename U>
+	struct rebind
+	{
+		typedef node_pool_allocator<U> other;
+	};
+
+	node_pool_allocator() WENDA_NOEXCEPT
+	{}
+
+	template<typename U>
+	node_pool_allocator(node_pool_allocator<U> const&) WENDA_NOEXCEPT
+	{}
+
+	/**
+	* Allocates uninitialized storage for @p count objects of type @p T.
+	*/
+	T* allocate(std::size_t count)
+	{
+		if (count == 1 && detail::is_node_pool_allocated<T>::value)
+		{
+			return static_cast<T*>(size_class::allocate());
+		}
+
+		return static_cast<T*>(::operator new(count * sizeof(T)));
+	}
+
+	/**
+	* Releases the storage pointed to by @p pointer, which must have been obtained
+	* from allocate() with the same @p count.
+	*/
+	void deallocate(T* pointer, std::size_t count) WENDA_NOEXCEPT
+	{
+		if (count == 1 && detail::is_node_pool_allocated<T>::value)
+		{
+			size_class::deallocate(pointer);
+			return;
+		}
+
+		::operator delete(pointer);
+	}
+};
+
+template<typename T, typename U>
+bool operator==(node_pool_allocator<T> const&, node_pool_allocator<U> const&) WENDA_NOEXCEPT
+{
+	return true;
+}
+
+template<typename T, typename U>
+bool operator!=(node_pool_allocator<T> const&, node_pool_allocator<U> const&) WENDA_NOEXCEPT
+{
+	return false;
+}
+
+WENDA_FDS_NAMESPACE_END
+
+#endif // WENDA_FDS_NODE_POOL_H_INCLUDED
\ No newline at end of file
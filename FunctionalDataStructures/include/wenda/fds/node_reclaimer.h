@@ -0,0 +1,415 @@
+#ifndef WENDA_FDS_NODE_RECLAIMER_H_INCLUDED
+#define WENDA_FDS_NODE_RECLAIMER_H_INCLUDED
+
+#include "FDS_common.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+* @file node_reclaimer.h
+* This file implements the reclamation of the nodes of the persistent data structures.
+* Destroying a node releases the references it holds on its children, which may in turn destroy them.
+* Instead of recursing, nodes that die while another node is being destroyed on the same thread are
+* pushed to a worklist, which the outermost destruction drains. The depth of the call stack therefore
+* does not depend on the size of the released structure.
+* Reclamation may also be deferred: while a @ref deferred_reclamation_scope is active on a thread,
+* the nodes that die on that thread are queued to a @ref node_reclaimer instead, which destroys them
+* later, either within a given work budget or from a @ref background_reclaimer thread.
+*/
+
+WENDA_FDS_NAMESPACE_BEGIN
+
+class node_reclaimer;
+
+namespace detail
+{
+	/**
+	* This struct records a node that is no longer referenced, and must be destroyed.
+	*/
+	struct reclaim_entry
+	{
+		void const* node; ///< The node to destroy.
+		void(*destroy)(void const*); ///< Destroys the node and returns its memory.
+	};
+
+	/**
+	* Returns a reference to the reclaimer to which the nodes dying on the current thread are queued,
+	* or null if they are destroyed immediately.
+	*/
+	inline node_reclaimer*& current_node_reclaimer() WENDA_NOEXCEPT
+	{
+		static WENDA_THREAD_LOCAL node_reclaimer* reclaimer = nullptr;
+		return reclaimer;
+	}
+
+	/**
+	* This class implements the worklist of nodes waiting to be destroyed on a thread.
+	* The first entries are stored inline, which is enough for releasing balanced trees
+	* and lists, as the worklist only grows with the height of the released structure.
+	*/
+	class reclaim_worklist
+	{
+		static const std::size_t inline_capacity = 128;
+
+		reclaim_entry inline_entries[inline_capacity];
+		reclaim_entry* heap_entries; ///< The entries once they outgrow the inline storage, or null.
+		std::size_t heap_capacity;
+		std::size_t count;
+		bool active;
+
+		reclaim_entry* entries() WENDA_NOEXCEPT
+		{
+			return heap_entries ? heap_entries : inline_entries;
+		}
+
+		std::size_t capacity() const WENDA_NOEXCEPT
+		{
+			return heap_entries ? heap_capacity : inline_capacity;
+		}
+
+		bool grow() WENDA_NOEXCEPT
+		{
+			auto new_capacity = capacity() * 2;
+			auto new_entries = static_cast<reclaim_entry*>(std::malloc(new_capacity * sizeof(reclaim_entry)));
+
+			if (!new_entries)
+			{
+				return false;
+			}
+
+			std::memcpy(new_entries, entries(), count * sizeof(reclaim_entry));
+			std::free(heap_entries);
+
+			heap_entries = new_entries;
+			heap_capacity = new_capacity;
+			return true;
+		}
+	public:
+		/**
+		* The worklist is trivially constructible, so that it may be declared with @ref WENDA_THREAD_LOCAL:
+		* a zero-initialized worklist is empty.
+		*/
+		reclaim_worklist() = default;
+
+		reclaim_worklist(reclaim_worklist const&) = delete;
+		reclaim_worklist& operator=(reclaim_worklist const&) = delete;
+
+		/**
+		* Destroys the given node. If a node is already being destroyed on this thread,
+		* the node is only added to the worklist, and will be destroyed by the outermost call.
+		*/
+		void reclaim(reclaim_entry entry) WENDA_NOEXCEPT
+		{
+			if (active)
+			{
+				if (count < capacity() || grow())
+				{
+					entries()[count++] = entry;
+				}
+				else
+				{
+					// out of memory: fall back to recursive destruction.
+					entry.destroy(entry.node);
+				}
+
+				return;
+			}
+
+			active = true;
+			entry.destroy(entry.node);
+
+			while (count > 0)
+			{
+				entry = entries()[--count];
+				entry.destroy(entry.node);
+			}
+
+			std::free(heap_entries);
+			heap_entries = nullptr;
+			heap_capacity = 0;
+
+			active = false;
+		}
+	};
+
+	/**
+	* Returns the worklist of the current thread.
+	* The worklist does not own memory outside of a reclamation, so it needs no destruction at thread exit.
+	*/
+	inline reclaim_worklist& current_reclaim_worklist() WENDA_NOEXCEPT
+	{
+		static WENDA_THREAD_LOCAL reclaim_worklist worklist;
+		return worklist;
+	}
+
+	inline void reclaim_node(reclaim_entry entry) WENDA_NOEXCEPT;
+}
+
+/**
+* This class implements a queue of nodes whose destruction has been deferred.
+* Nodes are queued from any thread by a @ref deferred_reclamation_scope, and destroyed
+* by calls to reclaim(), or by a @ref background_reclaimer. It is thread-safe.
+*/
+class node_reclaimer
+{
+	mutable std::mutex mutex;
+	std::condition_variable available;
+	std::vector<detail::reclaim_entry> entries;
+
+	bool pop(detail::reclaim_entry& entry) WENDA_NOEXCEPT
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+
+		if (entries.empty())
+		{
+			return false;
+		}
+
+		entry = entries.back();
+		entries.pop_back();
+		return true;
+	}
+
+	/**
+	* Makes a reclaimer current on this thread, for the lifetime of the object.
+	*/
+	class current_scope
+	{
+		node_reclaimer* previous;
+	public:
+		explicit current_scope(node_reclaimer* reclaimer) WENDA_NOEXCEPT
+			: previous(detail::current_node_reclaimer())
+		{
+			detail::current_node_reclaimer() = reclaimer;
+		}
+
+		current_scope(current_scope const&) = delete;
+		current_scope& operator=(current_scope const&) = delete;
+
+		~current_scope()
+		{
+			detail::current_node_reclaimer() = previous;
+		}
+	};
+
+	friend class background_reclaimer;
+public:
+	node_reclaimer() = default;
+	node_reclaimer(node_reclaimer const&) = delete;
+	node_reclaimer& operator=(node_reclaimer const&) = delete;
+
+	/**
+	* Destroys all the nodes still waiting in the queue.
+	*/
+	~node_reclaimer()
+	{
+		reclaim();
+	}
+
+	/**
+	* Adds a node to the queue.
+	* If the queue cannot grow, the node is destroyed immediately.
+	*/
+	void defer(detail::reclaim_entry entry) WENDA_NOEXCEPT
+	{
+		bool queued = true;
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+
+			try
+			{
+				entries.push_back(entry);
+			}
+			catch (...)
+			{
+				queued = false;
+			}
+		}
+
+		if (!queued)
+		{
+			current_scope scope(nullptr);
+			detail::current_reclaim_worklist().reclaim(entry);
+			return;
+		}
+
+		available.notify_one();
+	}
+
+	/**
+	* Destroys at most @p budget nodes from the queue.
+	* The children of the destroyed nodes that are no longer referenced are queued in turn,
+	* so that the work done by a single call is bounded by @p budget.
+	* @returns The number of nodes that were destroyed.
+	*/
+	std::size_t reclaim(std::size_t budget)
+	{
+		current_scope scope(this);
+		std::size_t destroyed = 0;
+		detail::reclaim_entry entry;
+
+		while (destroyed < budget && pop(entry))
+		{
+			entry.destroy(entry.node);
+			destroyed++;
+		}
+
+		return destroyed;
+	}
+
+	/**
+	* Destroys all the nodes in the queue, and the nodes they release in turn.
+	* @returns The number of nodes taken from the queue.
+	*/
+	std::size_t reclaim()
+	{
+		current_scope scope(nullptr);
+		std::size_t destroyed = 0;
+		detail::reclaim_entry entry;
+
+		while (pop(entry))
+		{
+			detail::current_reclaim_worklist().reclaim(entry);
+			destroyed++;
+		}
+
+		return destroyed;
+	}
+
+	/**
+	* Returns the number of nodes waiting in the queue.
+	*/
+	std::size_t pending() const
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		return entries.size();
+	}
+};
+
+/**
+* This class implements a scope during which the nodes dying on the current thread are
+* queued to a @ref node_reclaimer instead of being destroyed immediately.
+* As queued nodes may be destroyed by any thread, only nodes with a thread-safe reference counting policy are queued:
+* nodes using @ref nonatomic_refcount_policy are still destroyed immediately.
+* Scopes may be nested, in which case the innermost scope is used.
+*/
+class deferred_reclamation_scope
+{
+	node_reclaimer* previous;
+public:
+	/**
+	* Initializes a new scope, queuing the nodes dying on this thread to @p reclaimer.
+	* The reclaimer must outlive the scope.
+	*/
+	explicit deferred_reclamation_scope(node_reclaimer& reclaimer) WENDA_NOEXCEPT
+		: previous(detail::current_node_reclaimer())
+	{
+		detail::current_node_reclaimer() = &reclaimer;
+	}
+
+	deferred_reclamation_scope(deferred_reclamation_scope const&) = delete;
+	deferred_reclamation_scope& operator=(deferred_reclamation_scope const&) = delete;
+
+	/**
+	* Restores the previous reclamation mode of the thread.
+	*/
+	~deferred_reclamation_scope()
+	{
+		detail::current_node_reclaimer() = previous;
+	}
+};
+
+/**
+* This class implements a thread destroying the nodes queued to its reclaimer as they arrive.
+*/
+class background_reclaimer
+{
+	node_reclaimer reclaimer;
+	std::atomic<bool> stopping;
+	std::thread thread;
+
+	void run()
+	{
+		for (;;)
+		{
+			{
+				std::unique_lock<std::mutex> lock(reclaimer.mutex);
+				reclaimer.available.wait(lock, [this]() { return !reclaimer.entries.empty() || stopping.load(); });
+
+				if (reclaimer.entries.empty())
+				{
+					return;
+				}
+			}
+
+			reclaimer.reclaim();
+		}
+	}
+public:
+	/**
+	* Starts the reclaimer thread.
+	*/
+	background_reclaimer()
+		: stopping(false)
+	{
+		thread = std::thread([this]() { run(); });
+	}
+
+	background_reclaimer(background_reclaimer const&) = delete;
+	background_reclaimer& operator=(background_reclaimer const&) = delete;
+
+	/**
+	* Stops the reclaimer thread, once all the queued nodes have been destroyed.
+	*/
+	~background_reclaimer()
+	{
+		{
+			std::lock_guard<std::mutex> lock(reclaimer.mutex);
+			stopping.store(true);
+		}
+
+		reclaimer.available.notify_one();
+		thread.join();
+	}
+
+	/**
+	* Returns the reclaimer whose queue is drained by this thread.
+	* Use it with a @ref deferred_reclamation_scope.
+	*/
+	node_reclaimer& get_reclaimer() WENDA_NOEXCEPT
+	{
+		return reclaimer;
+	}
+};
+
+namespace detail
+{
+	/**
+	* Destroys a node that is no longer referenced, or queues it to the current reclaimer.
+	*/
+	inline void reclaim_node(reclaim_entry entry) WENDA_NOEXCEPT
+	{
+		auto reclaimer = current_node_reclaimer();
+
+		if (reclaimer)
+		{
+			reclaimer->defer(entry);
+		}
+		else
+		{
+			current_reclaim_worklist().reclaim(entry);
+		}
+	}
+}
+
+WENDA_FDS_NAMESPACE_END
+
+#endif // WENDA_FDS_NODE_RECLAIMER_H_INCLUDED
\ No newline at end of file
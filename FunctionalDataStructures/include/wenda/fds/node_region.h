@@ -0,0 +1,281 @@
+#ifndef WENDA_FDS_NODE_REGION_H_INCLUDED
+#define WENDA_FDS_NODE_REGION_H_INCLUDED
+
+#include "FDS_common.h"
+
+#include <cassert>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "intrusive_ptr.h"
+
+/**
+* @file node_region.h
+* This file implements regions, from which the nodes of short-lived versions of the
+* persistent data structures can be allocated and released in bulk.
+* While a @ref region_scope is active on a thread, every node created on that thread is
+* placed in the region of the scope instead of being obtained from the allocator of its container.
+* Nodes in a region are not released individually: they carry a fixed reference bias, so that
+* dropping a version built in the scope does not cascade through its nodes. Instead, the region
+* destroys all its nodes in a single pass when the scope ends, which in turn releases the
+* references they hold on nodes from outside the region (for example from a long-lived base version).
+*/
+
+WENDA_FDS_NAMESPACE_BEGIN
+
+class node_region;
+
+namespace detail
+{
+	/**
+	* Returns a reference to the region in which the nodes created on the current thread are placed,
+	* or null if no @ref region_scope is active.
+	*/
+	inline node_region*& current_node_region() WENDA_NOEXCEPT
+	{
+		static WENDA_THREAD_LOCAL node_region* region = nullptr;
+		return region;
+	}
+
+	/**
+	* This struct records a node placed in a region. It immediately precedes the node in memory.
+	*/
+	struct region_entry
+	{
+		region_entry* previous; ///< The previously created node of the region, or null.
+		bool(*destroy)(void*); ///< Destroys the node if it is no longer referenced from outside the region.
+	};
+
+	/**
+	* This struct is the header of a chunk of memory owned by a region.
+	*/
+	struct region_chunk
+	{
+		region_chunk* previous; ///< The previously allocated chunk of the region, or null.
+	};
+}
+
+/**
+* This class implements a region holding the nodes of the persistent data structures.
+* Nodes are bump-allocated from large chunks, and are all destroyed together by release().
+* A region is not thread-safe: nodes may only be created in and released from the thread that owns it,
+* although they may be read (and referenced) from any thread while the region is alive.
+*/
+class node_region
+{
+	static const std::size_t alignment = std::alignment_of<std::max_align_t>::value;
+	static const std::size_t chunk_size = 64 * 1024;
+
+	static WENDA_CONSTEXPR std::size_t round_up(std::size_t size) WENDA_NOEXCEPT
+	{
+		return (size + alignment - 1) / alignment * alignment;
+	}
+
+	static const std::size_t entry_size = (sizeof(detail::region_entry) + alignment - 1) / alignment * alignment;
+	static const std::size_t chunk_header_size = (sizeof(detail::region_chunk) + alignment - 1) / alignment * alignment;
+
+	detail::region_chunk* chunks;
+	detail::region_entry* entries;
+	char* current;
+	char* end;
+	std::size_t count;
+
+	template<typename Node>
+	static bool destroy_entry(void* object) WENDA_NOEXCEPT
+	{
+		auto node = static_cast<Node*>(object);
+
+		if (reference_count(node) != reference_bias)
+		{
+			// still referenced from outside the region.
+			return false;
+		}
+
+		node->~Node();
+		return true;
+	}
+
+	void* allocate(std::size_t size)
+	{
+		size = round_up(size);
+
+		if (static_cast<std::size_t>(end - current) < size)
+		{
+			auto capacity = size > chunk_size - chunk_header_size ? size : chunk_size - chunk_header_size;
+			auto chunk = static_cast<detail::region_chunk*>(::operator new(chunk_header_size + capacity));
+
+			chunk->previous = chunks;
+			chunks = chunk;
+			current = reinterpret_cast<char*>(chunk) + chunk_header_size;
+			end = current + capacity;
+		}
+
+		auto memory = current;
+		current += size;
+		return memory;
+	}
+public:
+	/**
+	* The number of references added to every node placed in a region, so that
+	* their reference count never drops to zero while the region is alive.
+	*/
+	static const std::size_t reference_bias = std::size_t(1) << (sizeof(std::size_t) * 8 - 2);
+
+	/**
+	* Determines whether nodes of type @p Node can be placed in a region.
+	* Over-aligned nodes are always obtained from the allocator of their container.
+	*/
+	template<typename Node>
+	struct can_hold
+		: std::integral_constant<bool, std::alignment_of<Node>::value <= alignment>
+	{};
+
+	/**
+	* Initializes a new empty region.
+	*/
+	node_region() WENDA_NOEXCEPT
+		: chunks(nullptr), entries(nullptr), current(nullptr), end(nullptr), count(0)
+	{}
+
+	node_region(node_region const&) = delete;
+	node_region& operator=(node_region const&) = delete;
+
+	/**
+	* Releases all the nodes of the region.
+	* Escaped nodes are asserted against in debug builds. In release builds, they are kept alive along with
+	* the memory of the region, which is leaked; call release() beforehand to detect them.
+	*/
+	~node_region()
+	{
+		auto escaped = release();
+		assert(escaped == 0 && "nodes of a region must not be referenced after the region is released.");
+		(void)escaped;
+	}
+
+	/**
+	* Creates a node in the region.
+	* This is called by detail::allocate_node() when the region is active on the current thread.
+	* @param allocator The allocator to pass to the node. It is not used to allocate the node.
+	* @param args The remaining arguments to forward to the constructor of @p Node.
+	* @returns A pointer to the new node.
+	*/
+	template<typename Node, typename Allocator, typename... Args>
+	Node* construct(Allocator const& allocator, Args&&... args)
+	{
+		assert(can_hold<Node>::value);
+
+		auto entry = static_cast<detail::region_entry*>(allocate(entry_size + sizeof(Node)));
+		auto node = ::new (static_cast<void*>(reinterpret_cast<char*>(entry) + entry_size)) Node(allocator, std::forward<Args>(args)...);
+
+		add_reference(node, reference_bias);
+
+		entry->previous = entries;
+		entry->destroy = &destroy_entry<Node>;
+		entries = entry;
+		count++;
+
+		return node;
+	}
+
+	/**
+	* Returns the number of nodes currently held by the region.
+	*/
+	std::size_t node_count() const WENDA_NOEXCEPT
+	{
+		return count;
+	}
+
+	/**
+	* Destroys all the nodes of the region, and returns its memory.
+	* The nodes are destroyed from the most recent to the oldest. As a node can only refer to nodes
+	* that were created before it, every reference from within the region to a node has been released
+	* when that node is reached, and any remaining reference to it must come from outside the region.
+	* Such escaped nodes (and the nodes they refer to) are not destroyed, and the memory of the region
+	* is then kept alive for them.
+	* @returns The number of nodes that were still referenced from outside the region, which should be 0.
+	*/
+	std::size_t release() WENDA_NOEXCEPT
+	{
+		std::size_t escaped = 0;
+
+		for (auto entry = entries; entry;)
+		{
+			auto previous = entry->previous;
+
+			if (!entry->destroy(reinterpret_cast<char*>(entry) + entry_size))
+			{
+				escaped++;
+			}
+
+			entry = previous;
+		}
+
+		if (escaped == 0)
+		{
+			for (auto chunk = chunks; chunk;)
+			{
+				auto previous = chunk->previous;
+				::operator delete(chunk);
+				chunk = previous;
+			}
+		}
+
+		chunks = nullptr;
+		entries = nullptr;
+		current = nullptr;
+		end = nullptr;
+		count = 0;
+
+		return escaped;
+	}
+};
+
+/**
+* This class implements a scope during which all the nodes created on the current thread
+* are placed in a region, which is released when the scope ends.
+* Versions created during the scope must not outlive it. This is a hard precondition: a version that escapes
+* the scope is only asserted against in debug builds, and in release builds, leaks the memory of the region.
+* Code that cannot guarantee it may call get_region().release() before the scope ends, which destroys the nodes
+* and reports the number of escaped ones in all builds.
+* Scopes may be nested, in which case the innermost scope is used.
+*/
+class region_scope
+{
+	node_region region;
+	node_region* previous;
+public:
+	/**
+	* Initializes a new scope, and makes its region current on this thread.
+	*/
+	region_scope() WENDA_NOEXCEPT
+		: previous(detail::current_node_region())
+	{
+		detail::current_node_region() = &region;
+	}
+
+	region_scope(region_scope const&) = delete;
+	region_scope& operator=(region_scope const&) = delete;
+
+	/**
+	* Restores the previously active region, and releases all the nodes created during the scope.
+	*/
+	~region_scope()
+	{
+		assert(detail::current_node_region() == &region && "region scopes must be destroyed in reverse order of creation.");
+		detail::current_node_region() = previous;
+	}
+
+	/**
+	* Returns the region in which the nodes are placed during this scope.
+	*/
+	node_region& get_region() WENDA_NOEXCEPT
+	{
+		return region;
+	}
+};
+
+WENDA_FDS_NAMESPACE_END
+
+#endif // WENDA_FDS_NODE_REGION_H_INCLUDED
\ No newline at end of file
@@ -0,0 +1,231 @@
+#ifndef WENDA_FDS_NODE_TRAITS_H_INCLUDED
+#define WENDA_FDS_NODE_TRAITS_H_INCLUDED
+
+#include "FDS_common.h"
+
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "augmentation.h"
+#include "intrusive_ptr.h"
+#include "packed_ptr.h"
+#include "node_pool.h"
+#include "node_region.h"
+#include "node_reclaimer.h"
+
+/**
+* @file node_traits.h
+* This file implements the allocation of the nodes of the persistent data structures.
+* Every node remembers the allocator it was allocated with, so that it can be released
+* correctly whichever version of the data structure drops the last reference to it.
+*/
+
+WENDA_FDS_NAMESPACE_BEGIN
+
+namespace detail
+{
+	/**
+	* This struct bundles the compile-time options of the nodes of a persistent data structure.
+	* @tparam Allocator The allocator used to allocate the nodes. It is rebound to the node type
+	* when allocating, and a copy of it is stored in each node.
+	* @tparam RefCountPolicy The policy used to update the reference counts of the nodes.
+	* @tparam Augmentation The policy describing the value cached by the nodes of trees, see augmentation.h.
+	*/
+	template<typename Allocator, typename RefCountPolicy = default_refcount_policy, typename Augmentation = no_augmentation>
+	struct node_traits
+	{
+		typedef Allocator allocator_type; ///< The allocator used for the nodes.
+		typedef RefCountPolicy refcount_policy; ///< The reference counting policy of the nodes.
+		typedef basic_intrusive_refcount<RefCountPolicy> refcount_type; ///< The reference count base of the nodes.
+		typedef Augmentation augmentation_type; ///< The augmentation policy of the nodes.
+	};
+
+	/**
+	* The node traits used when no allocator is specified: nodes are allocated from the node pool.
+	*/
+	template<typename T>
+	using default_node_traits = node_traits<node_pool_allocator<T>>;
+
+	/**
+	* This class holds a copy of an allocator.
+	* Allocators that are empty and default constructible are not stored,
+	* so that nodes using them do not grow.
+	* @tparam Allocator The type of the allocator to hold.
+	*/
+	template<typename Allocator,
+		bool Stateless = std::is_empty<Allocator>::value && std::is_default_constructible<Allocator>::value>
+	class allocator_holder
+	{
+		Allocator allocator;
+	public:
+		explicit allocator_holder(Allocator const& allocator)
+			: allocator(allocator)
+		{}
+
+		allocator_holder(allocator_holder const& other)
+			: allocator(other.allocator)
+		{}
+
+		/**
+		* Replaces the held allocator by a copy of the allocator held by @p other.
+		* Allocators such as std::pmr::polymorphic_allocator are not assignable, but as
+		* every node remembers its own allocator, the holder may simply be rebuilt.
+		*/
+		allocator_holder& operator=(allocator_holder const& other) WENDA_NOEXCEPT
+		{
+			if (this != &other)
+			{
+				allocator.~Allocator();
+				::new (static_cast<void*>(std::addressof(allocator))) Allocator(other.allocator);
+			}
+
+			return *this;
+		}
+
+		/**
+		* Returns a copy of the held allocator.
+		*/
+		Allocator get_allocator() const WENDA_NOEXCEPT
+		{
+			return allocator;
+		}
+	};
+
+	template<typename Allocator>
+	class allocator_holder<Allocator, true>
+	{
+	public:
+		explicit allocator_holder(Allocator const&) WENDA_NOEXCEPT
+		{}
+
+		Allocator get_allocator() const WENDA_NOEXCEPT
+		{
+			return Allocator();
+		}
+	};
+
+	/**
+	* Allocates a new node with the given @p allocator, and constructs it from the given arguments.
+	* The allocator is passed as the first argument to the constructor of the node, which is expected
+	* to store it for destroy_node().
+	* If a @ref region_scope is active on the current thread, the node is placed in its region instead.
+	* @param allocator The allocator to use. It is rebound to @p Node.
+	* @param args The remaining arguments to forward to the constructor of @p Node.
+	* @returns A pointer to the newly created node.
+	*/
+	template<typename Node, typename Allocator, typename... Args>
+	Node* allocate_node(Allocator const& allocator, Args&&... args)
+	{
+		auto region = current_node_region();
+
+		if (region && node_region::can_hold<Node>::value)
+		{
+			return region->template construct<Node>(allocator, std::forward<Args>(args)...);
+		}
+
+		typedef typename std::allocator_traits<Allocator>::template rebind_alloc<Node> node_allocator;
+		typedef std::allocator_traits<node_allocator> node_allocator_traits;
+
+		node_allocator alloc(allocator);
+		Node* memory = node_allocator_traits::allocate(alloc, 1);
+
+		try
+		{
+			return ::new (static_cast<void*>(memory)) Node(allocator, std::forward<Args>(args)...);
+		}
+		catch (...)
+		{
+			node_allocator_traits::deallocate(alloc, memory, 1);
+			throw;
+		}
+	}
+
+	/**
+	* Immediately destroys a node created by allocate_node(), and returns its memory to the allocator
+	* that is stored in the node.
+	* @param pointer A pointer to the node to destroy.
+	*/
+	template<typename Node>
+	void destroy_node_now(void const* pointer) WENDA_NOEXCEPT
+	{
+		typedef typename Node::allocator_type allocator_type;
+		typedef typename std::allocator_traits<allocator_type>::template rebind_alloc<Node> node_allocator;
+		typedef std::allocator_traits<node_allocator> node_allocator_traits;
+
+		auto node = static_cast<Node const*>(pointer);
+		node_allocator alloc(node->get_allocator());
+
+		auto object = const_cast<Node*>(node);
+		object->~Node();
+
+		node_allocator_traits::deallocate(alloc, object, 1);
+	}
+
+	template<typename Node>
+	void destroy_node(Node const* node, std::true_type) WENDA_NOEXCEPT
+	{
+		reclaim_node(reclaim_entry{ node, &destroy_node_now<Node> });
+	}
+
+	template<typename Node>
+	void destroy_node(Node const* node, std::false_type) WENDA_NOEXCEPT
+	{
+		// a deferred node may be destroyed by another thread, which would then race on the counts of its children.
+		current_reclaim_worklist().reclaim(reclaim_entry{ node, &destroy_node_now<Node> });
+	}
+
+	/**
+	* Destroys a node created by allocate_node(), and returns its memory to the allocator
+	* that is stored in the node.
+	* The children released by the node are destroyed iteratively rather than recursively,
+	* and the destruction is deferred if a @ref deferred_reclamation_scope is active on this thread,
+	* unless the reference count of the node is not thread-safe.
+	* @param node A pointer to the node to destroy.
+	*/
+	template<typename Node>
+	void destroy_node(Node const* node) WENDA_NOEXCEPT
+	{
+		destroy_node(node, is_thread_safe_refcount_policy<typename Node::refcount_policy>());
+	}
+
+	/**
+	* Deleter for nodes created by allocate_node().
+	* It may be used as the deleter of both @ref intrusive_ptr and @ref intrusive_packed_ptr.
+	* @tparam Node The type of the node to delete.
+	*/
+	template<typename Node>
+	struct node_deleter
+	{
+		typedef typename std::decay<Node>::type deleted_type;
+
+		/**
+		* Destroys the node pointed to by @p pointer, and releases its memory.
+		*/
+		void operator()(deleted_type const* pointer) const
+		{
+			destroy_node(pointer);
+		}
+
+		/**
+		* Destroys the node pointed to by @p pointer, and releases its memory.
+		*/
+		void operator()(packed_ptr<deleted_type> const& pointer) const
+		{
+			destroy_node(pointer.get());
+		}
+
+		/**
+		* Destroys the node pointed to by @p pointer, and releases its memory.
+		*/
+		void operator()(packed_ptr<const deleted_type> const& pointer) const
+		{
+			destroy_node(pointer.get());
+		}
+	};
+}
+
+WENDA_FDS_NAMESPACE_END
+
+#endif // WENDA_FDS_NODE_TRAITS_H_INCLUDED
\ No newline at end of file
@@ -0,0 +1,55 @@
+#ifndef WENDA_FDS_PMR_H_INCLUDED
+#define WENDA_FDS_PMR_H_INCLUDED
+
+#include "FDS_common.h"
+
+/**
+* @file pmr.h
+* This file provides aliases of the persistent data structures using polymorphic allocators,
+* so that their nodes may be allocated from any std::pmr::memory_resource (for example a
+* std::pmr::monotonic_buffer_resource for short-lived trees).
+* The aliases are only available when the standard library provides <memory_resource>.
+*/
+
+#if defined(_MSVC_LANG) && _MSVC_LANG > __cplusplus
+#define WENDA_FDS_CPLUSPLUS _MSVC_LANG
+#else
+#define WENDA_FDS_CPLUSPLUS __cplusplus
+#endif
+
+#if defined(__has_include)
+#if __has_include(<memory_resource>) && WENDA_FDS_CPLUSPLUS >= 201703L
+#define WENDA_FDS_HAS_PMR 1
+#endif
+#endif
+
+#ifdef WENDA_FDS_HAS_PMR
+
+#include <functional>
+#include <memory_resource>
+
+#include "forward_list.h"
+#include "redblack_tree.h"
+
+WENDA_FDS_NAMESPACE_BEGIN
+
+namespace pmr
+{
+	/**
+	* A @ref wenda::fds::redblack_tree whose nodes are allocated from a std::pmr::memory_resource.
+	*/
+	template<typename T, typename Compare = std::less<>>
+	using redblack_tree = fds::redblack_tree<T, Compare, std::pmr::polymorphic_allocator<T>>;
+
+	/**
+	* A @ref wenda::fds::forward_list whose nodes are allocated from a std::pmr::memory_resource.
+	*/
+	template<typename T>
+	using forward_list = fds::forward_list<T, std::pmr::polymorphic_allocator<T>>;
+}
+
+WENDA_FDS_NAMESPACE_END
+
+#endif // WENDA_FDS_HAS_PMR
+
+#endif // WENDA_FDS_PMR_H_INCLUDED
\ No newline at end of file
@@ -0,0 +1,365 @@
+#ifndef WENDA_FDS_REDBLACK_MAP_H_INCLUDED
+#define WENDA_FDS_REDBLACK_MAP_H_INCLUDED
+
+#include "FDS_common.h"
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <tuple>
+#include <utility>
+
+#include "intrusive_ptr.h"
+#include "node_pool.h"
+#include "redblack_tree.h"
+#include "three_way_compare.h"
+
+/**
+* @file redblack_map.h
+* This file implements a persistent map, which stores key-value pairs in a red-black tree ordered by key.
+* Assigning a new value to an existing key copies the search path of the key with its colours,
+* as the shape of the tree does not change, and thus never needs any rebalancing.
+*/
+
+WENDA_FDS_NAMESPACE_BEGIN
+
+namespace detail
+{
+	template<bool ThreeWay>
+	struct map_three_way_tag
+	{};
+
+	template<>
+	struct map_three_way_tag<true>
+	{
+		typedef void is_three_way;
+	};
+
+	/**
+	* This class implements the comparison function of the elements of a @ref redblack_map, which compares them by key with @p Compare.
+	* It is transparent, so that elements may be compared directly with keys, and three-way if @p Compare is.
+	*/
+	template<typename K, typename V, typename Compare>
+	struct map_key_compare
+		: map_three_way_tag<is_three_way_compare<Compare>::value>
+	{
+		typedef void is_transparent;
+
+		template<typename U, typename W>
+		bool operator()(U const& left, W const& right) const
+		{
+			return Compare()(key_of(left), key_of(right));
+		}
+
+		template<typename U, typename W>
+		int compare(U const& left, W const& right) const
+		{
+			return three_way_order(Compare(), key_of(left), key_of(right));
+		}
+
+		static K const& key_of(std::pair<const K, V> const& element) WENDA_NOEXCEPT
+		{
+			return element.first;
+		}
+
+		template<typename U>
+		static U const& key_of(U const& key) WENDA_NOEXCEPT
+		{
+			return key;
+		}
+	};
+}
+
+/**
+* This class implements a functional map, associating values to keys.
+* The map is a @ref redblack_tree of key-value pairs, and every update returns a new map sharing most of its nodes with this one.
+* @tparam K The type of the keys.
+* @tparam V The type of the values.
+* @tparam Compare The comparison function of the keys. If it is transparent, the values may be looked up
+* by any key comparable with @p K. If it is three-way, see three_way_compare.h, lookups compare the keys once per node.
+* @tparam Allocator The allocator used to allocate the nodes of the map.
+* @tparam RefCountPolicy The policy used to update the reference counts of the nodes.
+*/
+template<typename K, typename V, typename Compare = std::less<>, typename Allocator = node_pool_allocator<std::pair<const K, V>>,
+	typename RefCountPolicy = default_refcount_policy>
+class redblack_map
+{
+public:
+	typedef K key_type; ///< The type of the keys.
+	typedef V mapped_type; ///< The type of the values.
+	typedef std::pair<const K, V> value_type; ///< The type of the elements of the map.
+	typedef Compare key_compare; ///< The comparison function of the keys.
+	typedef Allocator allocator_type; ///< The type of the allocator of the map.
+private:
+	typedef redblack_tree<value_type, detail::map_key_compare<K, V, Compare>, Allocator, RefCountPolicy> tree_type;
+	typedef typename tree_type::traits_type traits_type;
+	typedef detail::map_key_compare<K, V, Compare> compare_type;
+public:
+	typedef typename tree_type::iterator iterator; ///< The type of the iterator, visiting the elements in increasing order of keys.
+private:
+	tree_type tree; ///< The tree holding the elements of the map.
+
+	explicit redblack_map(tree_type tree) WENDA_NOEXCEPT
+		: tree(std::move(tree))
+	{}
+
+	redblack_map(detail::const_intrusive_rb_ptr<value_type, traits_type>&& root, Allocator const& allocator)
+		: tree(detail::make_black(root.get()), allocator)
+	{}
+
+	template<typename U>
+	V const* find_key(U const& key) const
+	{
+		auto element = tree.find_ptr(key);
+		return element ? &element->second : nullptr;
+	}
+public:
+	/**
+	* Initializes a new empty map.
+	*/
+	redblack_map()
+	{}
+
+	/**
+	* Initializes a new empty map, whose nodes will be allocated with the given @p allocator.
+	*/
+	explicit redblack_map(Allocator const& allocator) WENDA_NOEXCEPT
+		: tree(allocator)
+	{}
+
+	/**
+	* Initializes a new map holding the key-value pairs of the given range.
+	* Of several pairs with equivalent keys, only the first one is kept.
+	* This constructor only participates in overload resolution if @p InputIterator is an iterator type.
+	*/
+	template<typename InputIterator, typename = typename std::iterator_traits<InputIterator>::iterator_category>
+	redblack_map(InputIterator first, InputIterator last, Allocator const& allocator = Allocator())
+		: tree(allocator)
+	{
+		typename tree_type::transient_type transient(tree);
+
+		for (; first != last; ++first)
+		{
+			transient.insert(value_type(*first));
+		}
+
+		tree = transient.persistent();
+	}
+
+	/**
+	* Returns a copy of the allocator used to allocate the nodes of the map.
+	*/
+	Allocator get_allocator() const WENDA_NOEXCEPT
+	{
+		return tree.get_allocator();
+	}
+
+	/**
+	* Returns a pointer to the value associated with @p key, or null if there is none.
+	* The pointer remains valid as long as any map sharing the element is alive.
+	*/
+	V const* find(K const& key) const
+	{
+		return find_key(key);
+	}
+
+	/**
+	* Returns a pointer to the value associated with the key equivalent to @p key, or null if there is none.
+	* This overload only participates in overload resolution if Compare::is_transparent is defined.
+	*/
+	template<typename U, typename C = Compare, typename = typename C::is_transparent>
+	V const* find(U const& key) const
+	{
+		return find_key(key);
+	}
+
+	/**
+	* Returns a value indicating whether a value is associated with @p key.
+	*/
+	bool contains(K const& key) const
+	{
+		return find_key(key) != nullptr;
+	}
+
+	/**
+	* Returns a value indicating whether a value is associated with the key equivalent to @p key.
+	* This overload only participates in overload resolution if Compare::is_transparent is defined.
+	*/
+	template<typename U, typename C = Compare, typename = typename C::is_transparent>
+	bool contains(U const& key) const
+	{
+		return find_key(key) != nullptr;
+	}
+
+	/**
+	* Returns a new map associating @p value to @p key, if no value is already associated with @p key.
+	* Otherwise, this map is returned, and nothing is allocated.
+	* @returns A tuple of the new map and a boolean indicating whether the value was inserted.
+	*/
+	template<typename M>
+	std::tuple<redblack_map, bool> insert(K const& key, M&& value) const
+	{
+		auto result = tree.try_emplace(key, key, std::forward<M>(value));
+		return std::make_tuple(redblack_map(std::move(std::get<0>(result))), std::get<2>(result));
+	}
+
+	/**
+	* Returns a new map associating @p value to @p key, replacing the value previously associated with @p key if any.
+	* Replacing a value only copies the search path of @p key, keeping the colours of its nodes, so that no rebalancing is needed.
+	* @returns A tuple of the new map and a boolean which is true if the value was inserted, and false if it replaced an existing value.
+	*/
+	template<typename M>
+	std::tuple<redblack_map, bool> insert_or_assign(K const& key, M&& value) const
+	{
+		typedef std::tuple<redblack_map, bool> return_t;
+
+		auto allocator = get_allocator();
+		detail::search_path<value_type, traits_type> path;
+		detail::find_path(path, tree.root.get(), key, compare_type());
+
+		if (path.found)
+		{
+			auto root = detail::replace_at(path, value_type(path.back()->get_data().first, std::forward<M>(value)), allocator);
+			return return_t(redblack_map(std::move(root), allocator), false);
+		}
+
+		detail::search_path<value_type, traits_type> inserted;
+		auto root = detail::insert_at(path, value_type(key, std::forward<M>(value)), allocator, inserted);
+		return return_t(redblack_map(std::move(root), allocator), true);
+	}
+
+	/**
+	* Returns a new map in which the value associated with @p key is replaced by the result of @p function.
+	* As for insert_or_assign(), only the search path of @p key is copied. If no value is associated with @p key,
+	* this map is returned, and nothing is allocated.
+	* @param key The key whose value to update.
+	* @param function The function computing the new value from the current one.
+	* @returns A tuple of the new map and a boolean indicating whether a value was associated with @p key.
+	*/
+	template<typename Function>
+	std::tuple<redblack_map, bool> update(K const& key, Function&& function) const
+	{
+		typedef std::tuple<redblack_map, bool> return_t;
+
+		detail::search_path<value_type, traits_type> path;
+		detail::find_path(path, tree.root.get(), key, compare_type());
+
+		if (!path.found)
+		{
+			return return_t(*this, false);
+		}
+
+		auto allocator = get_allocator();
+		auto const& element = path.back()->get_data();
+		auto root = detail::replace_at(path, value_type(element.first, function(element.second)), allocator);
+		return return_t(redblack_map(std::move(root), allocator), true);
+	}
+
+	/**
+	* Returns a new map in which no value is associated with @p key.
+	* @returns A tuple of the new map and a boolean indicating whether a value was removed. If none was,
+	* this map is returned.
+	*/
+	std::tuple<redblack_map, bool> erase(K const& key) const
+	{
+		auto result = tree.erase(key);
+		return std::make_tuple(redblack_map(std::move(std::get<0>(result))), std::get<1>(result));
+	}
+
+	/**
+	* Returns a new map in which no value is associated with the key equivalent to @p key.
+	* This overload only participates in overload resolution if Compare::is_transparent is defined.
+	*/
+	template<typename U, typename C = Compare, typename = typename C::is_transparent>
+	std::tuple<redblack_map, bool> erase(U const& key) const
+	{
+		auto result = tree.erase(key);
+		return std::make_tuple(redblack_map(std::move(std::get<0>(result))), std::get<1>(result));
+	}
+
+	/**
+	* Returns an iterator to the element of the map with the smallest key.
+	*/
+	iterator begin() const WENDA_NOEXCEPT
+	{
+		return tree.begin();
+	}
+
+	/**
+	* Returns the end iterator of the map.
+	*/
+	iterator end() const WENDA_NOEXCEPT
+	{
+		return tree.end();
+	}
+
+	/**
+	* Tests whether there are any elements in the map.
+	*/
+	bool empty() const WENDA_NOEXCEPT
+	{
+		return tree.empty();
+	}
+
+	/**
+	* Returns the number of elements in the map, in constant time.
+	*/
+	std::size_t size() const WENDA_NOEXCEPT
+	{
+		return tree.size();
+	}
+
+	/**
+	* Returns a value indicating whether this map and @p other share their root, in constant time.
+	* Updates that leave the map unchanged return a map sharing the root of this map.
+	*/
+	bool shares_root(redblack_map const& other) const WENDA_NOEXCEPT
+	{
+		return tree.shares_root(other.tree);
+	}
+
+	/**
+	* Reports the differences between this map and @p newer, in increasing order of keys.
+	* Subtrees shared by both maps are skipped, see redblack_tree::diff().
+	* @param newer The map to compare with this map.
+	* @param removed The function called with each element of this map whose key is not in @p newer.
+	* @param added The function called with each element of @p newer whose key is not in this map.
+	* @param changed The function called with the old and new elements of the keys whose value changed.
+	*/
+	template<typename Removed, typename Added, typename Changed>
+	void diff(redblack_map const& newer, Removed&& removed, Added&& added, Changed&& changed) const
+	{
+		tree.diff(newer.tree, std::forward<Removed>(removed), std::forward<Added>(added), std::forward<Changed>(changed));
+	}
+
+	/**
+	* Tests whether two maps hold equal elements. Subtrees shared by both maps are skipped.
+	*/
+	friend bool operator==(redblack_map const& left, redblack_map const& right)
+	{
+		return left.tree == right.tree;
+	}
+
+	/**
+	* Tests whether two maps hold different elements.
+	*/
+	friend bool operator!=(redblack_map const& left, redblack_map const& right)
+	{
+		return !(left == right);
+	}
+
+	/**
+	* Merges two versions @p left and @p right of the map, derived from the common version @p base, see redblack_tree::merge3().
+	* @param resolver The function called with pointers to the base, left and right elements of each key whose value was
+	* changed differently by both versions, which returns a pointer to the element to keep, or null to remove the key.
+	*/
+	template<typename Resolver>
+	friend redblack_map merge3(redblack_map const& base, redblack_map const& left, redblack_map const& right, Resolver&& resolver)
+	{
+		return redblack_map(merge3(base.tree, left.tree, right.tree, std::forward<Resolver>(resolver)));
+	}
+};
+
+WENDA_FDS_NAMESPACE_END
+
+#endif // WENDA_FDS_REDBLACK_MAP_H_INCLUDED
\ No newline at end of file
@@ -3,21 +3,37 @@
 
 #include "FDS_common.h"
 
+#include <algorithm>
 #include <functional>
 #include <utility>
 #include <iterator>
+#include <memory>
+#include <type_traits>
 #include <tuple>
+#include <vector>
 #include <cstdint>
 #include <cassert>
 
+#include "augmentation.h"
 #include "intrusive_ptr.h"
 #include "intrusive_packed_ptr.h"
+#include "iterator_range.h"
+#include "node_pool.h"
+#include "node_traits.h"
+#include "three_way_compare.h"
 
 #include "detail/redblack_tree_data.h"
 #include "detail/redblack_tree_balance.h"
+#include "detail/redblack_tree_build.h"
 #include "detail/redblack_tree_delete.h"
+#include "detail/redblack_tree_diff.h"
 #include "detail/redblack_tree_iterator.h"
+#include "detail/redblack_tree_join.h"
+#include "detail/redblack_tree_order.h"
+#include "detail/redblack_tree_parallel.h"
+#include "detail/redblack_tree_path.h"
 #include "detail/redblack_tree_reduce.h"
+#include "detail/redblack_tree_transient.h"
 
 /**
 * @file redblack_tree.h
@@ -30,59 +46,79 @@ namespace detail
 {
 	/**
 	* Implementation for the insertion algorithm for the red-black trees.
-	* This inserts the node at the correct position, and then rebalances the tree.
+	* The search path is recorded by find_path(), and the new leaf is then carried back up the path by insert_at(),
+	* copying and rebalancing each node once.
+	* If an equivalent element is already present, nothing is allocated and no reference count is updated.
 	* @param tree The node into which to insert the value.
-	* @param value The value to be inserted.
+	* @param key The key determining the insertion position. It is compared with the elements of the tree.
+	* @param make The function returning the value to insert, which must be equivalent to @p key.
+	* It is only called if no equivalent element is present.
 	* @param compare The comparison function to be used to define the insertion position.
 	* It must be compatible with the ordering of the tree.
-	* @returns A tuple containing a pointer to the new tree, a pointer to the inserted node, and a
-	* boolean indicating whether anything was inserted.
+	* @param allocator The allocator with which to allocate the new nodes.
+	* @param path Set to the path to the inserted node in the new tree, or to the equivalent node in @p tree,
+	* from which the returned iterators are built without searching the tree again.
+	* @returns A tuple containing a pointer to the new tree, which is null if nothing was inserted,
+	* and a boolean indicating whether anything was inserted.
 	*/
-	template<typename T, typename U, typename Compare>
-	std::tuple<const_intrusive_rb_ptr<T>, const_rb_pointer<T>, bool>
-		insert_impl(const_rb_pointer<T> tree, U&& value, Compare const& compare)
+	template<typename T, typename Traits, typename K, typename Factory, typename Compare>
+	std::tuple<const_intrusive_rb_ptr<T, Traits>, bool>
+		insert_impl(const_rb_pointer<T, Traits> tree, K const& key, Factory& make, Compare const& compare,
+		typename Traits::allocator_type const& allocator, search_path<T, Traits>& path)
 	{
-		typedef std::tuple<const_intrusive_rb_ptr<T>, const_rb_pointer<T>, bool> return_t;
-		using std::get;
+		typedef std::tuple<const_intrusive_rb_ptr<T, Traits>, bool> return_t;
 
-		if (!tree)
-		{
-			const_intrusive_rb_ptr<T> newTree(make_redblack_node<T>(std::forward<U>(value),
-				NodeColour::Red, make_null_redblack_node<T>(), make_null_redblack_node<T>()));
-			auto ptr = newTree.get();
-			return return_t(std::move(newTree), ptr, true);
-		}
-
-		const_intrusive_rb_ptr<T> newTree;
-		const_rb_pointer<T> iterator;
-		bool inserted;
+		search_path<T, Traits> search;
+		find_path(search, tree, key, compare);
 
-		if (compare(value, tree->get_data()))
-		{
-			std::tie(newTree, iterator, inserted) = insert_impl(tree->get_left().get(), std::forward<U>(value), compare);
-			auto balancedTree = balance(colour(tree), tree->get_data(), std::move(newTree), tree->get_right(), iterator);
-			return return_t(std::move(balancedTree), iterator, inserted);
-		}
-		else if (compare(tree->get_data(), value))
-		{
-			std::tie(newTree, iterator, inserted) = insert_impl(tree->get_right().get(), std::forward<U>(value), compare);
-			auto balancedTree = balance(colour(tree), tree->get_data(), tree->get_left(), std::move(newTree), iterator);
-			return return_t(std::move(balancedTree), iterator, inserted);
-		}
-		else
+		if (search.found)
 		{
-			return return_t(const_intrusive_rb_ptr<T>(tree), tree, false);
+			std::copy(search.nodes, search.nodes + search.depth, path.nodes);
+			path.depth = search.depth;
+			path.found = true;
+			return return_t(const_intrusive_rb_ptr<T, Traits>(), false);
 		}
+
+		auto newTree = insert_at(search, make(), allocator, path);
+		return return_t(std::move(newTree), true);
 	}
 }
 
+template<typename T, typename Compare, typename Allocator, typename RefCountPolicy, typename Augmentation>
+class redblack_tree_transient;
+
+template<typename K, typename V, typename Compare, typename Allocator, typename RefCountPolicy>
+class redblack_map;
+
+template<typename Container, typename Hash, typename KeyEqual>
+class intern_table;
+
+/**
+* Tag type indicating that a range passed to a constructor is already sorted.
+*/
+struct sorted_range_t
+{};
+
+/**
+* Tag value indicating that a range passed to a constructor is already sorted.
+*/
+const sorted_range_t sorted_range = sorted_range_t();
+
 /**
 * This class implements a functional red-black tree.
 * @tparam T The type of the elements stored in the tree.
 * @tparam Compare The comparison function to be used in the tree.
+* @tparam Allocator The allocator used to allocate the nodes of the tree. A copy of it is
+* stored in every node, so that nodes shared between versions are released correctly.
+* @tparam RefCountPolicy The policy used to update the reference counts of the nodes.
+* Use @ref nonatomic_refcount_policy for trees that are confined to a single thread.
+* @tparam Augmentation The policy describing a monoid whose value is cached in every node, see augmentation.h.
+* Trees with an augmentation compute aggregates over ranges of elements in O(log n), see aggregate().
 */
-template<typename T, typename Compare = std::less<> >
+template<typename T, typename Compare = std::less<>, typename Allocator = node_pool_allocator<T>,
+	typename RefCountPolicy = default_refcount_policy, typename Augmentation = no_augmentation>
 class redblack_tree
+	: private detail::allocator_holder<Allocator>
 {
 public:
 	/**
@@ -90,42 +126,184 @@ public:
 	*/
 	typedef T value_type;
 	/**
+	* This typedef represents the type of the allocator of the tree.
+	*/
+	typedef Allocator allocator_type;
+private:
+	typedef detail::node_traits<Allocator, RefCountPolicy, Augmentation> traits_type;
+	typedef detail::allocator_holder<Allocator> allocator_base;
+public:
+	/**
     * This typedef represents the type of the iterator.
 	*/
-	typedef detail::redblack_tree_iterator<T> iterator;
+	typedef detail::redblack_tree_iterator<T, traits_type> iterator;
+	/**
+	* This typedef represents the type of the iterator visiting the elements in decreasing order.
+	*/
+	typedef std::reverse_iterator<iterator> reverse_iterator;
+	/**
+	* This typedef represents the type of the transient tree, which may be used to modify the tree in place.
+	*/
+	typedef redblack_tree_transient<T, Compare, Allocator, RefCountPolicy, Augmentation> transient_type;
+	/**
+	* This alias template represents the type of a tree holding elements of type @p U, with the same options as this tree.
+	* As the augmentation is defined over the elements of this tree, the rebound tree is not augmented.
+	*/
+	template<typename U>
+	using rebind_tree = redblack_tree<U, Compare, typename std::allocator_traits<Allocator>::template rebind_alloc<U>, RefCountPolicy>;
 private:
-	detail::const_intrusive_rb_ptr<T> root; ///< The root of the tree
+	friend class redblack_tree_transient<T, Compare, Allocator, RefCountPolicy, Augmentation>;
+	template<typename, typename, typename, typename, typename> friend class redblack_tree;
+	template<typename, typename, typename, typename, typename> friend class redblack_map;
+	template<typename, typename, typename> friend class intern_table;
 
-	explicit redblack_tree(detail::const_intrusive_rb_ptr<T> const& root)
-		: root(root)
+	detail::const_intrusive_rb_ptr<T, traits_type> root; ///< The root of the tree
+
+	redblack_tree(detail::const_intrusive_rb_ptr<T, traits_type> const& root, Allocator const& allocator)
+		: allocator_base(allocator), root(root)
     {}
 
-	explicit redblack_tree(detail::const_intrusive_rb_ptr<T>&& root)
-		: root(std::move(root))
+	redblack_tree(detail::const_intrusive_rb_ptr<T, traits_type>&& root, Allocator const& allocator)
+		: allocator_base(allocator), root(std::move(root))
     {}
+
+	redblack_tree(detail::redblack_subtree<T, traits_type>&& tree, Allocator const& allocator)
+		: allocator_base(allocator), root(detail::make_black(std::move(tree.root)))
+	{}
+
+	/**
+	* Returns the pool on which to run the set operations, which must not be parallel
+	* if the reference counts cannot be updated from several threads.
+	*/
+	static task_pool* parallel_pool(task_pool& pool) WENDA_NOEXCEPT
+	{
+		return is_thread_safe_refcount_policy<RefCountPolicy>::value ? &pool : nullptr;
+	}
+
+	template<typename K>
+	std::tuple<redblack_tree, bool> erase_key(K const& key) const
+	{
+		typedef std::tuple<redblack_tree, bool> return_t;
+
+		auto allocator = get_allocator();
+		detail::const_intrusive_rb_ptr<T, traits_type> newRoot;
+		bool deleted;
+
+		std::tie(newRoot, deleted) = detail::find_delete_node<T, traits_type>(root.get(), key, Compare(), allocator);
+
+		if (!deleted)
+		{
+			return return_t(*this, false);
+		}
+
+		auto blackened = detail::make_black(newRoot);
+
+		return return_t(redblack_tree(std::move(blackened), allocator), deleted);
+	}
+
+	template<typename K>
+	static T construct_element(K const& key)
+	{
+		return T(key);
+	}
+
+	template<typename K, typename Arg, typename... Args>
+	static T construct_element(K const&, Arg&& arg, Args&&... args)
+	{
+		return T(std::forward<Arg>(arg), std::forward<Args>(args)...);
+	}
 public:
 	/**
     * Default constructor for the @ref redblack_tree.
     * Initializes a new empty tree.
 	*/
 	redblack_tree() WENDA_NOEXCEPT
-		: root(detail::make_null_redblack_node<T>())
+		: allocator_base(Allocator()), root(detail::make_null_redblack_node<T, traits_type>())
+	{}
+
+	/**
+	* Initializes a new empty tree, whose nodes will be allocated with the given @p allocator.
+	*/
+	explicit redblack_tree(Allocator const& allocator) WENDA_NOEXCEPT
+		: allocator_base(allocator), root(detail::make_null_redblack_node<T, traits_type>())
+	{}
+
+	/**
+	* Initializes a new tree holding the elements of the given sorted range, in linear time.
+	* Exactly one node is allocated per distinct element. Equivalent elements are allowed,
+	* in which case only the first of them is kept, as if the elements had been inserted in order.
+	* @param first The beginning of the range. Its elements must be sorted with respect to Compare.
+	* @param last The end of the range.
+	* @param allocator The allocator with which to allocate the nodes.
+	*/
+	template<typename ForwardIterator>
+	redblack_tree(sorted_range_t, ForwardIterator first, ForwardIterator last, Allocator const& allocator = Allocator())
+		: allocator_base(allocator), root(detail::build_sorted<T, traits_type>(first, last, Compare(), allocator))
 	{}
 
+	/**
+	* Initializes a new tree holding the elements of the given range.
+	* The elements are first copied and sorted, so that the tree is built in O(n log n) time
+	* but with a single allocation per distinct element. Of several equivalent elements,
+	* only the first one is kept, as if the elements had been inserted in order.
+	* This constructor only participates in overload resolution if @p InputIterator is an iterator type.
+	* @param first The beginning of the range.
+	* @param last The end of the range.
+	* @param allocator The allocator with which to allocate the nodes.
+	*/
+	template<typename InputIterator, typename = typename std::iterator_traits<InputIterator>::iterator_category>
+	redblack_tree(InputIterator first, InputIterator last, Allocator const& allocator = Allocator())
+		: allocator_base(allocator), root(detail::make_null_redblack_node<T, traits_type>())
+	{
+		std::vector<T> elements(first, last);
+		std::stable_sort(elements.begin(), elements.end(), Compare());
+
+		root = detail::build_sorted<T, traits_type>(std::make_move_iterator(elements.begin()),
+			std::make_move_iterator(elements.end()), Compare(), allocator);
+	}
+
 	/**
     * Copy constructor for @ref redblack_tree.
 	*/
-	redblack_tree(redblack_tree<T> const& other)
-		: root(other.root)
+	redblack_tree(redblack_tree const& other)
+		: allocator_base(other), root(other.root)
 	{}
 
 	/**
     * Move constructor for @ref redblack_tree.
 	*/
-	redblack_tree(redblack_tree<T>&& other) WENDA_NOEXCEPT
-		: root(std::move(other.root))
+	redblack_tree(redblack_tree&& other) WENDA_NOEXCEPT
+		: allocator_base(std::move(other)), root(std::move(other.root))
 	{}
 
+	/**
+	* Copy assignment operator for @ref redblack_tree.
+	*/
+	redblack_tree& operator=(redblack_tree const& other)
+	{
+		allocator_base::operator=(other);
+		root = other.root;
+		return *this;
+	}
+
+	/**
+	* Move assignment operator for @ref redblack_tree.
+	*/
+	redblack_tree& operator=(redblack_tree&& other) WENDA_NOEXCEPT
+	{
+		allocator_base::operator=(std::move(other));
+		root = std::move(other.root);
+		return *this;
+	}
+
+	/**
+	* Returns a copy of the allocator used to allocate the nodes of the tree.
+	*/
+	Allocator get_allocator() const WENDA_NOEXCEPT
+	{
+		return allocator_base::get_allocator();
+	}
+
 	/**
     * Finds the given value in the red-black tree, returning
     * an iterator to the value if it is found, if the element is
@@ -139,12 +317,128 @@ public:
 	*/
 	iterator find(T const& value) const WENDA_NOEXCEPT
 	{
-		if (root)
+		return detail::find_iterator<T, traits_type>(root.get(), value, Compare());
+	}
+
+	/**
+	* Finds the element equivalent to @p key, which is compared directly with the elements.
+	* This overload only participates in overload resolution if Compare::is_transparent is defined.
+	*/
+	template<typename K, typename C = Compare, typename = typename C::is_transparent>
+	iterator find(K const& key) const
+	{
+		return detail::find_iterator<T, traits_type>(root.get(), key, Compare());
+	}
+
+	/**
+	* Returns a pointer to the element equivalent to @p value, or null if there is none.
+	* This does not build the path of an iterator, and is the cheapest way to look up an element.
+	*/
+	T const* find_ptr(T const& value) const WENDA_NOEXCEPT
+	{
+		auto node = detail::find_node<T, traits_type>(root.get(), value, Compare());
+		return node ? std::addressof(node->get_data()) : nullptr;
+	}
+
+	/**
+	* Returns a pointer to the element equivalent to @p key, or null if there is none.
+	* This overload only participates in overload resolution if Compare::is_transparent is defined.
+	*/
+	template<typename K, typename C = Compare, typename = typename C::is_transparent>
+	T const* find_ptr(K const& key) const
+	{
+		auto node = detail::find_node<T, traits_type>(root.get(), key, Compare());
+		return node ? std::addressof(node->get_data()) : nullptr;
+	}
+
+	/**
+	* Tests whether the tree holds an element equivalent to @p value.
+	*/
+	bool contains(T const& value) const WENDA_NOEXCEPT
+	{
+		return detail::find_node<T, traits_type>(root.get(), value, Compare()) != nullptr;
+	}
+
+	/**
+	* Tests whether the tree holds an element equivalent to @p key.
+	* This overload only participates in overload resolution if Compare::is_transparent is defined.
+	*/
+	template<typename K, typename C = Compare, typename = typename C::is_transparent>
+	bool contains(K const& key) const
+	{
+		return detail::find_node<T, traits_type>(root.get(), key, Compare()) != nullptr;
+	}
+
+	/**
+	* Returns an iterator to the first element that is not less than @p value, in O(log n).
+	* Iterating from the returned iterator visits the following elements in order.
+	*/
+	iterator lower_bound(T const& value) const
+	{
+		return detail::lower_bound<T, traits_type>(root.get(), value, Compare());
+	}
+
+	/**
+	* Returns an iterator to the first element that is not less than @p key, in O(log n).
+	* This overload only participates in overload resolution if Compare::is_transparent is defined.
+	*/
+	template<typename K, typename C = Compare, typename = typename C::is_transparent>
+	iterator lower_bound(K const& key) const
+	{
+		return detail::lower_bound<T, traits_type>(root.get(), key, Compare());
+	}
+
+	/**
+	* Returns an iterator to the first element that is greater than @p value, in O(log n).
+	* Iterating from the returned iterator visits the following elements in order.
+	*/
+	iterator upper_bound(T const& value) const
+	{
+		return detail::upper_bound<T, traits_type>(root.get(), value, Compare());
+	}
+
+	/**
+	* Returns an iterator to the first element that is greater than @p key, in O(log n).
+	* This overload only participates in overload resolution if Compare::is_transparent is defined.
+	*/
+	template<typename K, typename C = Compare, typename = typename C::is_transparent>
+	iterator upper_bound(K const& key) const
+	{
+		return detail::upper_bound<T, traits_type>(root.get(), key, Compare());
+	}
+
+	/**
+	* Returns the range of the elements equivalent to @p value, as a pair of iterators, in O(log n).
+	* As elements are unique, the range holds at most one element.
+	*/
+	std::pair<iterator, iterator> equal_range(T const& value) const
+	{
+		return std::make_pair(lower_bound(value), upper_bound(value));
+	}
+
+	/**
+	* Returns the range of the elements equivalent to @p key, as a pair of iterators, in O(log n).
+	* This overload only participates in overload resolution if Compare::is_transparent is defined.
+	*/
+	template<typename K, typename C = Compare, typename = typename C::is_transparent>
+	std::pair<iterator, iterator> equal_range(K const& key) const
+	{
+		return std::make_pair(lower_bound(key), upper_bound(key));
+	}
+
+	/**
+	* Returns a view of the elements that are not less than @p lower and less than @p upper, in O(log n).
+	* The view may be iterated in order, and does not keep the elements alive: this tree must outlive it.
+	*/
+	template<typename U, typename V>
+	iterator_range<iterator> range(U const& lower, V const& upper) const
+	{
+		if (!Compare()(lower, upper))
 		{
-			return iterator(root->find(value, Compare()));
+			return iterator_range<iterator>(end(), end());
 		}
 
-		return end();
+		return iterator_range<iterator>(lower_bound(lower), lower_bound(upper));
 	}
 
 	/**
@@ -155,14 +449,7 @@ public:
 	*/
 	iterator begin() const WENDA_NOEXCEPT
 	{
-		if (root)
-		{
-		    return iterator(root.get(), true);
-		}
-		else
-		{
-			return iterator(detail::make_null_redblack_node<T>());
-		}
+		return iterator(root.get(), true);
 	}
 
 	/**
@@ -180,7 +467,7 @@ public:
 	*/
 	iterator end() const WENDA_NOEXCEPT
 	{
-		return iterator(detail::make_null_redblack_node<T>());
+		return iterator(root.get());
 	}
 
 	/**
@@ -192,6 +479,22 @@ public:
 		return end();
 	}
 
+	/**
+	* Returns a reverse iterator to the largest element in the tree.
+	*/
+	reverse_iterator rbegin() const WENDA_NOEXCEPT
+	{
+		return reverse_iterator(end());
+	}
+
+	/**
+	* Returns a reverse iterator one past the smallest element in the tree.
+	*/
+	reverse_iterator rend() const WENDA_NOEXCEPT
+	{
+		return reverse_iterator(begin());
+	}
+
 	/**
     * Tests whether there are any elements in the tree.
     * @returns True if the tree is empty; otherwise false.
@@ -206,6 +509,76 @@ public:
 		return false;
 	}
 
+	/**
+	* Returns a value indicating whether this tree and @p other share their root, in constant time.
+	* Trees sharing their root hold the same elements. Updates that leave the tree unchanged, such as inserting
+	* an element that is already present or erasing one that is not, return a tree sharing the root of this tree
+	* without allocating any node, so that callers may detect them with this function.
+	*/
+	bool shares_root(redblack_tree const& other) const WENDA_NOEXCEPT
+	{
+		return root.get().get() == other.root.get().get();
+	}
+
+	/**
+	* Returns the number of elements in the tree, in constant time.
+	*/
+	std::size_t size() const WENDA_NOEXCEPT
+	{
+		return detail::subtree_size(root);
+	}
+
+	/**
+	* Returns the number of elements in the tree that are less than @p value, in O(log n).
+	* This is the position at which @p value is, or would be, stored in the tree.
+	*/
+	template<typename U>
+	std::size_t rank(U const& value) const
+	{
+		return detail::rank<T, traits_type>(root.get(), value, Compare());
+	}
+
+	/**
+	* Returns the element at position @p index in the tree, in O(log n).
+	* @param index The position of the element, which must be less than size().
+	*/
+	T const& select(std::size_t index) const WENDA_NOEXCEPT
+	{
+		assert(index < size());
+		return detail::select<T, traits_type>(root.get(), index)->get_data();
+	}
+
+	/**
+	* Returns an iterator to the element at position @p index in the tree, in O(log n).
+	* This is the same iterator as advancing begin() @p index times.
+	* @param index The position of the element. If it is not less than size(), end() is returned.
+	*/
+	iterator nth(std::size_t index) const
+	{
+		if (index >= size())
+		{
+			return end();
+		}
+
+		return detail::select_iterator<T, traits_type>(root.get(), index);
+	}
+
+	/**
+	* Returns the number of elements in the tree that are not less than @p lower and less than @p upper, in O(log n).
+	*/
+	template<typename U, typename V>
+	std::size_t count_range(U const& lower, V const& upper) const
+	{
+		Compare compare;
+
+		if (!compare(lower, upper))
+		{
+			return 0;
+		}
+
+		return detail::rank<T, traits_type>(root.get(), upper, compare) - detail::rank<T, traits_type>(root.get(), lower, compare);
+	}
+
 	/**
     * Returns a new tree containing the given value.
     * This inserts the element into a new tree if it does not already exist, 
@@ -219,70 +592,554 @@ public:
     * - third, a boolean value that is true if a value has been inserted, and false if the value was already present.
 	*/
     template<typename U>
-	std::tuple<redblack_tree<T>, iterator, bool> insert(U&& value) const
+	std::tuple<redblack_tree, iterator, bool> insert(U&& value) const
 	{
-		typedef std::tuple<redblack_tree<T>, iterator, bool> return_t;
+		typedef std::tuple<redblack_tree, iterator, bool> return_t;
 
-		detail::const_intrusive_rb_ptr<T> newRoot;
-		detail::const_rb_pointer<T> element;
+		auto allocator = get_allocator();
+		detail::const_intrusive_rb_ptr<T, traits_type> newRoot;
+		detail::search_path<T, traits_type> path;
 		bool inserted;
 
-		std::tie(newRoot, element, inserted) = detail::insert_impl(root.get(), std::forward<U>(value), Compare());
+		auto make = [&]() -> U&& { return std::forward<U>(value); };
+		std::tie(newRoot, inserted) = detail::insert_impl<T, traits_type>(root.get(), value, make, Compare(), allocator, path);
+
+		if (!inserted)
+		{
+			return return_t(*this, detail::path_iterator(root.get(), path), false);
+		}
 
-		detail::const_intrusive_rb_ptr<T> blackened;
+		auto blackened = detail::make_black(newRoot.get());
+		auto position = detail::path_iterator(blackened.get(), path);
+		return return_t(redblack_tree(std::move(blackened), allocator), position, true);
+	}
 
-		blackened = detail::make_black(newRoot.get());
+	/**
+	* Returns a new tree containing an element equivalent to @p key, which is only constructed if
+	* no equivalent element is already present, in which case this tree is returned.
+	* The lookup compares @p key directly with the elements, so that no temporary element is created.
+	* @param key The key of the element to insert. It must be comparable with the elements by Compare.
+	* @param args The arguments from which to construct the element. If there are none, the element is constructed from @p key.
+	* The constructed element must be equivalent to @p key.
+	* @returns A tuple of the new tree, an iterator to the inserted or existing element, and a boolean
+	* that is true if an element has been inserted.
+	*/
+	template<typename K, typename... Args>
+	std::tuple<redblack_tree, iterator, bool> try_emplace(K const& key, Args&&... args) const
+	{
+		typedef std::tuple<redblack_tree, iterator, bool> return_t;
 
-		return return_t(redblack_tree<T>(std::move(blackened)), iterator(element), inserted);
+		auto allocator = get_allocator();
+		detail::const_intrusive_rb_ptr<T, traits_type> newRoot;
+		detail::search_path<T, traits_type> path;
+		bool inserted;
+
+		auto make = [&]() { return construct_element(key, std::forward<Args>(args)...); };
+		std::tie(newRoot, inserted) = detail::insert_impl<T, traits_type>(root.get(), key, make, Compare(), allocator, path);
+
+		if (!inserted)
+		{
+			return return_t(*this, detail::path_iterator(root.get(), path), false);
+		}
+
+		auto blackened = detail::make_black(newRoot.get());
+		auto position = detail::path_iterator(blackened.get(), path);
+		return return_t(redblack_tree(std::move(blackened), allocator), position, true);
 	}
 
 	/**
 	* Returns a new tree with the given value removed.
 	* This searches for a node which is equivalent to @p value as determined by the 
 	* strict weak ordering induced by Compare and removes it if it exists.
-	* If no equivalent node exist, nothing is done.
+	* If no equivalent node exist, this tree is returned, and no node is allocated.
 	* @param value The value to be deleted.
 	* @returns A tuple containing the tree as first element, and a bool indicating
 	* whether a node was deleted as the second element.
 	*/
+	std::tuple<redblack_tree, bool> erase(T const& value) const
+	{
+		return erase_key(value);
+	}
+
+	/**
+	* Returns a new tree with the element equivalent to @p key removed, if any.
+	* This overload only participates in overload resolution if Compare::is_transparent is defined.
+	*/
+	template<typename K, typename C = Compare, typename = typename C::is_transparent>
+	std::tuple<redblack_tree, bool> erase(K const& key) const
+	{
+		return erase_key(key);
+	}
+
+	/**
+	* Splits the tree around the given value, in O(log n).
+	* The subtrees on either side of the search path are shared with this tree.
+	* @param value The value around which to split.
+	* @returns A tuple holding the tree of the elements less than @p value, a boolean indicating
+	* whether an element equivalent to @p value was present, and the tree of the elements greater than @p value.
+	*/
 	template<typename U>
-	std::tuple<redblack_tree<T>, bool> erase(U&& value) const
+	std::tuple<redblack_tree, bool, redblack_tree> split(U const& value) const
 	{
-		typedef  std::tuple<redblack_tree<T>, bool> return_t;
+		typedef std::tuple<redblack_tree, bool, redblack_tree> return_t;
 
-		detail::const_intrusive_rb_ptr<T> newRoot;
-		bool deleted;
+		auto allocator = get_allocator();
+		detail::redblack_subtree<T, traits_type> less, greater;
+		detail::const_rb_pointer<T, traits_type> found;
 
-		std::tie(newRoot, deleted) = detail::find_delete_node(root.get(), std::forward<U>(value), Compare());
+		std::tie(less, found, greater) = detail::split(detail::make_subtree(root), value, Compare(), allocator);
 
-		auto blackened = detail::make_black(newRoot);
+		return return_t(redblack_tree(std::move(less), allocator), static_cast<bool>(found), redblack_tree(std::move(greater), allocator));
+	}
 
-		return return_t(redblack_tree<T>(std::move(blackened)), deleted);
+	/**
+	* Returns a tree holding the elements of @p left, @p value and the elements of @p right, in O(log n).
+	* Every element of @p left must be less than @p value, which must be less than every element of @p right.
+	* The nodes of the result are allocated with the allocator of @p left.
+	*/
+	template<typename U>
+	static redblack_tree join(redblack_tree const& left, U&& value, redblack_tree const& right)
+	{
+		auto allocator = left.get_allocator();
+		auto joined = detail::join<T, traits_type>(detail::make_subtree(left.root), std::forward<U>(value), detail::make_subtree(right.root), allocator);
+		return redblack_tree(std::move(joined), allocator);
+	}
+
+	/**
+	* Returns a tree holding the elements of @p left followed by the elements of @p right, in O(log n).
+	* Every element of @p left must be less than every element of @p right.
+	* The nodes of the result are allocated with the allocator of @p left.
+	*/
+	static redblack_tree join(redblack_tree const& left, redblack_tree const& right)
+	{
+		auto allocator = left.get_allocator();
+		auto joined = detail::join<T, traits_type>(detail::make_subtree(left.root), detail::make_subtree(right.root), allocator);
+		return redblack_tree(std::move(joined), allocator);
+	}
+
+	/**
+	* Returns the union of the given trees, in O(m log(n/m + 1)) for trees of sizes m <= n.
+	* Of two equivalent elements, the one of @p left is kept. Subtrees of either tree that do not
+	* need to change are shared with the result. Large trees are processed in parallel on @p pool.
+	*/
+	friend redblack_tree set_union(redblack_tree const& left, redblack_tree const& right, task_pool& pool = task_pool::default_pool())
+	{
+		auto allocator = left.get_allocator();
+		auto result = detail::set_union(detail::make_subtree(left.root), detail::make_subtree(right.root), Compare(), allocator, parallel_pool(pool));
+		return redblack_tree(std::move(result), allocator);
+	}
+
+	/**
+	* Returns the intersection of the given trees, in O(m log(n/m + 1)) for trees of sizes m <= n.
+	* The elements of @p left are kept. Large trees are processed in parallel on @p pool.
+	*/
+	friend redblack_tree set_intersection(redblack_tree const& left, redblack_tree const& right, task_pool& pool = task_pool::default_pool())
+	{
+		auto allocator = left.get_allocator();
+		auto result = detail::set_intersection(detail::make_subtree(left.root), detail::make_subtree(right.root), Compare(), allocator, parallel_pool(pool));
+		return redblack_tree(std::move(result), allocator);
+	}
+
+	/**
+	* Returns the elements of @p left that have no equivalent in @p right, in O(m log(n/m + 1)) for trees of sizes m <= n.
+	* Large trees are processed in parallel on @p pool.
+	*/
+	friend redblack_tree set_difference(redblack_tree const& left, redblack_tree const& right, task_pool& pool = task_pool::default_pool())
+	{
+		auto allocator = left.get_allocator();
+		auto result = detail::set_difference(detail::make_subtree(left.root), detail::make_subtree(right.root), Compare(), allocator, parallel_pool(pool));
+		return redblack_tree(std::move(result), allocator);
+	}
+
+	/**
+	* Returns a transient tree holding the elements of this tree.
+	* The nodes of this tree remain shared, and are copied by the transient the first time it modifies them.
+	*/
+	transient_type transient() const
+	{
+		return transient_type(*this);
+	}
+
+	/**
+	* Returns a transient tree holding the elements of this tree, and leaves this tree empty.
+	* If this tree was the only version referencing its nodes, the transient modifies them in place.
+	*/
+	transient_type take_transient()
+	{
+		auto allocator = this->get_allocator();
+		transient_type result(std::move(*this));
+		*this = redblack_tree(allocator);
+		return result;
+	}
+
+	/**
+	* Reduces the tree in order, processing large subtrees in parallel on @p pool.
+	* Each subtree is folded with @p function starting from @p identity, as by reduce(), and the partial
+	* results of adjacent subtrees are then merged with @p combine. The functions may be called concurrently.
+	* @param function The function folding an element into a partial result.
+	* @param identity The neutral element of @p combine, which is returned if the tree is empty.
+	* @param combine The associative function merging two partial results.
+	* @param pool The pool on which to run the reduction.
+	*/
+	template<typename Function, typename Seed, typename Combine>
+	typename std::decay<Seed>::type parallel_reduce(Function&& function, Seed&& identity, Combine&& combine,
+		task_pool& pool = task_pool::default_pool()) const
+	{
+		typename std::decay<Seed>::type seed(std::forward<Seed>(identity));
+		return detail::parallel_reduce(detail::make_subtree(root), function, seed, combine, parallel_pool(pool));
+	}
+
+	/**
+	* Returns a tree holding the images of the elements of this tree by @p function, in O(n).
+	* The new tree has the same shape as this tree, so @p function must preserve the order of the elements.
+	* Large subtrees are processed in parallel on @p pool, and @p function may be called concurrently.
+	*/
+	template<typename Function, typename R = typename std::decay<decltype(std::declval<Function&>()(std::declval<T const&>()))>::type>
+	rebind_tree<R> map_values(Function&& function, task_pool& pool = task_pool::default_pool()) const
+	{
+		typedef rebind_tree<R> result_t;
+
+		typename result_t::allocator_type allocator(get_allocator());
+		auto mapped = detail::map_values<R, typename result_t::traits_type, T, traits_type>(root.get(),
+			detail::make_subtree(root).black_height, function, allocator, parallel_pool(pool));
+		return result_t(std::move(mapped), allocator);
+	}
+
+	/**
+	* Returns a tree holding the elements of this tree which satisfy @p predicate, in O(n).
+	* The result is balanced, and shares with this tree every subtree in which no element was removed.
+	* Large subtrees are processed in parallel on @p pool, and @p predicate may be called concurrently.
+	*/
+	template<typename Predicate>
+	redblack_tree filter(Predicate&& predicate, task_pool& pool = task_pool::default_pool()) const
+	{
+		auto allocator = get_allocator();
+		auto height = detail::make_subtree(root).black_height;
+		auto filtered = detail::filter<T, traits_type>(root.get(), height, predicate, allocator, parallel_pool(pool));
+		return redblack_tree(detail::filtered_subtree<T, traits_type>(std::move(filtered), root.get(), height), allocator);
 	}
 
 	/**
 	* Reduces the tree using the given @p function, starting with the given @p seed.
 	* This performs an in-order fold over the red-black tree.
 	* @param function The function to be used to reduce the tree.
-	* @param seed The seed to start of the reduction.
+	* @param seed The seed to start of the reduction. It is returned unchanged if the tree is empty.
 	*/
 	template<typename Function, typename Seed>
 	typename std::decay<Seed>::type reduce(Function&& function, Seed&& seed) const
 	{
+		if (!root)
+		{
+			return std::forward<Seed>(seed);
+		}
+
 		return detail::reduce(*root, std::forward<Function>(function), std::forward<Seed>(seed));
 	}
+
+	/**
+	* Reports the differences between this tree and @p newer, in increasing order.
+	* Subtrees shared by both trees are skipped, so that comparing versions derived from one another
+	* takes O(k log n) time for k differences, rather than walking both trees.
+	* @param newer The tree to compare with this tree.
+	* @param removed The function called with each element of this tree which has no equivalent in @p newer.
+	* @param added The function called with each element of @p newer which has no equivalent in this tree.
+	* @param changed The function called with the old and new elements which are equivalent, but not equal by operator==.
+	*/
+	template<typename Removed, typename Added, typename Changed>
+	void diff(redblack_tree const& newer, Removed&& removed, Added&& added, Changed&& changed) const
+	{
+		detail::diff_function_visitor<Removed, Added, Changed> visitor = { removed, added, changed };
+		detail::diff<T, traits_type>(root.get(), newer.root.get(), Compare(), visitor);
+	}
+
+	/**
+	* Tests whether two trees hold equal elements, as compared with operator==.
+	* Trees of different sizes are compared in constant time, and subtrees shared by both trees are skipped.
+	* Trees using @ref hash_augmentation with different hashes are compared in constant time, and their subtrees
+	* of equal hashes are compared with operator== only, even if they share no nodes. See also hash_equal().
+	*/
+	friend bool operator==(redblack_tree const& left, redblack_tree const& right)
+	{
+		if (left.size() != right.size() || detail::known_different(left.root.get().get(), right.root.get().get(), is_hash_augmentation<Augmentation>()))
+		{
+			return false;
+		}
+
+		detail::diff_equal_visitor visitor;
+		return detail::diff<T, traits_type>(left.root.get(), right.root.get(), Compare(), visitor);
+	}
+
+	/**
+	* Tests whether two trees hold different elements.
+	*/
+	friend bool operator!=(redblack_tree const& left, redblack_tree const& right)
+	{
+		return !(left == right);
+	}
+
+	/**
+	* Merges two versions @p left and @p right of the tree, derived from the common version @p base.
+	* The changes made by @p right are found with diff(), which skips the subtrees it shares with @p base, and are applied to @p left,
+	* whose other nodes are shared with the result. This takes O(k log n) time for k elements changed by @p right.
+	* @param resolver The function called as resolver(base, left, right) for each key changed differently by both versions.
+	* Its arguments are pointers to the elements of the key in each version, or null where the key is absent.
+	* It returns a pointer to the element to keep, which may be one of its arguments or any other element living until the
+	* call returns, or null to remove the key from the result.
+	*/
+	template<typename Resolver>
+	friend redblack_tree merge3(redblack_tree const& base, redblack_tree const& left, redblack_tree const& right, Resolver&& resolver)
+	{
+		if (left.shares_root(base))
+		{
+			return right;
+		}
+
+		if (right.shares_root(base) || right.shares_root(left))
+		{
+			return left;
+		}
+
+		std::vector<detail::version_change<T>> changes;
+		detail::diff_change_recorder<T> recorder = { changes };
+		detail::diff<T, traits_type>(base.root.get(), right.root.get(), Compare(), recorder);
+
+		auto merged = left.transient();
+		auto find = [&left](T const& element) { return left.find_ptr(element); };
+		auto apply = [&merged](T const* current, T const* target)
+		{
+			if (current)
+			{
+				merged.erase(*current);
+			}
+
+			if (target)
+			{
+				merged.insert(*target);
+			}
+		};
+
+		detail::merge_changes(changes, find, resolver, apply);
+		return merged.take_persistent();
+	}
+
+	/**
+	* Tests whether two trees using @ref hash_augmentation have equal sizes and hashes, in constant time.
+	* Unlike operator==, this is probabilistic: trees holding different elements may compare equal if their hashes collide.
+	*/
+	template<typename A = Augmentation>
+	bool hash_equal(redblack_tree const& other) const
+	{
+		static_assert(is_hash_augmentation<A>::value, "hash_equal() requires a tree using hash_augmentation.");
+		return size() == other.size() && aggregate() == other.aggregate();
+	}
+
+	/**
+	* Returns the combination by the augmentation policy of all the elements of the tree, in constant time.
+	* This is the value cached in the root, and is only available for augmented trees.
+	*/
+	template<typename A = Augmentation>
+	typename A::value_type aggregate() const
+	{
+		return detail::aggregate<T, traits_type>(root.get());
+	}
+
+	/**
+	* Returns the combination by the augmentation policy of the elements of the tree that are not less
+	* than @p lower and less than @p upper, in O(log n). This is only available for augmented trees.
+	*/
+	template<typename U, typename V, typename A = Augmentation>
+	typename A::value_type aggregate(U const& lower, V const& upper) const
+	{
+		return detail::aggregate_range<T, traits_type>(root.get(), lower, upper, Compare());
+	}
+};
+
+/**
+* This class implements a transient red-black tree, which is modified in place.
+* Nodes that are referenced only by the transient are modified directly, while nodes that are shared
+* with other versions are copied the first time the transient modifies them, so that the other versions
+* are never affected. This makes building or bulk-updating a tree about as cheap as with a mutable tree.
+* A transient may not be shared between threads, and is turned back into a persistent tree by persistent().
+*/
+template<typename T, typename Compare = std::less<>, typename Allocator = node_pool_allocator<T>,
+	typename RefCountPolicy = default_refcount_policy, typename Augmentation = no_augmentation>
+class redblack_tree_transient
+{
+public:
+	typedef redblack_tree<T, Compare, Allocator, RefCountPolicy, Augmentation> persistent_type; ///< The type of the persistent tree.
+	typedef typename persistent_type::iterator iterator; ///< The type of the iterator.
+private:
+	typedef typename persistent_type::traits_type traits_type;
+
+	persistent_type tree; ///< The current state of the tree. Its nodes may be modified in place.
+public:
+	/**
+	* Initializes a new empty transient tree.
+	*/
+	redblack_tree_transient() WENDA_NOEXCEPT
+	{}
+
+	/**
+	* Initializes a new transient tree from the elements of the given tree.
+	*/
+	explicit redblack_tree_transient(persistent_type tree) WENDA_NOEXCEPT
+		: tree(std::move(tree))
+	{}
+
+	redblack_tree_transient(redblack_tree_transient const&) = delete;
+	redblack_tree_transient& operator=(redblack_tree_transient const&) = delete;
+
+	/**
+	* Move constructor for @ref redblack_tree_transient.
+	*/
+	redblack_tree_transient(redblack_tree_transient&& other) WENDA_NOEXCEPT
+		: tree(std::move(other.tree))
+	{}
+
+	/**
+	* Move assignment operator for @ref redblack_tree_transient.
+	*/
+	redblack_tree_transient& operator=(redblack_tree_transient&& other) WENDA_NOEXCEPT
+	{
+		tree = std::move(other.tree);
+		return *this;
+	}
+
+	/**
+	* Inserts the given value in the tree, if no equivalent value is already present.
+	* @param value The value to insert.
+	* @returns True if the value was inserted, false if an equivalent value was already present.
+	*/
+	template<typename U>
+	bool insert(U&& value)
+	{
+		auto allocator = tree.get_allocator();
+		detail::const_rb_pointer<T, traits_type> element;
+
+		if (!detail::insert_transient<T, traits_type>(tree.root, std::forward<U>(value), Compare(), allocator, element))
+		{
+			return false;
+		}
+
+		detail::set_colour(tree.root, detail::NodeColour::Black);
+		return true;
+	}
+
+	/**
+	* Removes the value equivalent to @p value from the tree, if any.
+	* Erasing copies the path to the removed value, as for a persistent tree.
+	* @returns True if a value was removed.
+	*/
+	template<typename U>
+	bool erase(U&& value)
+	{
+		bool erased;
+		std::tie(tree, erased) = tree.erase(std::forward<U>(value));
+		return erased;
+	}
+
+	/**
+	* Finds the value equivalent to @p value in the tree.
+	* The iterator is invalidated by the next modification of the transient.
+	*/
+	iterator find(T const& value) const WENDA_NOEXCEPT
+	{
+		return tree.find(value);
+	}
+
+	/**
+	* Tests whether the tree holds an element equivalent to @p value.
+	*/
+	bool contains(T const& value) const WENDA_NOEXCEPT
+	{
+		return tree.contains(value);
+	}
+
+	/**
+	* Returns an iterator to the smallest element in the tree.
+	*/
+	iterator begin() const WENDA_NOEXCEPT
+	{
+		return tree.begin();
+	}
+
+	/**
+	* Returns an iterator one past the largest element in the tree.
+	*/
+	iterator end() const WENDA_NOEXCEPT
+	{
+		return tree.end();
+	}
+
+	/**
+	* Tests whether there are any elements in the tree.
+	*/
+	bool empty() const WENDA_NOEXCEPT
+	{
+		return tree.empty();
+	}
+
+	/**
+	* Returns the number of elements in the tree, in constant time.
+	*/
+	std::size_t size() const WENDA_NOEXCEPT
+	{
+		return tree.size();
+	}
+
+	/**
+	* Returns a persistent tree holding the current elements of the transient, in constant time.
+	* The transient remains usable: as the returned tree shares its nodes, the transient copies them
+	* again before modifying them.
+	*/
+	persistent_type persistent() const
+	{
+		return tree;
+	}
+
+	/**
+	* Returns a persistent tree holding the elements of the transient, in constant time, and leaves the transient empty.
+	*/
+	persistent_type take_persistent()
+	{
+		persistent_type result(std::move(tree));
+		tree = persistent_type(result.get_allocator());
+		return result;
+	}
 };
 
 /**
 * Reduces the given @p tree.
 * This forwards to the member function redblack_tree<T>::reduce().
 */
-template<typename T, typename Function, typename Seed>
-typename std::decay<Seed>::type reduce(redblack_tree<T> const& tree, Function&& function, Seed&& seed)
+template<typename T, typename Compare, typename Allocator, typename RefCountPolicy, typename Augmentation, typename Function, typename Seed>
+typename std::decay<Seed>::type reduce(redblack_tree<T, Compare, Allocator, RefCountPolicy, Augmentation> const& tree, Function&& function, Seed&& seed)
 {
 	return tree.reduce(std::forward<Function>(function), std::forward<Seed>(seed));
 }
 
+/**
+* Reports the differences between the trees @p older and @p newer.
+* This forwards to the member function redblack_tree<T>::diff().
+*/
+template<typename T, typename Compare, typename Allocator, typename RefCountPolicy, typename Augmentation, typename Removed, typename Added, typename Changed>
+void diff(redblack_tree<T, Compare, Allocator, RefCountPolicy, Augmentation> const& older, redblack_tree<T, Compare, Allocator, RefCountPolicy, Augmentation> const& newer,
+	Removed&& removed, Added&& added, Changed&& changed)
+{
+	older.diff(newer, std::forward<Removed>(removed), std::forward<Added>(added), std::forward<Changed>(changed));
+}
+
+/**
+* Reduces the given @p tree in parallel.
+* This forwards to the member function redblack_tree<T>::parallel_reduce().
+*/
+template<typename T, typename Compare, typename Allocator, typename RefCountPolicy, typename Augmentation, typename Function, typename Seed, typename Combine>
+typename std::decay<Seed>::type parallel_reduce(redblack_tree<T, Compare, Allocator, RefCountPolicy, Augmentation> const& tree, Function&& function, Seed&& identity,
+	Combine&& combine, task_pool& pool = task_pool::default_pool())
+{
+	return tree.parallel_reduce(std::forward<Function>(function), std::forward<Seed>(identity), std::forward<Combine>(combine), pool);
+}
+
 WENDA_FDS_NAMESPACE_END
 
 #endif // WENDA_FDS_REDBLACK_TREE_H_INCLUDED
\ No newline at end of file
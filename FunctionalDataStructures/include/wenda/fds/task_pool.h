@@ -0,0 +1,399 @@
+#ifndef WENDA_FDS_TASK_POOL_H_INCLUDED
+#define WENDA_FDS_TASK_POOL_H_INCLUDED
+
+#include "FDS_common.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "detail/thread_support.h"
+
+/**
+* @file task_pool.h
+* This file implements a work-stealing thread pool, used to run the bulk operations
+* of the persistent data structures in parallel.
+* The pool only supports fork-join parallelism through invoke(), which runs two functions
+* in parallel and returns once both have completed. The second function is queued to the deque
+* of the calling thread, from which idle workers steal it; if no worker took it by the time the first
+* function returns, the calling thread runs it itself. A thread waiting for a stolen function runs
+* other queued functions in the meantime, so that nested calls never block a worker.
+*/
+
+WENDA_FDS_NAMESPACE_BEGIN
+
+class task_pool;
+
+namespace detail
+{
+	/**
+	* This class represents a function queued to a @ref task_pool.
+	*/
+	class pool_task
+	{
+	protected:
+		std::atomic<bool> done;
+
+		pool_task() WENDA_NOEXCEPT
+			: done(false)
+		{}
+
+		~pool_task()
+		{}
+	public:
+		/**
+		* Runs the task. Exceptions are stored, to be rethrown by the thread that queued the task.
+		*/
+		virtual void execute() WENDA_NOEXCEPT = 0;
+
+		/**
+		* Returns a value indicating whether the task has been run.
+		*/
+		bool is_done() const WENDA_NOEXCEPT
+		{
+			return done.load(std::memory_order_acquire);
+		}
+	};
+
+	/**
+	* This class implements a task calling a function object.
+	*/
+	template<typename Function>
+	class function_task
+		: public pool_task
+	{
+		Function& function;
+		std::exception_ptr error;
+	public:
+		explicit function_task(Function& function) WENDA_NOEXCEPT
+			: function(function)
+		{}
+
+		void execute() WENDA_NOEXCEPT override
+		{
+			try
+			{
+				function();
+			}
+			catch (...)
+			{
+				error = std::current_exception();
+			}
+
+			done.store(true, std::memory_order_release);
+		}
+
+		/**
+		* Rethrows the exception thrown by the function, if any.
+		*/
+		void rethrow() const
+		{
+			if (error)
+			{
+				std::rethrow_exception(error);
+			}
+		}
+	};
+
+	/**
+	* This class implements the deque of tasks of a thread.
+	* The owner pushes and takes back tasks at the back, while thieves steal them from the front.
+	*/
+	class task_deque
+	{
+		std::mutex mutex;
+		std::deque<pool_task*> tasks;
+	public:
+		/**
+		* Adds a task to the back of the deque.
+		*/
+		void push(pool_task* task)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			tasks.push_back(task);
+		}
+
+		/**
+		* Removes the given task from the deque, if it has not been stolen yet.
+		* @returns True if the task was removed, and must be run by the caller.
+		*/
+		bool take(pool_task* task) WENDA_NOEXCEPT
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+
+			for (auto it = tasks.end(); it != tasks.begin();)
+			{
+				if (*--it == task)
+				{
+					tasks.erase(it);
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		/**
+		* Removes the oldest task of the deque.
+		* @returns The removed task, or null if the deque is empty.
+		*/
+		pool_task* steal() WENDA_NOEXCEPT
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+
+			if (tasks.empty())
+			{
+				return nullptr;
+			}
+
+			auto task = tasks.front();
+			tasks.pop_front();
+			return task;
+		}
+	};
+
+	/**
+	* This struct records the pool and index of the worker running on the current thread.
+	*/
+	struct pool_worker_identity
+	{
+		task_pool const* pool;
+		std::size_t index;
+	};
+
+	/**
+	* Returns the identity of the worker running on the current thread.
+	*/
+	inline pool_worker_identity& current_pool_worker() WENDA_NOEXCEPT
+	{
+		static WENDA_THREAD_LOCAL pool_worker_identity identity = { nullptr, 0 };
+		return identity;
+	}
+}
+
+/**
+* This class implements a pool of worker threads, which run functions queued by invoke().
+* Each worker owns a deque of tasks; the threads that are not workers of the pool share an additional deque.
+*/
+class task_pool
+{
+	std::vector<std::unique_ptr<detail::task_deque>> deques; ///< The deques of the workers, followed by the shared deque.
+	std::vector<std::thread> workers;
+
+	std::atomic<std::size_t> queued; ///< The number of tasks waiting in the deques.
+	std::atomic<std::size_t> sleeping; ///< The number of workers waiting for tasks.
+	std::atomic<bool> stopping;
+	std::mutex sleep_mutex;
+	std::condition_variable available;
+
+	std::size_t current_index() const WENDA_NOEXCEPT
+	{
+		auto const& identity = detail::current_pool_worker();
+		return identity.pool == this ? identity.index : workers.size();
+	}
+
+	detail::pool_task* find_task(std::size_t index) WENDA_NOEXCEPT
+	{
+		if (queued.load(std::memory_order_relaxed) == 0)
+		{
+			return nullptr;
+		}
+
+		for (std::size_t i = 0; i < deques.size(); i++)
+		{
+			auto task = deques[(index + i) % deques.size()]->steal();
+
+			if (task)
+			{
+				queued.fetch_sub(1, std::memory_order_relaxed);
+				return task;
+			}
+		}
+
+		return nullptr;
+	}
+
+	void run_worker(std::size_t index)
+	{
+		detail::current_pool_worker() = detail::pool_worker_identity{ this, index };
+
+		for (;;)
+		{
+			auto task = find_task(index);
+
+			if (task)
+			{
+				task->execute();
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock(sleep_mutex);
+			sleeping.fetch_add(1);
+			available.wait(lock, [this]() { return queued.load() != 0 || stopping.load(); });
+			sleeping.fetch_sub(1);
+
+			if (stopping.load())
+			{
+				return;
+			}
+		}
+	}
+
+	void notify() WENDA_NOEXCEPT
+	{
+		if (sleeping.load() != 0)
+		{
+			{
+				std::lock_guard<std::mutex> lock(sleep_mutex);
+			}
+
+			available.notify_one();
+		}
+	}
+public:
+	/**
+	* Starts a new pool with the given number of worker threads.
+	* A pool without workers runs the functions passed to invoke() sequentially.
+	*/
+	explicit task_pool(std::size_t worker_count)
+		: queued(0), sleeping(0), stopping(false)
+	{
+		for (std::size_t i = 0; i <= worker_count; i++)
+		{
+			deques.emplace_back(new detail::task_deque());
+		}
+
+		workers.reserve(worker_count);
+
+		for (std::size_t i = 0; i < worker_count; i++)
+		{
+			workers.emplace_back([this, i]() { run_worker(i); });
+		}
+	}
+
+	task_pool(task_pool const&) = delete;
+	task_pool& operator=(task_pool const&) = delete;
+
+	/**
+	* Stops the workers. No call to invoke() may be running.
+	*/
+	~task_pool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(sleep_mutex);
+			stopping.store(true);
+		}
+
+		available.notify_all();
+
+		for (auto& worker : workers)
+		{
+			worker.join();
+		}
+	}
+
+	/**
+	* Returns the pool used by the parallel operations of the data structures when none is given.
+	* It has one worker less than the number of hardware threads, as the calling thread also works.
+	* The pool is created on first use, through std::call_once, and is never destroyed.
+	*/
+	static task_pool& default_pool()
+	{
+		return detail::process_singleton<task_pool>::get([]()
+		{
+			return new task_pool(std::thread::hardware_concurrency() > 1 ? std::thread::hardware_concurrency() - 1 : 0);
+		});
+	}
+
+	/**
+	* Returns the number of worker threads of the pool.
+	*/
+	std::size_t worker_count() const WENDA_NOEXCEPT
+	{
+		return workers.size();
+	}
+
+	/**
+	* Runs the two given functions, possibly in parallel, and returns once both have completed.
+	* If a function throws, the exception is rethrown once both have completed.
+	* @param first The function run by the calling thread.
+	* @param second The function which may be run by a worker.
+	*/
+	template<typename First, typename Second>
+	void invoke(First&& first, Second&& second)
+	{
+		if (workers.empty())
+		{
+			first();
+			second();
+			return;
+		}
+
+		auto index = current_index();
+		auto& deque = *deques[index];
+		detail::function_task<typename std::remove_reference<Second>::type> task(second);
+
+		deque.push(&task);
+		queued.fetch_add(1);
+		notify();
+
+		std::exception_ptr error;
+
+		try
+		{
+			first();
+		}
+		catch (...)
+		{
+			error = std::current_exception();
+		}
+
+		if (deque.take(&task))
+		{
+			queued.fetch_sub(1, std::memory_order_relaxed);
+			task.execute();
+		}
+		else
+		{
+			while (!task.is_done())
+			{
+				auto other = find_task(index);
+
+				if (other)
+				{
+					other->execute();
+				}
+				else
+				{
+					std::this_thread::yield();
+				}
+			}
+		}
+
+		if (error)
+		{
+			std::rethrow_exception(error);
+		}
+
+		task.rethrow();
+	}
+};
+
+/**
+* Runs the two given functions in parallel on the default @ref task_pool, and returns once both have completed.
+*/
+template<typename First, typename Second>
+void parallel_invoke(First&& first, Second&& second)
+{
+	task_pool::default_pool().invoke(std::forward<First>(first), std::forward<Second>(second));
+}
+
+WENDA_FDS_NAMESPACE_END
+
+#endif // WENDA_FDS_TASK_POOL_H_INCLUDED
\ No newline at end of file
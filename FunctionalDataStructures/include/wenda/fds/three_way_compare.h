@@ -0,0 +1,184 @@
+#ifndef WENDA_FDS_THREE_WAY_COMPARE_H_INCLUDED
+#define WENDA_FDS_THREE_WAY_COMPARE_H_INCLUDED
+
+#include "FDS_common.h"
+
+#include <string>
+#include <type_traits>
+
+/**
+* @file three_way_compare.h
+* This file implements the support for three-way comparison functions.
+* A comparison function is three-way if it defines the nested type is_three_way, and a member function
+* compare(a, b) returning a negative value if a is less than b, zero if they are equivalent, and a positive value otherwise.
+* Its function call operator must still implement the corresponding strict weak ordering.
+* The lookups of the data structures branch on a single call to compare() per node with such a function,
+* where a two-way comparison function may need to be called twice.
+*/
+
+WENDA_FDS_NAMESPACE_BEGIN
+
+/**
+* Compares two strings, returning a negative value, zero or a positive value
+* if @p left is respectively less than, equal to or greater than @p right.
+*/
+template<typename CharT, typename CharTraits, typename Allocator>
+int three_way_compare(std::basic_string<CharT, CharTraits, Allocator> const& left,
+	std::basic_string<CharT, CharTraits, Allocator> const& right)
+{
+	return left.compare(right);
+}
+
+/**
+* Compares a string with a null-terminated string.
+*/
+template<typename CharT, typename CharTraits, typename Allocator>
+int three_way_compare(std::basic_string<CharT, CharTraits, Allocator> const& left, CharT const* right)
+{
+	return left.compare(right);
+}
+
+/**
+* Compares a null-terminated string with a string.
+*/
+template<typename CharT, typename CharTraits, typename Allocator>
+int three_way_compare(CharT const* left, std::basic_string<CharT, CharTraits, Allocator> const& right)
+{
+	auto order = right.compare(left);
+	return order < 0 ? 1 : (order > 0 ? -1 : 0);
+}
+
+/**
+* Compares two values with operator<, which is called twice if @p left is not less than @p right.
+* Overloads for other types may be declared in the namespace of the type, where they are found by argument-dependent lookup.
+*/
+template<typename U, typename V>
+int three_way_compare(U const& left, V const& right)
+{
+	return left < right ? -1 : (right < left ? 1 : 0);
+}
+
+/**
+* This class implements a three-way comparison function, ordering the values by operator<
+* and comparing them with three_way_compare().
+* The specialization for void is transparent, and compares values of any types.
+*/
+template<typename T = void>
+struct three_way_less
+{
+	typedef void is_three_way;
+
+	bool operator()(T const& left, T const& right) const
+	{
+		return left < right;
+	}
+
+	int compare(T const& left, T const& right) const
+	{
+		return three_way_compare(left, right);
+	}
+};
+
+template<>
+struct three_way_less<void>
+{
+	typedef void is_transparent;
+	typedef void is_three_way;
+
+	template<typename U, typename V>
+	bool operator()(U const& left, V const& right) const
+	{
+		return left < right;
+	}
+
+	template<typename U, typename V>
+	int compare(U const& left, V const& right) const
+	{
+		return three_way_compare(left, right);
+	}
+};
+
+namespace detail
+{
+	template<typename T>
+	struct always_void
+	{
+		typedef void type;
+	};
+}
+
+/**
+* Indicates whether the given comparison function is three-way, that is, whether it defines the nested type is_three_way.
+*/
+template<typename Compare, typename = void>
+struct is_three_way_compare
+	: std::false_type
+{};
+
+template<typename Compare>
+struct is_three_way_compare<Compare, typename detail::always_void<typename Compare::is_three_way>::type>
+	: std::true_type
+{};
+
+namespace detail
+{
+	template<typename Compare, typename U, typename V>
+	int three_way_order(Compare const& compare, U const& left, V const& right, std::true_type)
+	{
+		return compare.compare(left, right);
+	}
+
+	template<typename Compare, typename U, typename V>
+	int three_way_order(Compare const& compare, U const& left, V const& right, std::false_type)
+	{
+		return compare(left, right) ? -1 : (compare(right, left) ? 1 : 0);
+	}
+
+	/**
+	* Compares @p left with @p right, returning a negative value, zero or a positive value if @p left is respectively
+	* less than, equivalent to or greater than @p right. The comparison function is called once if it is three-way, and up to twice otherwise.
+	*/
+	template<typename Compare, typename U, typename V>
+	int three_way_order(Compare const& compare, U const& left, V const& right)
+	{
+		return three_way_order(compare, left, right, is_three_way_compare<Compare>());
+	}
+
+	template<typename Compare, typename U, typename V>
+	int search_order(Compare const& compare, U const& key, V const& element, std::true_type)
+	{
+		return compare.compare(key, element);
+	}
+
+	template<typename Compare, typename U, typename V>
+	int search_order(Compare const& compare, U const& key, V const& element, std::false_type)
+	{
+		return compare(key, element) ? -1 : 1;
+	}
+
+	/**
+	* Compares @p key with an element while descending a search path, with a single call to the comparison function.
+	* This returns zero if the key is equivalent to the element only for three-way comparison functions: with other functions,
+	* equivalent elements are reported as less than the key, and the descent must check the last such element with candidate_equivalent().
+	*/
+	template<typename Compare, typename U, typename V>
+	int search_order(Compare const& compare, U const& key, V const& element)
+	{
+		return search_order(compare, key, element, is_three_way_compare<Compare>());
+	}
+
+	/**
+	* Returns a value indicating whether the last element not greater than @p key on a search path,
+	* as reported by search_order(), is equivalent to @p key.
+	* This is always false for three-way comparison functions, as the descent already stopped at the equivalent element.
+	*/
+	template<typename Compare, typename U, typename V>
+	bool candidate_equivalent(Compare const& compare, U const& candidate, V const& key)
+	{
+		return !is_three_way_compare<Compare>::value && !compare(candidate, key);
+	}
+}
+
+WENDA_FDS_NAMESPACE_END
+
+#endif // WENDA_FDS_THREE_WAY_COMPARE_H_INCLUDED
\ No newline at end of file
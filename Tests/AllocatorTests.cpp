@@ -0,0 +1,166 @@
+#include "stdafx.h"
+#include <CppUnitTest.h>
+
+#include <wenda/fds/forward_list.h>
+#include <wenda/fds/redblack_tree.h>
+#include <wenda/fds/pmr.h>
+
+#include "counting_allocator.h"
+
+#include <cstddef>
+#include <memory>
+#include <tuple>
+#include <utility>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace WENDA_FDS_NAMESPACE;
+
+namespace tests
+{
+	TEST_CLASS(AllocatorTests)
+	{
+		TEST_METHOD(RedBlackTree_Allocates_Nodes_With_Allocator)
+		{
+			std::ptrdiff_t live = 0;
+
+			{
+				redblack_tree<int, std::less<>, counting_allocator<int>> tree{ counting_allocator<int>(&live) };
+
+				for (int i = 0; i < 100; i++)
+				{
+					tree = std::get<0>(tree.insert(i));
+				}
+
+				Assert::IsTrue(live >= 100);
+				Assert::IsTrue(tree.get_allocator() == counting_allocator<int>(&live));
+			}
+
+			Assert::AreEqual(std::ptrdiff_t(0), live);
+		}
+
+		TEST_METHOD(RedBlackTree_Shared_Versions_Release_All_Nodes)
+		{
+			std::ptrdiff_t live = 0;
+
+			{
+				typedef redblack_tree<int, std::less<>, counting_allocator<int>> tree_t;
+				tree_t first{ counting_allocator<int>(&live) };
+
+				for (int i = 0; i < 50; i += 2)
+				{
+					first = std::get<0>(first.insert(i));
+				}
+
+				auto second = first;
+
+				for (int i = 1; i < 50; i += 2)
+				{
+					second = std::get<0>(second.insert(i));
+				}
+
+				// release the original version first, the nodes it shares must stay alive.
+				first = tree_t(counting_allocator<int>(&live));
+
+				Assert::AreEqual(50, second.reduce([](int count, int) { return count + 1; }, 0));
+			}
+
+			Assert::AreEqual(std::ptrdiff_t(0), live);
+		}
+
+		TEST_METHOD(RedBlackTree_NoOp_Updates_Share_Root_Without_Allocating)
+		{
+			std::ptrdiff_t live = 0;
+
+			{
+				typedef redblack_tree<int, std::less<>, counting_allocator<int>> tree_t;
+				tree_t tree{ counting_allocator<int>(&live) };
+
+				for (int i = 0; i < 100; i += 2)
+				{
+					tree = std::get<0>(tree.insert(i));
+				}
+
+				auto allocated = live;
+
+				for (int i = 0; i < 100; i += 2)
+				{
+					auto inserted = tree_t(counting_allocator<int>(&live));
+					auto emplaced = inserted;
+					auto erased = inserted;
+					tree_t::iterator position;
+					bool changed;
+
+					std::tie(inserted, position, changed) = tree.insert(i);
+					Assert::IsFalse(changed);
+					Assert::IsTrue(inserted.shares_root(tree));
+					Assert::AreEqual(i, *position);
+
+					std::tie(emplaced, std::ignore, changed) = tree.try_emplace(i);
+					Assert::IsFalse(changed);
+					Assert::IsTrue(emplaced.shares_root(tree));
+
+					std::tie(erased, changed) = tree.erase(i + 1);
+					Assert::IsFalse(changed);
+					Assert::IsTrue(erased.shares_root(tree));
+				}
+
+				Assert::AreEqual(allocated, live);
+
+				auto updated = std::get<0>(tree.insert(1));
+				Assert::IsFalse(updated.shares_root(tree));
+			}
+
+			Assert::AreEqual(std::ptrdiff_t(0), live);
+		}
+
+		TEST_METHOD(ForwardList_Allocates_Nodes_With_Allocator)
+		{
+			std::ptrdiff_t live = 0;
+
+			{
+				forward_list<int, counting_allocator<int>> list{ counting_allocator<int>(&live) };
+				auto longer = list.push_front(1).push_front(2);
+
+				Assert::AreEqual(std::ptrdiff_t(2), live);
+
+				list = longer.push_front(3);
+				longer = list;
+
+				Assert::AreEqual(std::ptrdiff_t(3), live);
+				Assert::AreEqual(3, longer.front());
+			}
+
+			Assert::AreEqual(std::ptrdiff_t(0), live);
+		}
+
+#ifdef WENDA_FDS_HAS_PMR
+		TEST_METHOD(Pmr_RedBlackTree_Uses_Memory_Resource)
+		{
+			char buffer[65536];
+			std::pmr::monotonic_buffer_resource resource(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+
+			pmr::redblack_tree<int> tree{ std::pmr::polymorphic_allocator<int>(&resource) };
+
+			for (int i = 0; i < 20; i++)
+			{
+				tree = std::get<0>(tree.insert(i));
+			}
+
+			Assert::IsTrue(tree.get_allocator().resource() == &resource);
+			Assert::IsTrue(tree.find(10) != tree.end());
+		}
+
+		TEST_METHOD(Pmr_ForwardList_Uses_Memory_Resource)
+		{
+			char buffer[4096];
+			std::pmr::monotonic_buffer_resource resource(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+
+			pmr::forward_list<int> list{ std::pmr::polymorphic_allocator<int>(&resource) };
+			list = list.push_front(1).push_front(2);
+
+			Assert::IsTrue(list.get_allocator().resource() == &resource);
+			Assert::AreEqual(2, list.front());
+		}
+#endif
+	};
+}
\ No newline at end of file
@@ -0,0 +1,122 @@
+#include "stdafx.h"
+#include <CppUnitTest.h>
+
+#include <wenda/fds/epoch.h>
+#include <wenda/fds/redblack_tree.h>
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "counting_allocator.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace WENDA_FDS_NAMESPACE;
+
+namespace tests
+{
+	namespace
+	{
+		typedef redblack_tree<int, std::less<>, counting_allocator<int>> counted_tree;
+	}
+
+	TEST_CLASS(EpochTests)
+	{
+		TEST_METHOD(EpochPublished_Readers_See_Published_Version)
+		{
+			epoch_published<redblack_tree<int>> published;
+
+			published.publish(std::get<0>(published.get().insert(1)));
+
+			{
+				epoch_guard guard;
+				auto const& tree = published.load(guard);
+
+				Assert::IsTrue(tree.find(1) != tree.end());
+			}
+
+			auto snapshot = published.snapshot();
+			Assert::IsTrue(snapshot.find(1) != snapshot.end());
+		}
+
+		TEST_METHOD(EpochPublished_Defers_Release_Until_Readers_Leave)
+		{
+			std::ptrdiff_t live = 0;
+			epoch_published<counted_tree> published{ counted_tree(counting_allocator<int>(&live)) };
+
+			auto tree = published.get();
+
+			for (int i = 0; i < 100; i++)
+			{
+				tree = std::get<0>(tree.insert(i));
+			}
+
+			published.publish(tree);
+			tree = counted_tree(counting_allocator<int>(&live));
+			auto nodes = live;
+
+			{
+				epoch_guard guard;
+				auto const& read = published.load(guard);
+
+				published.publish(counted_tree(counting_allocator<int>(&live)));
+
+				for (int i = 0; i < 10; i++)
+				{
+					epoch_domain::instance().collect();
+				}
+
+				// the version read in the guard must stay alive.
+				Assert::AreEqual(nodes, live);
+				Assert::AreEqual(4950, read.reduce([](int sum, int value) { return sum + value; }, 0));
+			}
+
+			epoch_domain::instance().synchronize();
+			Assert::AreEqual(std::ptrdiff_t(0), live);
+		}
+
+		TEST_METHOD(EpochPublished_Concurrent_Readers_See_Consistent_Versions)
+		{
+			epoch_published<redblack_tree<int>> published;
+			std::atomic<bool> done(false);
+
+			auto read = [&]()
+			{
+				while (!done.load())
+				{
+					epoch_guard guard;
+					auto const& tree = published.load(guard);
+
+					// versions are built by inserting 0, 1, 2, ... in order.
+					int count = tree.reduce([](int count, int) { return count + 1; }, 0);
+					Assert::IsTrue(count == 0 || tree.find(count - 1) != tree.end());
+					Assert::IsTrue(tree.find(count) == tree.end());
+				}
+			};
+
+			std::vector<std::thread> readers;
+
+			for (int i = 0; i < 3; i++)
+			{
+				readers.emplace_back(read);
+			}
+
+			for (int i = 0; i < 2000; i++)
+			{
+				published.publish(std::get<0>(published.get().insert(i)));
+			}
+
+			done.store(true);
+
+			for (auto& reader : readers)
+			{
+				reader.join();
+			}
+
+			epoch_domain::instance().synchronize();
+			Assert::AreEqual(std::size_t(0), epoch_domain::instance().pending());
+		}
+	};
+}
\ No newline at end of file
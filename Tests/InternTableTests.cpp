@@ -0,0 +1,125 @@
+#include "stdafx.h"
+#include <CppUnitTest.h>
+
+#include <wenda/fds/intern_table.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "counting_allocator.h"
+#include "redblack_validation.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace WENDA_FDS_NAMESPACE;
+
+namespace tests
+{
+	TEST_CLASS(InternTableTests)
+	{
+		TEST_METHOD(InternTable_Shares_Independently_Built_Trees)
+		{
+			std::ptrdiff_t live = 0;
+
+			{
+				typedef redblack_tree<int, std::less<>, counting_allocator<int>> tree_t;
+				auto values = sorted_values(1000);
+
+				intern_table<tree_t> table;
+				std::vector<tree_t> trees;
+
+				for (int i = 0; i < 10; i++)
+				{
+					trees.push_back(table.intern(make_sorted_tree<tree_t>(1000, 0, 1, counting_allocator<int>(&live))));
+				}
+
+				Assert::AreEqual(std::ptrdiff_t(1000), live);
+				Assert::AreEqual(std::size_t(1000), table.size());
+
+				for (auto const& tree : trees)
+				{
+					Assert::IsTrue(tree.shares_root(trees[0]));
+					Assert::IsTrue(std::equal(values.begin(), values.end(), tree.begin()));
+				}
+			}
+
+			Assert::AreEqual(std::ptrdiff_t(0), live);
+		}
+
+		TEST_METHOD(InternTable_Shares_Subtrees_Of_Different_Trees)
+		{
+			auto values = sorted_values(1023);
+
+			intern_table<redblack_tree<int>> table;
+			auto first = table.intern(make_sorted_tree<redblack_tree<int>>(1023));
+
+			// the right subtree of the root of a perfect tree of 1023 elements holds the elements from 512 to 1022.
+			auto second = table.intern(make_sorted_tree<redblack_tree<int>>(511, 512));
+
+			Assert::AreEqual(std::size_t(1023), table.size());
+			Assert::AreEqual(std::size_t(511), second.size());
+			Assert::IsTrue(std::equal(values.begin() + 512, values.end(), second.begin()));
+		}
+
+		TEST_METHOD(InternTable_Interns_Derived_Versions_And_Collects_Unused_Nodes)
+		{
+			std::mt19937 random(29);
+			std::uniform_int_distribution<int> distribution(0, 5000);
+
+			intern_table<redblack_tree<int>> table;
+			redblack_tree<int> built, interned;
+
+			for (int i = 0; i < 2000; i++)
+			{
+				auto value = distribution(random);
+				std::tie(built, std::ignore, std::ignore) = built.insert(value);
+				interned = table.intern(std::get<0>(interned.insert(value)));
+			}
+
+			Assert::IsTrue(built == interned);
+			Assert::IsTrue(table.intern(built).shares_root(interned));
+
+			built = redblack_tree<int>();
+			table.collect();
+			Assert::AreEqual(interned.size(), table.size());
+
+			interned = redblack_tree<int>();
+			table.collect();
+			Assert::AreEqual(std::size_t(0), table.size());
+		}
+
+		TEST_METHOD(InternTable_Shares_Suffixes_Of_Lists)
+		{
+			std::ptrdiff_t live = 0;
+
+			{
+				typedef forward_list<int, counting_allocator<int>> list_t;
+				intern_table<list_t> table;
+
+				auto values = sorted_values(100);
+
+				auto first = table.intern(list_t(values.begin(), values.end(), counting_allocator<int>(&live)));
+				auto second = table.intern(list_t(values.begin() + 50, values.end(), counting_allocator<int>(&live)));
+				auto third = table.push_front(second, 49);
+
+				Assert::AreEqual(std::ptrdiff_t(100), live);
+				Assert::AreEqual(std::size_t(100), table.size());
+				Assert::IsTrue(std::next(first.begin(), 49) == third.begin());
+				Assert::IsTrue(std::equal(values.begin() + 49, values.end(), third.begin()));
+
+				auto other = table.push_front(second, -1);
+				Assert::AreEqual(std::ptrdiff_t(101), live);
+				Assert::AreEqual(-1, other.front());
+
+				first = list_t(counting_allocator<int>(&live));
+				other = list_t(counting_allocator<int>(&live));
+				table.collect();
+
+				Assert::AreEqual(std::size_t(51), table.size());
+				Assert::AreEqual(std::ptrdiff_t(51), live);
+			}
+
+			Assert::AreEqual(std::ptrdiff_t(0), live);
+		}
+	};
+}
\ No newline at end of file
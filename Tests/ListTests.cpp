@@ -2,6 +2,9 @@
 #include <CppUnitTest.h>
 
 #include <string>
+#include <vector>
+#include <sstream>
+#include <iterator>
 
 #include <wenda/fds/forward_list.h>
 
@@ -61,5 +64,34 @@ namespace tests
 			const forward_list<int> list;
 			Assert::IsTrue(++list.before_begin() == list.begin());
 		}
+
+		TEST_METHOD(ForwardList_Range_Constructor_Keeps_Order)
+		{
+			std::vector<int> values = { 1, 2, 3, 4 };
+			const forward_list<int> list(values.begin(), values.end());
+
+			Assert::IsTrue(std::vector<int>(list.begin(), list.end()) == values);
+		}
+
+		TEST_METHOD(ForwardList_Range_Constructor_Accepts_Input_Iterators)
+		{
+			std::istringstream stream("5 6 7");
+			const forward_list<int> list((std::istream_iterator<int>(stream)), std::istream_iterator<int>());
+
+			Assert::IsTrue(std::vector<int>(list.begin(), list.end()) == std::vector<int>({ 5, 6, 7 }));
+		}
+
+		TEST_METHOD(ForwardList_PrependRange_Shares_Tail)
+		{
+			std::vector<int> head = { 1, 2 };
+			std::vector<int> tail = { 3, 4 };
+			const forward_list<int> list(tail.begin(), tail.end());
+
+			auto prepended = list.prepend_range(head.begin(), head.end());
+
+			Assert::IsTrue(std::vector<int>(prepended.begin(), prepended.end()) == std::vector<int>({ 1, 2, 3, 4 }));
+			Assert::IsTrue(&*std::next(prepended.begin(), 2) == &list.front());
+			Assert::IsTrue(list.prepend_range(head.end(), head.end()).begin() == list.begin());
+		}
 	};
 }
\ No newline at end of file
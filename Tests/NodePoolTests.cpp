@@ -0,0 +1,156 @@
+#include "stdafx.h"
+#include <CppUnitTest.h>
+
+#include <wenda/fds/node_pool.h>
+#include <wenda/fds/forward_list.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace WENDA_FDS_NAMESPACE;
+
+namespace tests
+{
+	namespace
+	{
+		struct pool_test_node
+		{
+			void* pointers[3];
+			int value;
+		};
+
+		struct pool_odd_node
+		{
+			void* pointers[3];
+		};
+	}
+
+	TEST_CLASS(NodePoolTests)
+	{
+		TEST_METHOD(NodePoolAllocator_Reuses_Freed_Block)
+		{
+			node_pool_allocator<pool_test_node> allocator;
+
+			auto first = allocator.allocate(1);
+			allocator.deallocate(first, 1);
+			auto second = allocator.allocate(1);
+
+			Assert::IsTrue(first == second);
+
+			allocator.deallocate(second, 1);
+		}
+
+		TEST_METHOD(NodePoolAllocator_Returns_Distinct_Aligned_Blocks)
+		{
+			node_pool_allocator<pool_test_node> allocator;
+			std::vector<pool_test_node*> blocks;
+
+			for (int i = 0; i < 1000; i++)
+			{
+				auto block = allocator.allocate(1);
+				Assert::IsTrue(reinterpret_cast<std::uintptr_t>(block) % std::alignment_of<pool_test_node>::value == 0);
+
+				block->value = i;
+				blocks.push_back(block);
+			}
+
+			for (int i = 0; i < 1000; i++)
+			{
+				Assert::AreEqual(i, blocks[i]->value);
+				allocator.deallocate(blocks[i], 1);
+			}
+		}
+
+		TEST_METHOD(NodePoolAllocator_Aligns_Blocks_For_Any_Fundamental_Type)
+		{
+			node_pool_allocator<pool_odd_node> allocator;
+			std::vector<pool_odd_node*> blocks;
+
+			for (int i = 0; i < 1000; i++)
+			{
+				auto block = allocator.allocate(1);
+				Assert::IsTrue(reinterpret_cast<std::uintptr_t>(block) % std::alignment_of<std::max_align_t>::value == 0);
+				blocks.push_back(block);
+			}
+
+			for (auto block : blocks)
+			{
+				allocator.deallocate(block, 1);
+			}
+		}
+
+		TEST_METHOD(NodePoolAllocator_Can_Allocate_Arrays)
+		{
+			node_pool_allocator<pool_test_node> allocator;
+
+			auto array = allocator.allocate(10);
+			array[9].value = 5;
+
+			Assert::AreEqual(5, array[9].value);
+
+			allocator.deallocate(array, 10);
+		}
+
+		TEST_METHOD(NodePoolAllocator_Instances_Compare_Equal)
+		{
+			node_pool_allocator<pool_test_node> allocator;
+			node_pool_allocator<int> other;
+
+			Assert::IsTrue(allocator == other);
+			Assert::IsFalse(allocator != other);
+		}
+
+		TEST_METHOD(NodePool_Can_Free_Blocks_From_Another_Thread)
+		{
+			node_pool_allocator<pool_test_node> allocator;
+			std::vector<pool_test_node*> blocks;
+
+			for (int i = 0; i < 10000; i++)
+			{
+				blocks.push_back(allocator.allocate(1));
+			}
+
+			std::thread releaser([&]()
+			{
+				for (auto block : blocks)
+				{
+					allocator.deallocate(block, 1);
+				}
+			});
+
+			releaser.join();
+
+			for (int i = 0; i < 10000; i++)
+			{
+				blocks[i] = allocator.allocate(1);
+				blocks[i]->value = i;
+			}
+
+			for (int i = 0; i < 10000; i++)
+			{
+				Assert::AreEqual(i, blocks[i]->value);
+				allocator.deallocate(blocks[i], 1);
+			}
+		}
+
+		TEST_METHOD(ForwardList_Can_Be_Released_From_Another_Thread)
+		{
+			forward_list<int> list;
+
+			for (int i = 0; i < 1000; i++)
+			{
+				list = list.push_front(i);
+			}
+
+			std::thread releaser([](forward_list<int> list) { (void)list; }, std::move(list));
+			releaser.join();
+
+			list = forward_list<int>().push_front(5);
+
+			Assert::AreEqual(5, list.front());
+		}
+	};
+}
\ No newline at end of file
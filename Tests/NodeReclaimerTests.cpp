@@ -0,0 +1,137 @@
+#include "stdafx.h"
+#include <CppUnitTest.h>
+
+#include <wenda/fds/node_reclaimer.h>
+#include <wenda/fds/forward_list.h>
+#include <wenda/fds/redblack_tree.h>
+
+#include <cstddef>
+#include <functional>
+#include <tuple>
+
+#include "counting_allocator.h"
+#include "redblack_validation.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace WENDA_FDS_NAMESPACE;
+
+namespace tests
+{
+	namespace
+	{
+		typedef redblack_tree<int, std::less<>, counting_allocator<int>> counted_tree;
+	}
+
+	TEST_CLASS(NodeReclaimerTests)
+	{
+		TEST_METHOD(Releasing_Long_List_Does_Not_Recurse)
+		{
+			std::ptrdiff_t live = 0;
+
+			{
+				forward_list<int, counting_allocator<int>> list{ counting_allocator<int>(&live) };
+
+				for (int i = 0; i < 2000000; i++)
+				{
+					list = list.push_front(i);
+				}
+
+				Assert::AreEqual(std::ptrdiff_t(2000000), live);
+			}
+
+			Assert::AreEqual(std::ptrdiff_t(0), live);
+		}
+
+		TEST_METHOD(DeferredScope_Queues_Dead_Nodes)
+		{
+			std::ptrdiff_t live = 0;
+			node_reclaimer reclaimer;
+			auto tree = make_sorted_tree<counted_tree>(100, 0, 1, counting_allocator<int>(&live));
+			auto nodes = live;
+
+			{
+				deferred_reclamation_scope scope(reclaimer);
+				tree = counted_tree(counting_allocator<int>(&live));
+			}
+
+			Assert::AreEqual(nodes, live);
+			Assert::AreEqual(std::size_t(1), reclaimer.pending());
+
+			reclaimer.reclaim();
+
+			Assert::AreEqual(std::ptrdiff_t(0), live);
+			Assert::AreEqual(std::size_t(0), reclaimer.pending());
+		}
+
+		TEST_METHOD(DeferredScope_Destroys_NonAtomic_Nodes_Immediately)
+		{
+			typedef forward_list<int, counting_allocator<int>, nonatomic_refcount_policy> nonatomic_list;
+
+			std::ptrdiff_t live = 0;
+			node_reclaimer reclaimer;
+			nonatomic_list list{ counting_allocator<int>(&live) };
+
+			for (int i = 0; i < 100; i++)
+			{
+				list = list.push_front(i);
+			}
+
+			{
+				deferred_reclamation_scope scope(reclaimer);
+				list = nonatomic_list(counting_allocator<int>(&live));
+			}
+
+			// the reclaimer may be drained by another thread, which must not update non-atomic counts.
+			Assert::AreEqual(std::ptrdiff_t(0), live);
+			Assert::AreEqual(std::size_t(0), reclaimer.pending());
+		}
+
+		TEST_METHOD(NodeReclaimer_Respects_Budget)
+		{
+			std::ptrdiff_t live = 0;
+			node_reclaimer reclaimer;
+			auto tree = make_sorted_tree<counted_tree>(100, 0, 1, counting_allocator<int>(&live));
+			auto nodes = live;
+
+			{
+				deferred_reclamation_scope scope(reclaimer);
+				tree = counted_tree(counting_allocator<int>(&live));
+			}
+
+			Assert::AreEqual(std::size_t(10), reclaimer.reclaim(10));
+			Assert::AreEqual(nodes - 10, live);
+
+			while (reclaimer.reclaim(10) > 0)
+			{
+			}
+
+			Assert::AreEqual(std::ptrdiff_t(0), live);
+		}
+
+		TEST_METHOD(BackgroundReclaimer_Releases_Nodes)
+		{
+			std::ptrdiff_t live = 0;
+
+			{
+				background_reclaimer background;
+				auto tree = make_sorted_tree<counted_tree>(1000, 0, 1, counting_allocator<int>(&live));
+				auto copy = tree;
+
+				{
+					deferred_reclamation_scope scope(background.get_reclaimer());
+					tree = counted_tree(counting_allocator<int>(&live));
+				}
+
+				// shared nodes must survive the reclamation.
+				Assert::AreEqual(499500, copy.reduce(std::plus<int>(), 0));
+
+				{
+					deferred_reclamation_scope scope(background.get_reclaimer());
+					copy = counted_tree(counting_allocator<int>(&live));
+				}
+			}
+
+			Assert::AreEqual(std::ptrdiff_t(0), live);
+		}
+	};
+}
\ No newline at end of file
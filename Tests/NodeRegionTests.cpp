@@ -0,0 +1,138 @@
+#include "stdafx.h"
+#include <CppUnitTest.h>
+
+#include <wenda/fds/node_region.h>
+#include <wenda/fds/forward_list.h>
+#include <wenda/fds/redblack_tree.h>
+
+#include <cstddef>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+#include "counting_allocator.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace WENDA_FDS_NAMESPACE;
+
+namespace tests
+{
+	namespace
+	{
+		typedef redblack_tree<int, std::less<>, counting_allocator<int>> counted_tree;
+	}
+
+	TEST_CLASS(NodeRegionTests)
+	{
+		TEST_METHOD(RegionScope_Places_New_Nodes_In_Region)
+		{
+			std::ptrdiff_t live = 0;
+			counted_tree base{ counting_allocator<int>(&live) };
+			base = std::get<0>(base.insert(1));
+
+			auto base_nodes = live;
+
+			{
+				region_scope scope;
+
+				auto tree = std::get<0>(base.insert(2));
+				tree = std::get<0>(tree.insert(3));
+
+				Assert::AreEqual(base_nodes, live);
+				Assert::IsTrue(scope.get_region().node_count() > 0);
+				Assert::IsTrue(tree.find(1) != tree.end());
+				Assert::IsTrue(tree.find(3) != tree.end());
+			}
+
+			Assert::IsTrue(base.find(1) != base.end());
+			Assert::IsTrue(base.find(2) == base.end());
+		}
+
+		TEST_METHOD(RegionScope_Releases_References_To_Base_Nodes)
+		{
+			std::ptrdiff_t live = 0;
+
+			{
+				counted_tree base{ counting_allocator<int>(&live) };
+
+				for (int i = 0; i < 100; i += 2)
+				{
+					base = std::get<0>(base.insert(i));
+				}
+
+				{
+					region_scope scope;
+					std::vector<counted_tree> versions;
+
+					for (int i = 1; i < 100; i += 2)
+					{
+						versions.push_back(std::get<0>(base.insert(i)));
+					}
+				}
+
+				Assert::AreEqual(50, base.reduce([](int count, int) { return count + 1; }, 0));
+			}
+
+			Assert::AreEqual(std::ptrdiff_t(0), live);
+		}
+
+		TEST_METHOD(RegionScope_Nodes_Survive_Dropped_Versions)
+		{
+			region_scope scope;
+			forward_list<int> list;
+
+			for (int i = 0; i < 10; i++)
+			{
+				list = list.push_front(i);
+			}
+
+			auto shorter = list;
+
+			for (int i = 0; i < 5; i++)
+			{
+				shorter = shorter.push_front(i);
+			}
+
+			list = forward_list<int>();
+
+			Assert::AreEqual(15u, static_cast<unsigned>(scope.get_region().node_count()));
+			Assert::AreEqual(4, shorter.front());
+		}
+
+		TEST_METHOD(RegionScopes_Can_Be_Nested)
+		{
+			region_scope outer;
+			auto tree = std::get<0>(redblack_tree<int>().insert(1));
+
+			{
+				region_scope inner;
+				auto inner_tree = std::get<0>(tree.insert(2));
+
+				Assert::IsTrue(inner_tree.find(1) != inner_tree.end());
+				Assert::AreEqual(std::size_t(1), outer.get_region().node_count());
+			}
+
+			Assert::IsTrue(tree.find(1) != tree.end());
+		}
+
+		TEST_METHOD(NodeRegion_Release_Detects_Escaped_Nodes)
+		{
+			redblack_tree<int> escaped;
+
+			region_scope scope;
+
+			for (int i = 0; i < 10; i++)
+			{
+				escaped = std::get<0>(escaped.insert(i));
+			}
+
+			// the escaped version keeps its nodes alive, and only those.
+			Assert::AreEqual(std::size_t(10), scope.get_region().release());
+			Assert::AreEqual(std::size_t(0), scope.get_region().node_count());
+			Assert::AreEqual(45, escaped.reduce([](int sum, int value) { return sum + value; }, 0));
+
+			// the nodes were released from the region, so that the scope may end.
+			Assert::AreEqual(std::size_t(0), scope.get_region().release());
+		}
+	};
+}
\ No newline at end of file
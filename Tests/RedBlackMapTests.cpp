@@ -0,0 +1,163 @@
+#include "stdafx.h"
+#include <CppUnitTest.h>
+
+#include <wenda/fds/redblack_map.h>
+#include "counting_allocator.h"
+
+#include <map>
+#include <random>
+#include <string>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace WENDA_FDS_NAMESPACE;
+
+namespace tests
+{
+	TEST_CLASS(RedBlackMapTests)
+	{
+		TEST_METHOD(RedBlackMap_Default_Is_Empty)
+		{
+			redblack_map<int, std::string> map;
+
+			Assert::IsTrue(map.empty());
+			Assert::IsTrue(map.find(1) == nullptr);
+			Assert::IsFalse(map.contains(1));
+		}
+
+		TEST_METHOD(RedBlackMap_Insert_Does_Not_Replace_Existing_Value)
+		{
+			redblack_map<int, std::string> map;
+			bool inserted;
+
+			std::tie(map, inserted) = map.insert(1, "one");
+			Assert::IsTrue(inserted);
+
+			auto result = map.insert(1, "uno");
+			Assert::IsFalse(std::get<1>(result));
+			Assert::IsTrue(std::get<0>(result).shares_root(map));
+			Assert::AreEqual(std::string("one"), *map.find(1));
+		}
+
+		TEST_METHOD(RedBlackMap_Insert_Or_Assign_Replaces_Value_Without_Changing_Previous_Version)
+		{
+			redblack_map<int, std::string> map;
+
+			for (int i = 0; i < 50; i++)
+			{
+				std::tie(map, std::ignore) = map.insert_or_assign(i, std::to_string(i));
+			}
+
+			redblack_map<int, std::string> updated;
+			bool inserted;
+			std::tie(updated, inserted) = map.insert_or_assign(20, "twenty");
+
+			Assert::IsFalse(inserted);
+			Assert::AreEqual(std::size_t(50), updated.size());
+			Assert::AreEqual(std::string("twenty"), *updated.find(20));
+			Assert::AreEqual(std::string("20"), *map.find(20));
+			Assert::AreEqual(std::string("21"), *updated.find(21));
+		}
+
+		TEST_METHOD(RedBlackMap_Update_Copies_Only_Search_Path)
+		{
+			std::ptrdiff_t live = 0;
+
+			{
+				typedef redblack_map<int, int, std::less<>, counting_allocator<std::pair<const int, int>>> map_t;
+				map_t map{ counting_allocator<std::pair<const int, int>>(&live) };
+
+				for (int i = 0; i < 1000; i++)
+				{
+					std::tie(map, std::ignore) = map.insert(i, i);
+				}
+
+				for (int i = 0; i < 999; i += 37)
+				{
+					auto allocated = live;
+					auto result = map.update(i, [](int value) { return value * 2; });
+
+					Assert::IsTrue(std::get<1>(result));
+					Assert::AreEqual(i * 2, *std::get<0>(result).find(i));
+					Assert::AreEqual(i + 1, *std::get<0>(result).find(i + 1));
+
+					// a red-black tree of 1000 elements has a height of at most 2 log2(1001) < 20.
+					Assert::IsTrue(live - allocated < 20);
+				}
+
+				auto allocated = live;
+				auto missing = map.update(1000, [](int value) { return value; });
+
+				Assert::IsFalse(std::get<1>(missing));
+				Assert::IsTrue(std::get<0>(missing).shares_root(map));
+				Assert::AreEqual(allocated, live);
+			}
+
+			Assert::AreEqual(std::ptrdiff_t(0), live);
+		}
+
+		TEST_METHOD(RedBlackMap_Matches_Std_Map_For_Random_Updates)
+		{
+			std::mt19937 random(3);
+			std::uniform_int_distribution<int> distribution(0, 200);
+
+			redblack_map<int, int> map;
+			std::map<int, int> expected;
+
+			for (int i = 0; i < 3000; i++)
+			{
+				auto key = distribution(random);
+
+				switch (i % 4)
+				{
+				case 0:
+					std::tie(map, std::ignore) = map.erase(key);
+					expected.erase(key);
+					break;
+				case 1:
+					std::tie(map, std::ignore) = map.update(key, [](int value) { return value + 1; });
+
+					if (expected.count(key))
+					{
+						expected[key]++;
+					}
+
+					break;
+				default:
+					std::tie(map, std::ignore) = map.insert_or_assign(key, i);
+					expected[key] = i;
+					break;
+				}
+			}
+
+			Assert::AreEqual(expected.size(), map.size());
+
+			auto it = map.begin();
+
+			for (auto const& pair : expected)
+			{
+				Assert::AreEqual(pair.first, it->first);
+				Assert::AreEqual(pair.second, it->second);
+				++it;
+			}
+
+			Assert::IsTrue(it == map.end());
+		}
+
+		TEST_METHOD(RedBlackMap_Finds_Values_By_Heterogeneous_Key)
+		{
+			std::pair<std::string, int> pairs[] = { { "apple", 1 }, { "banana", 2 }, { "cherry", 3 } };
+			redblack_map<std::string, int, three_way_less<>> map(std::begin(pairs), std::end(pairs));
+
+			Assert::AreEqual(std::size_t(3), map.size());
+			Assert::AreEqual(2, *map.find("banana"));
+			Assert::IsTrue(map.contains("cherry"));
+			Assert::IsTrue(map.find("durian") == nullptr);
+
+			bool erased;
+			std::tie(map, erased) = map.erase("apple");
+
+			Assert::IsTrue(erased);
+			Assert::IsFalse(map.contains("apple"));
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,229 @@
+#include "stdafx.h"
+#include <CppUnitTest.h>
+
+#include <wenda/fds/redblack_tree.h>
+#include "redblack_validation.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <set>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace WENDA_FDS_NAMESPACE;
+
+namespace tests
+{
+	namespace
+	{
+		typedef redblack_tree<int, std::less<>, node_pool_allocator<int>, default_refcount_policy, sum_augmentation<int>> sum_tree;
+		typedef redblack_tree<int, std::less<>, node_pool_allocator<int>, default_refcount_policy, min_augmentation<int>> min_tree;
+		typedef redblack_tree<int, std::less<>, node_pool_allocator<int>, default_refcount_policy, max_augmentation<int>> max_tree;
+
+		/**
+		* Comparison function which counts how many times it is called.
+		*/
+		struct counting_less
+		{
+			static int calls;
+
+			bool operator()(int left, int right) const
+			{
+				calls++;
+				return left < right;
+			}
+		};
+
+		int counting_less::calls = 0;
+
+		typedef redblack_tree<int, counting_less, node_pool_allocator<int>, default_refcount_policy, hash_augmentation<int>> hash_tree;
+
+		/**
+		* Hash function for which all elements collide.
+		*/
+		struct constant_hash
+		{
+			std::size_t operator()(int) const
+			{
+				return 42;
+			}
+		};
+
+		typedef redblack_tree<int, std::less<>, node_pool_allocator<int>, default_refcount_policy, hash_augmentation<int, constant_hash>> colliding_tree;
+
+		int sum_range(std::set<int> const& set, int lower, int upper)
+		{
+			return std::accumulate(set.lower_bound(lower), set.lower_bound((std::max)(lower, upper)), 0);
+		}
+	}
+
+	TEST_CLASS(RedBlackTreeTests_Augmentation)
+	{
+		TEST_METHOD(Aggregate_Of_Empty_Tree_Is_Identity)
+		{
+			Assert::AreEqual(0, sum_tree().aggregate());
+			Assert::AreEqual(0, sum_tree().aggregate(0, 10));
+			Assert::AreEqual((std::numeric_limits<int>::max)(), min_tree().aggregate());
+		}
+
+		TEST_METHOD(Aggregate_Is_Maintained_By_Insertion)
+		{
+			std::mt19937 random(3);
+			std::uniform_int_distribution<int> distribution(0, 1000);
+
+			sum_tree tree;
+			auto transient = sum_tree().transient();
+			std::set<int> expected;
+
+			for (int i = 0; i < 500; i++)
+			{
+				auto value = distribution(random);
+
+				tree = std::get<0>(tree.insert(value));
+				transient.insert(value);
+				expected.insert(value);
+
+				auto sum = std::accumulate(expected.begin(), expected.end(), 0);
+				Assert::AreEqual(sum, tree.aggregate());
+				Assert::AreEqual(sum, transient.persistent().aggregate());
+			}
+		}
+
+		TEST_METHOD(Aggregate_Range_Matches_Std_Set)
+		{
+			std::mt19937 random(5);
+			std::uniform_int_distribution<int> distribution(0, 1000);
+
+			std::set<int> expected;
+
+			for (int i = 0; i < 300; i++)
+			{
+				expected.insert(distribution(random));
+			}
+
+			sum_tree tree(expected.begin(), expected.end());
+
+			for (int i = 0; i < 500; i++)
+			{
+				auto lower = distribution(random) - 10;
+				auto upper = distribution(random) + 10;
+
+				Assert::AreEqual(sum_range(expected, lower, upper), tree.aggregate(lower, upper));
+			}
+
+			Assert::AreEqual(0, tree.aggregate(500, 500));
+			Assert::AreEqual(0, tree.aggregate(600, 400));
+		}
+
+		TEST_METHOD(Min_And_Max_Aggregates)
+		{
+			auto minimums = make_sorted_tree<min_tree>(100);
+			auto maximums = make_sorted_tree<max_tree>(100);
+
+			Assert::AreEqual(0, minimums.aggregate());
+			Assert::AreEqual(99, maximums.aggregate());
+			Assert::AreEqual(25, minimums.aggregate(25, 50));
+			Assert::AreEqual(49, maximums.aggregate(25, 50));
+		}
+
+		TEST_METHOD(Aggregate_Is_Maintained_By_Set_Operations)
+		{
+			auto evens = sorted_values(300, 0, 2);
+			auto thirds = sorted_values(300, 0, 3);
+
+			auto left = make_sorted_tree<sum_tree>(300, 0, 2);
+			auto right = make_sorted_tree<sum_tree>(300, 0, 3);
+
+			std::set<int> expected(evens.begin(), evens.end());
+			expected.insert(thirds.begin(), thirds.end());
+
+			auto united = set_union(left, right);
+			Assert::AreEqual(std::accumulate(expected.begin(), expected.end(), 0), united.aggregate());
+
+			auto odd = united.filter([](int value) { return value % 2 != 0; });
+			Assert::AreEqual(odd.reduce([](int sum, int value) { return sum + value; }, 0), odd.aggregate());
+		}
+
+		TEST_METHOD(Hash_Does_Not_Depend_On_Tree_Shape)
+		{
+			auto values = sorted_values(500);
+			auto sorted = make_sorted_tree<hash_tree>(500);
+			hash_tree descending;
+			auto transient = hash_tree().transient();
+
+			for (int i = 499; i >= 0; i--)
+			{
+				descending = std::get<0>(descending.insert(i));
+			}
+
+			std::shuffle(values.begin(), values.end(), std::mt19937(11));
+
+			for (auto value : values)
+			{
+				transient.insert(value);
+			}
+
+			auto shuffled = transient.persistent();
+			auto restored = std::get<0>(std::get<0>(shuffled.erase(250)).insert(250));
+			auto changed = std::get<0>(std::get<0>(shuffled.erase(250)).insert(500));
+
+			Assert::IsTrue(sorted.aggregate() == descending.aggregate());
+			Assert::IsTrue(sorted.aggregate() == shuffled.aggregate());
+			Assert::IsTrue(sorted.aggregate() == restored.aggregate());
+			Assert::IsTrue(sorted.aggregate() != changed.aggregate());
+			Assert::IsTrue(sorted.aggregate(100, 200) == changed.aggregate(100, 200));
+			Assert::IsTrue(sorted.aggregate(200, 300) != changed.aggregate(200, 300));
+			Assert::IsTrue(hash_tree().aggregate() == hash_augmentation<int>::identity());
+		}
+
+		TEST_METHOD(Hash_Skips_Equal_Subtrees_Of_Separately_Built_Trees)
+		{
+			auto first = make_sorted_tree<hash_tree>(10000, 0, 2);
+			auto second = make_sorted_tree<hash_tree>(10000, 0, 2);
+
+			counting_less::calls = 0;
+			Assert::IsTrue(first.hash_equal(second));
+			Assert::IsTrue(first == second);
+			Assert::AreEqual(0, counting_less::calls);
+
+			// replaces an element by one in the same position, so that the subtrees of the rebuilt tree hold the same elements elsewhere.
+			auto changed = std::get<0>(std::get<0>(second.erase(5000)).insert(5001));
+			auto rebuilt = hash_tree(sorted_range, changed.begin(), changed.end());
+			std::vector<int> removed, added;
+
+			counting_less::calls = 0;
+			first.diff(rebuilt, [&](int value) { removed.push_back(value); }, [&](int value) { added.push_back(value); }, [](int, int) {});
+
+			Assert::IsTrue(removed == std::vector<int>{ 5000 });
+			Assert::IsTrue(added == std::vector<int>{ 5001 });
+			Assert::IsTrue(counting_less::calls < 200);
+
+			// the hashes differ, so that the trees are known to differ without comparing their elements.
+			counting_less::calls = 0;
+			Assert::IsFalse(first.hash_equal(rebuilt));
+			Assert::IsFalse(first == rebuilt);
+			Assert::AreEqual(0, counting_less::calls);
+		}
+
+		TEST_METHOD(Equality_Is_Exact_When_Hashes_Collide)
+		{
+			colliding_tree first, second;
+
+			for (int i = 0; i < 100; i++)
+			{
+				first = std::get<0>(first.insert(i));
+				second = std::get<0>(second.insert(i == 50 ? 1000 : i));
+			}
+
+			auto copy = std::get<0>(std::get<0>(first.erase(0)).insert(0));
+
+			Assert::IsTrue(first.hash_equal(second));
+			Assert::IsFalse(first == second);
+			Assert::IsTrue(first != second);
+			Assert::IsTrue(first == copy);
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,90 @@
+#include "stdafx.h"
+#include <CppUnitTest.h>
+
+#include <wenda/fds/redblack_tree.h>
+#include "redblack_validation.h"
+#include "counting_allocator.h"
+
+#include <algorithm>
+#include <random>
+#include <set>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace WENDA_FDS_NAMESPACE;
+
+namespace tests
+{
+	namespace
+	{
+		typedef detail::default_node_traits<int> int_traits;
+	}
+
+	TEST_CLASS(RedBlackTreeTests_Build)
+	{
+		TEST_METHOD(BuildSorted_Is_Balanced_For_All_Sizes)
+		{
+			std::vector<int> data;
+
+			for (int count = 0; count < 300; count++)
+			{
+				auto root = detail::build_sorted<int, int_traits>(data.begin(), data.end(), std::less<>(), node_pool_allocator<int>());
+				check_black_height<int, int_traits>(root);
+
+				Assert::IsTrue(is_leaf(root) || colour(root) == detail::NodeColour::Black);
+
+				redblack_tree<int> tree(sorted_range, data.begin(), data.end());
+				auto expected = 0;
+				tree.reduce([&](int, int value) { Assert::AreEqual(expected++, value); return 0; }, 0);
+				Assert::AreEqual(count, expected);
+
+				data.push_back(count);
+			}
+		}
+
+		TEST_METHOD(RedBlackTree_Sorted_Range_Skips_Duplicates)
+		{
+			std::vector<int> data = { 1, 1, 2, 3, 3, 3, 4, 7, 7 };
+			redblack_tree<int> tree(sorted_range, data.begin(), data.end());
+
+			std::vector<int> result(tree.begin(), tree.end());
+			std::vector<int> expected = { 1, 2, 3, 4, 7 };
+
+			Assert::IsTrue(expected == result);
+		}
+
+		TEST_METHOD(RedBlackTree_Sorted_Range_Allocates_Once_Per_Element)
+		{
+			std::ptrdiff_t live = 0;
+			std::vector<int> data = { 1, 2, 2, 4, 5, 6 };
+
+			{
+				redblack_tree<int, std::less<>, counting_allocator<int>> tree(sorted_range, data.begin(), data.end(), counting_allocator<int>(&live));
+				Assert::AreEqual(std::ptrdiff_t(5), live);
+			}
+
+			Assert::AreEqual(std::ptrdiff_t(0), live);
+		}
+
+		TEST_METHOD(RedBlackTree_Unsorted_Range_Matches_Insert)
+		{
+			std::mt19937 mt(3);
+			std::uniform_int_distribution<int> dis(0, 2000);
+			std::vector<int> data;
+
+			for (int i = 0; i < 1000; i++)
+			{
+				data.push_back(dis(mt));
+			}
+
+			redblack_tree<int> tree(data.begin(), data.end());
+			std::set<int> expected(data.begin(), data.end());
+
+			Assert::IsTrue(std::equal(expected.begin(), expected.end(), tree.begin()));
+			Assert::AreEqual(expected.size(), static_cast<std::size_t>(std::distance(tree.begin(), tree.end())));
+
+			std::tie(tree, std::ignore, std::ignore) = tree.insert(2001);
+			Assert::IsTrue(tree.find(2001) != tree.end());
+		}
+	};
+}
\ No newline at end of file
@@ -2,6 +2,10 @@
 #include <CppUnitTest.h>
 
 #include <wenda/fds/redblack_tree.h>
+#include "redblack_validation.h"
+
+#include <random>
+#include <set>
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 using namespace WENDA_FDS_NAMESPACE;
@@ -9,6 +13,31 @@ using namespace detail;
 
 namespace tests
 {
+	namespace
+	{
+		typedef default_node_traits<int> int_traits;
+
+		/**
+		* Erases @p value from the tree rooted at @p root, and checks the invariants of the resulting tree.
+		*/
+		bool erase_checked(const_intrusive_rb_ptr<int>& root, int value)
+		{
+			const_intrusive_rb_ptr<int> newRoot;
+			bool deleted;
+
+			std::tie(newRoot, deleted) = find_delete_node<int, int_traits>(root.get(), value, std::less<>(), node_pool_allocator<int>());
+
+			if (deleted)
+			{
+				root = make_black(newRoot.get());
+			}
+
+			check_black_height<int, int_traits>(root);
+			check_size<int, int_traits>(root);
+			return deleted;
+		}
+	}
+
 	TEST_CLASS(RedBlackTreeTests_Deletion)
 	{
 		TEST_METHOD(RemoveNode_Creates_Black_Leaf_Node_When_Removing_Red_Node_With_No_Children)
@@ -90,5 +119,102 @@ namespace tests
 			Assert::IsTrue(tree.find(3) != tree.end(), L"could not find not deleted node.");
 			Assert::IsTrue(tree.find(2) == tree.end(), L"deleted node still exists.");
 		}
+
+		TEST_METHOD(FindDeleteNode_Returns_Null_Root_When_Value_Not_Present)
+		{
+			const_intrusive_rb_ptr<int> root;
+
+			for (int i = 0; i < 20; i += 2)
+			{
+				auto make = [i]() { return i; };
+				search_path<int, int_traits> path;
+				std::tie(root, std::ignore) = insert_impl<int, int_traits>(root.get(), i, make, std::less<>(), node_pool_allocator<int>(), path);
+				root = make_black(root.get());
+			}
+
+			const_intrusive_rb_ptr<int> result;
+			bool deleted;
+			std::tie(result, deleted) = find_delete_node<int, int_traits>(root.get(), 5, std::less<>(), node_pool_allocator<int>());
+
+			Assert::IsFalse(deleted);
+			Assert::IsTrue(is_leaf(result));
+		}
+
+		TEST_METHOD(Erase_Maintains_Invariants_For_Random_Sequences)
+		{
+			std::mt19937 random(11);
+			std::uniform_int_distribution<int> distribution(0, 200);
+
+			const_intrusive_rb_ptr<int> root;
+			std::set<int> expected;
+
+			for (int i = 0; i < 2000; i++)
+			{
+				auto value = distribution(random);
+
+				if (i % 3 == 0)
+				{
+					Assert::AreEqual(expected.erase(value) != 0, erase_checked(root, value));
+				}
+				else
+				{
+					auto make = [value]() { return value; };
+					const_intrusive_rb_ptr<int> newRoot;
+					search_path<int, int_traits> path;
+					bool inserted;
+
+					std::tie(newRoot, inserted) = insert_impl<int, int_traits>(root.get(), value, make, std::less<>(), node_pool_allocator<int>(), path);
+					Assert::AreEqual(expected.insert(value).second, inserted);
+
+					if (inserted)
+					{
+						root = make_black(newRoot.get());
+					}
+				}
+
+				Assert::AreEqual(expected.size(), subtree_size(root.get()));
+			}
+
+			while (!expected.empty())
+			{
+				auto value = *expected.begin();
+				expected.erase(expected.begin());
+				Assert::IsTrue(erase_checked(root, value));
+			}
+
+			Assert::IsTrue(is_leaf(root));
+		}
+
+		TEST_METHOD(RedBlackTree_Erase_Leaves_Previous_Version_Unchanged)
+		{
+			redblack_tree<int> tree;
+
+			for (int i = 0; i < 100; i++)
+			{
+				std::tie(tree, std::ignore, std::ignore) = tree.insert(i);
+			}
+
+			auto current = tree;
+
+			for (int i = 0; i < 100; i += 3)
+			{
+				std::tie(current, std::ignore) = current.erase(i);
+			}
+
+			Assert::AreEqual(std::size_t(100), tree.size());
+			Assert::AreEqual(std::size_t(66), current.size());
+
+			int expected = 0;
+
+			for (auto value : current)
+			{
+				if (expected % 3 == 0)
+				{
+					expected++;
+				}
+
+				Assert::AreEqual(expected++, value);
+			}
+		}
 	};
 }
\ No newline at end of file
@@ -0,0 +1,179 @@
+#include "stdafx.h"
+#include <CppUnitTest.h>
+
+#include <wenda/fds/redblack_map.h>
+#include <wenda/fds/redblack_tree.h>
+#include "redblack_validation.h"
+
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <set>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace WENDA_FDS_NAMESPACE;
+
+namespace tests
+{
+	namespace
+	{
+		/**
+		* Comparison function which counts how many times it is called.
+		*/
+		struct counting_less
+		{
+			static int calls;
+
+			bool operator()(int left, int right) const
+			{
+				calls++;
+				return left < right;
+			}
+		};
+
+		int counting_less::calls = 0;
+
+		typedef redblack_tree<int, counting_less> counted_tree;
+	}
+
+	TEST_CLASS(RedBlackTreeTests_Diff)
+	{
+		TEST_METHOD(Diff_Of_Same_Tree_Reports_Nothing_Without_Comparing)
+		{
+			auto tree = make_sorted_tree<counted_tree>(10000, 0, 2);
+			auto copy = tree;
+			int differences = 0;
+
+			counting_less::calls = 0;
+			diff(tree, copy, [&](int) { differences++; }, [&](int) { differences++; }, [&](int, int) { differences++; });
+
+			Assert::AreEqual(0, differences);
+			Assert::AreEqual(0, counting_less::calls);
+			Assert::IsTrue(tree == copy);
+		}
+
+		TEST_METHOD(Diff_Skips_Shared_Subtrees)
+		{
+			auto older = make_sorted_tree<counted_tree>(10000, 0, 2);
+			auto newer = older;
+
+			std::tie(newer, std::ignore, std::ignore) = newer.insert(5001);
+			std::tie(newer, std::ignore) = newer.erase(200);
+			std::tie(newer, std::ignore, std::ignore) = newer.insert(19999);
+
+			std::vector<int> removed, added;
+
+			counting_less::calls = 0;
+			diff(older, newer, [&](int value) { removed.push_back(value); }, [&](int value) { added.push_back(value); }, [](int, int) {});
+
+			Assert::AreEqual(std::size_t(1), removed.size());
+			Assert::AreEqual(200, removed[0]);
+			Assert::AreEqual(std::size_t(2), added.size());
+			Assert::AreEqual(5001, added[0]);
+			Assert::AreEqual(19999, added[1]);
+
+			// each difference visits the nodes near its two update paths, a tiny fraction of the 10000 elements.
+			Assert::IsTrue(counting_less::calls < 1000);
+			Assert::IsFalse(older == newer);
+		}
+
+		TEST_METHOD(Diff_Matches_Set_Differences_For_Random_Edits)
+		{
+			std::mt19937 random(17);
+			std::uniform_int_distribution<int> distribution(0, 3000);
+
+			redblack_tree<int> older;
+
+			for (int i = 0; i < 1500; i++)
+			{
+				std::tie(older, std::ignore, std::ignore) = older.insert(distribution(random));
+			}
+
+			for (int round = 0; round < 20; round++)
+			{
+				auto newer = older;
+
+				for (int i = 0; i < round * 5; i++)
+				{
+					if (i % 2 == 0)
+					{
+						std::tie(newer, std::ignore, std::ignore) = newer.insert(distribution(random));
+					}
+					else
+					{
+						std::tie(newer, std::ignore) = newer.erase(distribution(random));
+					}
+				}
+
+				std::set<int> olderSet(older.begin(), older.end());
+				std::set<int> newerSet(newer.begin(), newer.end());
+				std::vector<int> expectedRemoved, expectedAdded, removed, added;
+
+				std::set_difference(olderSet.begin(), olderSet.end(), newerSet.begin(), newerSet.end(), std::back_inserter(expectedRemoved));
+				std::set_difference(newerSet.begin(), newerSet.end(), olderSet.begin(), olderSet.end(), std::back_inserter(expectedAdded));
+
+				older.diff(newer, [&](int value) { removed.push_back(value); }, [&](int value) { added.push_back(value); }, [](int, int) {});
+
+				Assert::IsTrue(expectedRemoved == removed);
+				Assert::IsTrue(expectedAdded == added);
+				Assert::AreEqual(olderSet == newerSet, older == newer);
+
+				older = newer;
+			}
+		}
+
+		TEST_METHOD(Equality_Compares_Independently_Built_Trees)
+		{
+			redblack_tree<int> ascending, descending;
+
+			for (int i = 0; i < 100; i++)
+			{
+				std::tie(ascending, std::ignore, std::ignore) = ascending.insert(i);
+				std::tie(descending, std::ignore, std::ignore) = descending.insert(99 - i);
+			}
+
+			Assert::IsTrue(ascending == descending);
+			Assert::IsFalse(ascending != descending);
+
+			auto changed = std::get<0>(std::get<0>(descending.erase(50)).insert(100));
+
+			Assert::AreEqual(ascending.size(), changed.size());
+			Assert::IsTrue(ascending != changed);
+		}
+
+		TEST_METHOD(Map_Diff_Reports_Changed_Values)
+		{
+			redblack_map<int, int> older;
+
+			for (int i = 0; i < 100; i++)
+			{
+				std::tie(older, std::ignore) = older.insert(i, i);
+			}
+
+			auto newer = std::get<0>(older.insert_or_assign(30, 300));
+			newer = std::get<0>(newer.insert_or_assign(40, 40));
+			newer = std::get<0>(newer.update(50, [](int value) { return value + 1; }));
+
+			std::vector<std::pair<int, int>> changes;
+			int other = 0;
+
+			older.diff(newer, [&](std::pair<const int, int> const&) { other++; }, [&](std::pair<const int, int> const&) { other++; },
+				[&](std::pair<const int, int> const& before, std::pair<const int, int> const& after)
+			{
+				Assert::AreEqual(before.first, after.first);
+				changes.emplace_back(before.first, after.second);
+			});
+
+			Assert::AreEqual(0, other);
+			Assert::AreEqual(std::size_t(2), changes.size());
+			Assert::AreEqual(30, changes[0].first);
+			Assert::AreEqual(300, changes[0].second);
+			Assert::AreEqual(50, changes[1].first);
+			Assert::AreEqual(51, changes[1].second);
+
+			Assert::IsFalse(older == newer);
+			Assert::IsTrue(older == std::get<0>(older.insert_or_assign(40, 40)));
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,103 @@
+#include "stdafx.h"
+#include <CppUnitTest.h>
+
+#include <wenda/fds/redblack_tree.h>
+#include "redblack_validation.h"
+
+#include <string>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace WENDA_FDS_NAMESPACE;
+
+namespace tests
+{
+	namespace
+	{
+		/**
+		* Element type which counts how many times it is constructed from a key.
+		*/
+		struct keyed_element
+		{
+			static int constructed;
+
+			int key;
+			std::string payload;
+
+			explicit keyed_element(int key, std::string payload = std::string())
+				: key(key), payload(std::move(payload))
+			{
+				constructed++;
+			}
+		};
+
+		int keyed_element::constructed = 0;
+
+		struct keyed_compare
+		{
+			typedef void is_transparent;
+
+			bool operator()(keyed_element const& left, keyed_element const& right) const { return left.key < right.key; }
+			bool operator()(keyed_element const& left, int right) const { return left.key < right; }
+			bool operator()(int left, keyed_element const& right) const { return left < right.key; }
+		};
+
+		typedef redblack_tree<keyed_element, keyed_compare> keyed_tree;
+	}
+
+	TEST_CLASS(RedBlackTreeTests_Heterogeneous)
+	{
+		TEST_METHOD(Transparent_Lookup_Does_Not_Construct_Elements)
+		{
+			auto tree = make_sorted_tree<keyed_tree>(50, 0, 2);
+			keyed_element::constructed = 0;
+
+			for (int i = 0; i < 99; i++)
+			{
+				Assert::AreEqual(i % 2 == 0, tree.contains(i));
+				Assert::AreEqual(i % 2 == 0, tree.find_ptr(i) != nullptr);
+				Assert::AreEqual(i % 2 == 0, tree.find(i) != tree.end());
+				Assert::AreEqual(i + i % 2, tree.lower_bound(i)->key);
+			}
+
+			Assert::AreEqual(0, keyed_element::constructed);
+		}
+
+		TEST_METHOD(Try_Emplace_Constructs_Only_Absent_Elements)
+		{
+			auto tree = make_sorted_tree<keyed_tree>(50, 0, 2);
+			keyed_element::constructed = 0;
+
+			keyed_tree result;
+			bool inserted;
+
+			std::tie(result, std::ignore, inserted) = tree.try_emplace(10, 10, "ten");
+			Assert::IsFalse(inserted);
+			Assert::AreEqual(0, keyed_element::constructed);
+			Assert::AreEqual(std::string(), tree.find(10)->payload);
+
+			keyed_tree::iterator position;
+			std::tie(result, position, inserted) = tree.try_emplace(11, 11, "eleven");
+			Assert::IsTrue(inserted);
+			Assert::AreEqual(1, keyed_element::constructed);
+			Assert::AreEqual(std::string("eleven"), position->payload);
+			Assert::AreEqual(std::size_t(51), result.size());
+			Assert::IsFalse(tree.contains(11));
+		}
+
+		TEST_METHOD(String_Tree_Can_Be_Searched_With_Literals)
+		{
+			std::vector<std::string> words = { "apple", "banana", "cherry", "date" };
+			redblack_tree<std::string> tree(sorted_range, words.begin(), words.end());
+
+			Assert::IsTrue(tree.contains("banana"));
+			Assert::IsFalse(tree.contains("blueberry"));
+			Assert::AreEqual(std::string("cherry"), *tree.lower_bound("blueberry"));
+			Assert::AreEqual(std::string("date"), *tree.upper_bound("cherry"));
+
+			auto result = tree.try_emplace("elderberry");
+			Assert::IsTrue(std::get<2>(result));
+			Assert::AreEqual(std::string("elderberry"), *std::get<1>(result));
+		}
+	};
+}
\ No newline at end of file
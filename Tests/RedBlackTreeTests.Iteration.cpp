@@ -2,8 +2,11 @@
 #include <CppUnitTest.h>
 
 #include <wenda/fds/redblack_tree.h>
+#include "redblack_validation.h"
 
+#include <random>
 #include <set>
+#include <vector>
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 using namespace WENDA_FDS_NAMESPACE;
@@ -66,5 +69,163 @@ namespace tests
 
 			Assert::AreEqual(45, result);
 		}
+
+		TEST_METHOD(RedBlackTree_Bounds_Match_Std_Set)
+		{
+			std::mt19937 random(19);
+			std::uniform_int_distribution<int> distribution(0, 300);
+
+			std::set<int> set;
+
+			for (int i = 0; i < 100; i++)
+			{
+				set.insert(distribution(random) * 2);
+			}
+
+			redblack_tree<int> tree(set.begin(), set.end());
+
+			for (int value = -2; value < 604; value++)
+			{
+				std::vector<int> lower(tree.lower_bound(value), tree.end());
+				std::vector<int> upper(tree.upper_bound(value), tree.end());
+
+				Assert::IsTrue(std::equal(lower.begin(), lower.end(), set.lower_bound(value), set.end()));
+				Assert::IsTrue(std::equal(upper.begin(), upper.end(), set.upper_bound(value), set.end()));
+			}
+		}
+
+		TEST_METHOD(RedBlackTree_Equal_Range)
+		{
+			auto tree = make_sorted_tree<redblack_tree<int>>(4, 1, 2);
+
+			auto found = tree.equal_range(5);
+			Assert::AreEqual(5, *found.first);
+			Assert::AreEqual(7, *found.second);
+
+			auto missing = tree.equal_range(4);
+			Assert::IsTrue(missing.first == missing.second);
+			Assert::AreEqual(5, *missing.first);
+
+			auto past = tree.equal_range(9);
+			Assert::IsTrue(past.first == tree.end());
+			Assert::IsTrue(past.second == tree.end());
+		}
+
+		TEST_METHOD(RedBlackTree_Range_Iterates_Bounded_Elements)
+		{
+			auto tree = make_sorted_tree<redblack_tree<int>>(100);
+
+			std::vector<int> result;
+
+			for (auto value : tree.range(10, 20))
+			{
+				result.push_back(value);
+			}
+
+			Assert::IsTrue(result == sorted_values(10, 10));
+			Assert::AreEqual(std::size_t(10), result.size());
+			Assert::IsTrue(tree.range(20, 10).empty());
+			Assert::IsTrue(tree.range(200, 300).empty());
+			Assert::IsFalse(tree.range(-10, 1).empty());
+		}
+
+		TEST_METHOD(RedBlackTree_Reverse_Iteration_Matches_Std_Set)
+		{
+			std::mt19937 random(23);
+			std::uniform_int_distribution<int> distribution(0, 10000);
+
+			std::set<int> set;
+
+			for (int i = 0; i < 500; i++)
+			{
+				set.insert(distribution(random));
+			}
+
+			redblack_tree<int> tree(set.begin(), set.end());
+
+			Assert::IsTrue(std::equal(tree.rbegin(), tree.rend(), set.rbegin(), set.rend()));
+
+			auto it = tree.end();
+			auto expected = set.end();
+
+			while (it != tree.begin())
+			{
+				--it;
+				--expected;
+				Assert::AreEqual(*expected, *it);
+			}
+
+			Assert::IsTrue(expected == set.begin());
+		}
+
+		TEST_METHOD(RedBlackTree_Iterators_From_Lookups_Continue_In_Order)
+		{
+			auto tree = make_sorted_tree<redblack_tree<int>>(200);
+
+			for (int i = 0; i < 200; i += 13)
+			{
+				std::vector<int> found(tree.find(i), tree.end());
+				Assert::IsTrue(found == sorted_values(200 - i, i));
+
+				auto previous = tree.find(i);
+				auto copy = previous;
+
+				if (i != 0)
+				{
+					Assert::AreEqual(i - 1, *--previous);
+				}
+
+				Assert::AreEqual(i, *copy);
+			}
+
+			auto result = tree.insert(-1);
+			auto inserted = std::get<1>(result);
+			Assert::AreEqual(-1, *inserted);
+			Assert::AreEqual(0, *++inserted);
+		}
+
+		TEST_METHOD(RedBlackTree_Iterators_From_Insert_Continue_In_Order)
+		{
+			std::mt19937 random(5);
+			std::uniform_int_distribution<int> distribution(0, 500);
+			redblack_tree<int> tree;
+			std::set<int> set;
+
+			for (int i = 0; i < 1000; i++)
+			{
+				auto value = distribution(random);
+				auto result = i % 2 == 0 ? tree.insert(value) : tree.try_emplace(value);
+				auto expected = set.insert(value).first;
+
+				tree = std::get<0>(result);
+				auto position = std::get<1>(result);
+				Assert::AreEqual(value, *position);
+
+				// the path of the iterator must be that of the new tree, including after rebalancing.
+				auto next = position;
+				auto next_expected = expected;
+				++next;
+				++next_expected;
+				Assert::IsTrue(next_expected == set.end() ? next == tree.end() : *next == *next_expected);
+
+				if (expected != set.begin())
+				{
+					--position;
+					--expected;
+					Assert::AreEqual(*expected, *position);
+				}
+			}
+		}
+
+		TEST_METHOD(RedBlackTree_Contains_And_Find_Ptr)
+		{
+			auto tree = make_sorted_tree<redblack_tree<int>>(3, 2, 2);
+
+			Assert::IsTrue(tree.contains(4));
+			Assert::IsFalse(tree.contains(5));
+			Assert::AreEqual(6, *tree.find_ptr(6));
+			Assert::IsTrue(tree.find_ptr(7) == nullptr);
+			Assert::IsTrue(redblack_tree<int>().find_ptr(1) == nullptr);
+		}
 	};
 }
\ No newline at end of file
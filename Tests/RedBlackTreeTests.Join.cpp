@@ -0,0 +1,160 @@
+#include "stdafx.h"
+#include <CppUnitTest.h>
+
+#include <wenda/fds/redblack_tree.h>
+#include "redblack_validation.h"
+
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <set>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace WENDA_FDS_NAMESPACE;
+
+namespace tests
+{
+	namespace
+	{
+		typedef detail::default_node_traits<int> int_traits;
+		typedef detail::redblack_subtree<int, int_traits> int_subtree;
+
+		int_subtree make_range_subtree(int first, int last)
+		{
+			auto values = sorted_values(last - first, first);
+			return detail::make_subtree(detail::build_sorted<int, int_traits>(values.begin(), values.end(), std::less<>(), node_pool_allocator<int>()));
+		}
+
+		void check_subtree(int_subtree const& tree, int first, int last)
+		{
+			Assert::AreEqual(static_cast<int>(tree.black_height) + 1, check_black_height<int, int_traits>(tree.root));
+
+			auto expected = first;
+
+			if (!is_leaf(tree.root))
+			{
+				detail::reduce(*tree.root, [&](int, int value) { Assert::AreEqual(expected++, value); return 0; }, 0);
+			}
+
+			Assert::AreEqual(last, expected);
+		}
+
+		std::vector<int> random_values(unsigned int seed, std::size_t count)
+		{
+			std::mt19937 mt(seed);
+			std::uniform_int_distribution<int> dis(0, 20000);
+			std::vector<int> values;
+
+			for (std::size_t i = 0; i < count; i++)
+			{
+				values.push_back(dis(mt));
+			}
+
+			return values;
+		}
+	}
+
+	TEST_CLASS(RedBlackTreeTests_Join)
+	{
+		TEST_METHOD(Join_Keeps_Tree_Balanced)
+		{
+			for (int left = 0; left < 70; left += 3)
+			{
+				for (int right = 0; right < 300; right += 7)
+				{
+					auto joined = detail::join<int, int_traits>(make_range_subtree(0, left), left, make_range_subtree(left + 1, left + 1 + right), node_pool_allocator<int>());
+					check_subtree(joined, 0, left + 1 + right);
+
+					auto concatenated = detail::join<int, int_traits>(make_range_subtree(0, right), make_range_subtree(right, right + left), node_pool_allocator<int>());
+					check_subtree(concatenated, 0, right + left);
+				}
+			}
+		}
+
+		TEST_METHOD(Split_Keeps_Trees_Balanced)
+		{
+			auto tree = make_range_subtree(0, 200);
+
+			for (int i = -1; i <= 200; i++)
+			{
+				int_subtree less, greater;
+				detail::const_rb_pointer<int, int_traits> found;
+
+				std::tie(less, found, greater) = detail::split(tree, i, std::less<>(), node_pool_allocator<int>());
+
+				check_subtree(less, 0, std::max(0, std::min(i, 200)));
+				check_subtree(greater, std::min(std::max(0, i + 1), 200), 200);
+				Assert::AreEqual(i >= 0 && i < 200, static_cast<bool>(found));
+			}
+		}
+
+		TEST_METHOD(RedBlackTree_Split_Join_Roundtrip)
+		{
+			auto tree = make_sorted_tree<redblack_tree<int>>(6, 1, 2);
+
+			redblack_tree<int> less, greater;
+			bool found;
+
+			std::tie(less, found, greater) = tree.split(5);
+			Assert::IsTrue(found);
+			Assert::IsTrue(std::vector<int>(less.begin(), less.end()) == std::vector<int>({ 1, 3 }));
+			Assert::IsTrue(std::vector<int>(greater.begin(), greater.end()) == std::vector<int>({ 7, 9, 11 }));
+
+			auto joined = redblack_tree<int>::join(less, 6, greater);
+			Assert::IsTrue(std::vector<int>(joined.begin(), joined.end()) == std::vector<int>({ 1, 3, 6, 7, 9, 11 }));
+
+			std::tie(less, found, greater) = tree.split(4);
+			Assert::IsFalse(found);
+
+			joined = redblack_tree<int>::join(less, greater);
+			Assert::IsTrue(std::vector<int>(joined.begin(), joined.end()) == sorted_values(6, 1, 2));
+		}
+
+		TEST_METHOD(RedBlackTree_Set_Operations_Match_Std)
+		{
+			task_pool pool(3);
+
+			for (std::size_t count : { 0, 10, 5000 })
+			{
+				auto left = random_values(1, 4000);
+				auto right = random_values(2, count);
+
+				redblack_tree<int> leftTree(left.begin(), left.end());
+				redblack_tree<int> rightTree(right.begin(), right.end());
+				std::set<int> leftSet(left.begin(), left.end());
+				std::set<int> rightSet(right.begin(), right.end());
+
+				std::vector<int> expected;
+				std::set_union(leftSet.begin(), leftSet.end(), rightSet.begin(), rightSet.end(), std::back_inserter(expected));
+				auto result = set_union(leftTree, rightTree, pool);
+				Assert::IsTrue(std::vector<int>(result.begin(), result.end()) == expected);
+
+				expected.clear();
+				std::set_intersection(leftSet.begin(), leftSet.end(), rightSet.begin(), rightSet.end(), std::back_inserter(expected));
+				result = set_intersection(leftTree, rightTree, pool);
+				Assert::IsTrue(std::vector<int>(result.begin(), result.end()) == expected);
+
+				expected.clear();
+				std::set_difference(leftSet.begin(), leftSet.end(), rightSet.begin(), rightSet.end(), std::back_inserter(expected));
+				result = set_difference(leftTree, rightTree, pool);
+				Assert::IsTrue(std::vector<int>(result.begin(), result.end()) == expected);
+
+				expected.clear();
+				std::set_difference(rightSet.begin(), rightSet.end(), leftSet.begin(), leftSet.end(), std::back_inserter(expected));
+				result = set_difference(rightTree, leftTree);
+				Assert::IsTrue(std::vector<int>(result.begin(), result.end()) == expected);
+			}
+		}
+
+		TEST_METHOD(RedBlackTree_Set_Operations_Share_Identical_Trees)
+		{
+			auto values = random_values(3, 1000);
+			redblack_tree<int> tree(values.begin(), values.end());
+
+			Assert::IsTrue(&*set_union(tree, tree).begin() == &*tree.begin());
+			Assert::IsTrue(&*set_intersection(tree, tree).begin() == &*tree.begin());
+			Assert::IsTrue(set_difference(tree, tree).empty());
+		}
+	};
+}
\ No newline at end of file
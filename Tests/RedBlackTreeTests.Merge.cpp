@@ -0,0 +1,186 @@
+#include "stdafx.h"
+#include <CppUnitTest.h>
+
+#include <wenda/fds/redblack_map.h>
+#include <wenda/fds/redblack_tree.h>
+
+#include <map>
+#include <random>
+#include <set>
+#include <utility>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace WENDA_FDS_NAMESPACE;
+
+namespace tests
+{
+	namespace
+	{
+		typedef redblack_map<int, int> int_map;
+		typedef int_map::value_type int_pair;
+
+		/**
+		* Resolver which counts its calls, and keeps the element of the right version.
+		*/
+		struct counting_resolver
+		{
+			int calls;
+
+			template<typename T>
+			T const* operator()(T const*, T const*, T const* right)
+			{
+				calls++;
+				return right;
+			}
+		};
+	}
+
+	TEST_CLASS(RedBlackTreeTests_Merge)
+	{
+		TEST_METHOD(Merge3_Returns_Changed_Version_When_Other_Is_Unchanged)
+		{
+			redblack_tree<int> base;
+
+			for (int i = 0; i < 100; i++)
+			{
+				std::tie(base, std::ignore, std::ignore) = base.insert(i);
+			}
+
+			auto changed = std::get<0>(base.erase(50));
+			counting_resolver resolver = { 0 };
+
+			Assert::IsTrue(merge3(base, base, changed, resolver).shares_root(changed));
+			Assert::IsTrue(merge3(base, changed, base, resolver).shares_root(changed));
+			Assert::IsTrue(merge3(base, changed, changed, resolver).shares_root(changed));
+			Assert::AreEqual(0, resolver.calls);
+		}
+
+		TEST_METHOD(Merge3_Combines_Independent_Edits)
+		{
+			redblack_tree<int> base;
+			std::set<int> expected;
+
+			for (int i = 0; i < 1000; i += 2)
+			{
+				std::tie(base, std::ignore, std::ignore) = base.insert(i);
+				expected.insert(i);
+			}
+
+			auto left = std::get<0>(std::get<0>(base.insert(1)).erase(10));
+			auto right = std::get<0>(std::get<0>(base.insert(501)).erase(600));
+			counting_resolver resolver = { 0 };
+
+			auto merged = merge3(base, left, right, resolver);
+
+			expected.insert(1);
+			expected.erase(10);
+			expected.insert(501);
+			expected.erase(600);
+
+			Assert::AreEqual(0, resolver.calls);
+			Assert::AreEqual(expected.size(), merged.size());
+			Assert::IsTrue(std::equal(expected.begin(), expected.end(), merged.begin()));
+			Assert::AreEqual(std::size_t(500), base.size());
+		}
+
+		TEST_METHOD(Merge3_Calls_Resolver_Only_For_Conflicting_Keys)
+		{
+			int_map base;
+
+			for (int i = 0; i < 100; i++)
+			{
+				std::tie(base, std::ignore) = base.insert(i, i);
+			}
+
+			auto left = std::get<0>(base.insert_or_assign(7, 70));
+			left = std::get<0>(left.erase(8));
+			left = std::get<0>(left.erase(9));
+			left = std::get<0>(left.insert_or_assign(10, 100));
+			left = std::get<0>(left.insert(200, 1));
+
+			auto right = std::get<0>(base.insert_or_assign(7, 700));
+			right = std::get<0>(right.insert_or_assign(8, 80));
+			right = std::get<0>(right.erase(9));
+			right = std::get<0>(right.insert_or_assign(10, 100));
+			right = std::get<0>(right.insert(200, 2));
+			right = std::get<0>(right.insert_or_assign(20, 21));
+
+			int calls = 0;
+			int_pair sum(7, 0);
+
+			auto merged = merge3(base, left, right, [&](int_pair const* before, int_pair const* mine, int_pair const* theirs) -> int_pair const*
+			{
+				calls++;
+
+				if (theirs->first == 7)
+				{
+					Assert::AreEqual(7, before->second);
+					sum.second = mine->second + theirs->second;
+					return &sum;
+				}
+
+				if (theirs->first == 8)
+				{
+					Assert::IsTrue(mine == nullptr);
+					return nullptr;
+				}
+
+				Assert::IsTrue(before == nullptr);
+				return mine;
+			});
+
+			Assert::AreEqual(3, calls);
+			Assert::AreEqual(770, *merged.find(7));
+			Assert::IsFalse(merged.contains(8));
+			Assert::IsFalse(merged.contains(9));
+			Assert::AreEqual(100, *merged.find(10));
+			Assert::AreEqual(21, *merged.find(20));
+			Assert::AreEqual(1, *merged.find(200));
+			Assert::AreEqual(std::size_t(99), merged.size());
+		}
+
+		TEST_METHOD(Merge3_Matches_Replay_Of_Random_Edits)
+		{
+			std::mt19937 random(23);
+			std::uniform_int_distribution<int> distribution(0, 4000);
+
+			int_map base;
+			std::map<int, int> expected;
+
+			for (int i = 0; i < 2000; i++)
+			{
+				auto key = distribution(random);
+				std::tie(base, std::ignore) = base.insert(key, key);
+				expected.emplace(key, key);
+			}
+
+			auto left = base;
+			auto right = base;
+
+			// the left version edits even keys and the right version odd keys, so that the edits never conflict.
+			for (int i = 0; i < 300; i++)
+			{
+				auto key = distribution(random);
+				auto& version = key % 2 == 0 ? left : right;
+
+				if (i % 3 == 0)
+				{
+					std::tie(version, std::ignore) = version.erase(key);
+					expected.erase(key);
+				}
+				else
+				{
+					std::tie(version, std::ignore) = version.insert_or_assign(key, i);
+					expected[key] = i;
+				}
+			}
+
+			counting_resolver resolver = { 0 };
+			auto merged = merge3(base, left, right, resolver);
+
+			Assert::AreEqual(0, resolver.calls);
+			Assert::AreEqual(expected.size(), merged.size());
+			Assert::IsTrue(std::equal(expected.begin(), expected.end(), merged.begin()));
+		}
+	};
+}
\ No newline at end of file
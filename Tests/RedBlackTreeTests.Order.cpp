@@ -0,0 +1,131 @@
+#include "stdafx.h"
+#include <CppUnitTest.h>
+
+#include <wenda/fds/redblack_tree.h>
+#include "redblack_validation.h"
+
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <set>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace WENDA_FDS_NAMESPACE;
+
+namespace tests
+{
+	namespace
+	{
+		typedef detail::default_node_traits<int> int_traits;
+	}
+
+	TEST_CLASS(RedBlackTreeTests_Order)
+	{
+		TEST_METHOD(Sizes_Are_Maintained_By_Transient_Insertion)
+		{
+			std::mt19937 random(7);
+			std::uniform_int_distribution<int> distribution(0, 500);
+
+			detail::const_intrusive_rb_ptr<int> root;
+			detail::const_rb_pointer<int> element;
+			std::set<int> expected;
+
+			for (int i = 0; i < 1000; i++)
+			{
+				auto value = distribution(random);
+				detail::insert_transient<int, int_traits>(root, value, std::less<>(), node_pool_allocator<int>(), element);
+				set_colour(root, detail::NodeColour::Black);
+				expected.insert(value);
+
+				Assert::AreEqual(expected.size(), check_size<int, int_traits>(root));
+			}
+		}
+
+		TEST_METHOD(Sizes_Are_Maintained_By_Join_And_Split)
+		{
+			auto values = sorted_values(300);
+
+			auto tree = detail::make_subtree(detail::build_sorted<int, int_traits>(values.begin(), values.end(), std::less<>(), node_pool_allocator<int>()));
+			Assert::AreEqual(std::size_t(300), check_size<int, int_traits>(tree.root));
+
+			for (int i = 0; i < 300; i += 7)
+			{
+				detail::redblack_subtree<int, int_traits> less, greater;
+				detail::const_rb_pointer<int, int_traits> found;
+
+				std::tie(less, found, greater) = detail::split(tree, i, std::less<>(), node_pool_allocator<int>());
+				Assert::AreEqual(std::size_t(i), check_size<int, int_traits>(less.root));
+				Assert::AreEqual(std::size_t(299 - i), check_size<int, int_traits>(greater.root));
+
+				auto joined = detail::join<int, int_traits>(less, greater, node_pool_allocator<int>());
+				Assert::AreEqual(std::size_t(299), check_size<int, int_traits>(joined.root));
+			}
+		}
+
+		TEST_METHOD(RedBlackTree_Size_Matches_Std_Set)
+		{
+			std::mt19937 random(11);
+			std::uniform_int_distribution<int> distribution(0, 200);
+
+			redblack_tree<int> tree;
+			auto transient = tree.transient();
+			std::set<int> expected;
+
+			Assert::AreEqual(std::size_t(0), tree.size());
+
+			for (int i = 0; i < 500; i++)
+			{
+				auto value = distribution(random);
+
+				tree = std::get<0>(tree.insert(value));
+				transient.insert(value);
+				expected.insert(value);
+
+				Assert::AreEqual(expected.size(), tree.size());
+				Assert::AreEqual(expected.size(), transient.size());
+			}
+		}
+
+		TEST_METHOD(RedBlackTree_Rank_And_Select_Match_Std_Set)
+		{
+			auto values = sorted_values(200, 0, 3);
+			auto tree = make_sorted_tree<redblack_tree<int>>(200, 0, 3);
+
+			for (std::size_t i = 0; i < values.size(); i++)
+			{
+				Assert::AreEqual(values[i], tree.select(i));
+				Assert::AreEqual(values[i], *tree.nth(i));
+				Assert::AreEqual(i, tree.rank(values[i]));
+				Assert::AreEqual(i + 1, tree.rank(values[i] + 1));
+			}
+
+			Assert::IsTrue(tree.nth(values.size()) == tree.end());
+			Assert::AreEqual(values.size(), tree.rank(1000));
+		}
+
+		TEST_METHOD(RedBlackTree_Nth_Iterates_To_End)
+		{
+			auto values = sorted_values(100);
+			auto tree = make_sorted_tree<redblack_tree<int>>(100);
+
+			for (std::size_t i = 0; i < values.size(); i += 9)
+			{
+				std::vector<int> rest(tree.nth(i), tree.end());
+				Assert::IsTrue(std::equal(rest.begin(), rest.end(), values.begin() + i, values.end()));
+			}
+		}
+
+		TEST_METHOD(RedBlackTree_Count_Range)
+		{
+			auto values = sorted_values(100);
+			auto tree = make_sorted_tree<redblack_tree<int>>(100);
+
+			Assert::AreEqual(std::size_t(10), tree.count_range(10, 20));
+			Assert::AreEqual(std::size_t(100), tree.count_range(-5, 200));
+			Assert::AreEqual(std::size_t(0), tree.count_range(20, 10));
+			Assert::AreEqual(std::size_t(0), tree.count_range(20, 20));
+			Assert::AreEqual(std::size_t(5), tree.count_range(95, 1000));
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,113 @@
+#include "stdafx.h"
+#include <CppUnitTest.h>
+
+#include <wenda/fds/redblack_tree.h>
+#include "redblack_validation.h"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace WENDA_FDS_NAMESPACE;
+
+namespace tests
+{
+	TEST_CLASS(RedBlackTreeTests_Parallel)
+	{
+		TEST_METHOD(ParallelReduce_Matches_Reduce)
+		{
+			task_pool pool(3);
+			auto tree = make_sorted_tree<redblack_tree<int>>(20000);
+
+			auto expected = tree.reduce([](long long sum, int value) { return sum + value; }, 0LL);
+			auto sum = tree.parallel_reduce([](long long sum, int value) { return sum + value; }, 0LL, std::plus<long long>(), pool);
+
+			Assert::AreEqual(expected, sum);
+			Assert::AreEqual(0LL, redblack_tree<int>().parallel_reduce(std::plus<long long>(), 0LL, std::plus<long long>(), pool));
+		}
+
+		TEST_METHOD(ParallelReduce_Preserves_Order)
+		{
+			task_pool pool(3);
+			auto tree = make_sorted_tree<redblack_tree<int>>(3000);
+
+			auto concatenate = [](std::string result, int value) { return result + std::to_string(value) + ","; };
+			auto expected = tree.reduce(concatenate, std::string());
+			auto result = parallel_reduce(tree, concatenate, std::string(), std::plus<std::string>(), pool);
+
+			Assert::IsTrue(expected == result);
+		}
+
+		TEST_METHOD(MapValues_Maps_All_Elements)
+		{
+			task_pool pool(3);
+			auto tree = make_sorted_tree<redblack_tree<int>>(5000);
+
+			auto mapped = tree.map_values([](int value) { return 2.0 * value; }, pool);
+			int expected = 0;
+
+			for (auto value : mapped)
+			{
+				Assert::AreEqual(2.0 * expected++, value);
+			}
+
+			Assert::AreEqual(5000, expected);
+		}
+
+		TEST_METHOD(Filter_Returns_Balanced_Tree)
+		{
+			task_pool pool(3);
+			auto tree = make_sorted_tree<redblack_tree<int>>(5000);
+
+			auto filtered = tree.filter([](int value) { return value % 3 != 0; }, pool);
+			int count = 0;
+
+			for (auto value : filtered)
+			{
+				Assert::IsTrue(value % 3 != 0);
+				count++;
+			}
+
+			Assert::AreEqual(3333, count);
+			Assert::IsTrue(filtered.find(3) == filtered.end());
+		}
+
+		TEST_METHOD(Filter_Keeps_Red_Black_Invariants)
+		{
+			typedef detail::default_node_traits<int> int_traits;
+
+			std::vector<int> values;
+
+			for (int i = 0; i < 2000; i++)
+			{
+				values.push_back(i);
+			}
+
+			auto tree = detail::make_subtree(detail::build_sorted<int, int_traits>(values.begin(), values.end(), std::less<>(), node_pool_allocator<int>()));
+
+			for (int modulus = 2; modulus < 40; modulus += 7)
+			{
+				auto predicate = [=](int value) { return value % modulus == 0 || value > 1500; };
+				auto result = detail::filter<int, int_traits>(tree.root.get(), tree.black_height, predicate, node_pool_allocator<int>(), nullptr);
+				auto filtered = detail::filtered_subtree<int, int_traits>(std::move(result), tree.root.get(), tree.black_height);
+
+				Assert::AreEqual(static_cast<int>(filtered.black_height) + 1, check_black_height<int, int_traits>(filtered.root));
+			}
+		}
+
+		TEST_METHOD(Filter_Shares_Unchanged_Tree)
+		{
+			auto tree = make_sorted_tree<redblack_tree<int>>(1000);
+
+			auto all = tree.filter([](int) { return true; });
+			Assert::IsTrue(&*all.begin() == &*tree.begin());
+
+			auto withoutLast = tree.filter([](int value) { return value != 999; });
+			Assert::IsTrue(&*withoutLast.begin() == &*tree.begin());
+			Assert::IsTrue(withoutLast.find(999) == withoutLast.end());
+
+			Assert::IsTrue(tree.filter([](int) { return false; }).empty());
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,135 @@
+#include "stdafx.h"
+#include <CppUnitTest.h>
+
+#include <wenda/fds/redblack_tree.h>
+
+#include <algorithm>
+#include <random>
+#include <set>
+#include <string>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace WENDA_FDS_NAMESPACE;
+
+namespace tests
+{
+	namespace
+	{
+		/**
+		* Three-way comparison function which counts the calls to each of its members.
+		*/
+		struct counting_three_way_compare
+		{
+			typedef void is_three_way;
+
+			static int two_way_calls;
+			static int three_way_calls;
+
+			bool operator()(int left, int right) const
+			{
+				two_way_calls++;
+				return left < right;
+			}
+
+			int compare(int left, int right) const
+			{
+				three_way_calls++;
+				return left < right ? -1 : (right < left ? 1 : 0);
+			}
+		};
+
+		int counting_three_way_compare::two_way_calls = 0;
+		int counting_three_way_compare::three_way_calls = 0;
+	}
+
+	TEST_CLASS(RedBlackTreeTests_ThreeWay)
+	{
+		TEST_METHOD(Three_Way_Comparison_Functions_Are_Detected)
+		{
+			Assert::IsTrue(is_three_way_compare<three_way_less<>>::value);
+			Assert::IsTrue(is_three_way_compare<three_way_less<std::string>>::value);
+			Assert::IsTrue(is_three_way_compare<counting_three_way_compare>::value);
+			Assert::IsFalse(is_three_way_compare<std::less<>>::value);
+			Assert::IsFalse(is_three_way_compare<std::less<int>>::value);
+		}
+
+		TEST_METHOD(Three_Way_Compare_Orders_Strings)
+		{
+			std::string apple("apple");
+			std::string banana("banana");
+
+			Assert::IsTrue(three_way_compare(apple, banana) < 0);
+			Assert::IsTrue(three_way_compare(banana, apple) > 0);
+			Assert::AreEqual(0, three_way_compare(apple, std::string("apple")));
+			Assert::IsTrue(three_way_compare(apple, "banana") < 0);
+			Assert::IsTrue(three_way_compare("banana", apple) > 0);
+			Assert::AreEqual(0, three_way_compare("apple", apple));
+			Assert::IsTrue(three_way_compare(1, 2) < 0);
+			Assert::AreEqual(0, three_way_compare(2, 2));
+		}
+
+		TEST_METHOD(Lookups_Call_Three_Way_Comparison_Once_Per_Node)
+		{
+			redblack_tree<int, counting_three_way_compare> tree;
+
+			for (int i = 0; i < 100; i++)
+			{
+				std::tie(tree, std::ignore, std::ignore) = tree.insert(i);
+			}
+
+			counting_three_way_compare::two_way_calls = 0;
+			counting_three_way_compare::three_way_calls = 0;
+
+			Assert::IsTrue(tree.find(37) != tree.end());
+			Assert::IsFalse(tree.contains(137));
+
+			bool inserted;
+			std::tie(std::ignore, std::ignore, inserted) = tree.insert(50);
+			Assert::IsFalse(inserted);
+
+			bool erased;
+			std::tie(std::ignore, erased) = tree.erase(50);
+			Assert::IsTrue(erased);
+
+			Assert::AreEqual(0, counting_three_way_compare::two_way_calls);
+			Assert::IsTrue(counting_three_way_compare::three_way_calls <= 4 * 14);
+		}
+
+		TEST_METHOD(String_Tree_With_Three_Way_Comparison_Matches_Set)
+		{
+			std::mt19937 random(5);
+			std::uniform_int_distribution<int> distribution(0, 300);
+
+			redblack_tree<std::string, three_way_less<>> tree;
+			std::set<std::string> expected;
+
+			for (int i = 0; i < 1000; i++)
+			{
+				auto value = "key_" + std::to_string(distribution(random));
+
+				if (i % 4 == 0)
+				{
+					bool erased;
+					std::tie(tree, erased) = tree.erase(value);
+					Assert::AreEqual(expected.erase(value) != 0, erased);
+				}
+				else
+				{
+					bool inserted;
+					std::tie(tree, std::ignore, inserted) = tree.insert(value);
+					Assert::AreEqual(expected.insert(value).second, inserted);
+				}
+			}
+
+			Assert::AreEqual(expected.size(), tree.size());
+			Assert::IsTrue(std::equal(expected.begin(), expected.end(), tree.begin()));
+
+			for (auto const& value : expected)
+			{
+				Assert::IsTrue(tree.contains(value.c_str()));
+			}
+
+			Assert::IsFalse(tree.contains("missing"));
+		}
+	};
+}
\ No newline at end of file
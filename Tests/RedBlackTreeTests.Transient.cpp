@@ -0,0 +1,123 @@
+#include "stdafx.h"
+#include <CppUnitTest.h>
+
+#include <wenda/fds/redblack_tree.h>
+#include "redblack_validation.h"
+
+#include <random>
+#include <set>
+#include <tuple>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace WENDA_FDS_NAMESPACE;
+
+namespace tests
+{
+	namespace
+	{
+		typedef detail::default_node_traits<int> int_traits;
+	}
+
+	TEST_CLASS(RedBlackTreeTests_Transient)
+	{
+		TEST_METHOD(InsertTransient_Keeps_Tree_Balanced)
+		{
+			std::mt19937 mt(42);
+			std::uniform_int_distribution<int> dis(0, 500);
+
+			detail::const_intrusive_rb_ptr<int> root;
+			detail::const_rb_pointer<int> element;
+			std::set<int> expected;
+
+			for (int i = 0; i < 1000; i++)
+			{
+				auto value = dis(mt);
+				auto inserted = detail::insert_transient<int, int_traits>(root, value, std::less<>(), node_pool_allocator<int>(), element);
+				set_colour(root, detail::NodeColour::Black);
+
+				Assert::AreEqual(expected.insert(value).second, inserted);
+				Assert::AreEqual(value, element->get_data());
+				check_black_height<int, int_traits>(root);
+			}
+		}
+
+		TEST_METHOD(Transient_Does_Not_Modify_Source_Tree)
+		{
+			redblack_tree<int> base;
+
+			for (int i = 0; i < 100; i += 2)
+			{
+				base = std::get<0>(base.insert(i));
+			}
+
+			auto transient = base.transient();
+
+			for (int i = 1; i < 100; i += 2)
+			{
+				Assert::IsTrue(transient.insert(i));
+			}
+
+			Assert::IsFalse(transient.insert(10));
+
+			auto tree = transient.take_persistent();
+
+			Assert::AreEqual(2500, base.reduce([](int sum, int value) { return sum + value; }, 0) + 50);
+			Assert::IsTrue(base.find(1) == base.end());
+			Assert::AreEqual(4950, tree.reduce([](int sum, int value) { return sum + value; }, 0));
+			Assert::IsTrue(transient.empty());
+		}
+
+		TEST_METHOD(Transient_Modifies_Unique_Nodes_In_Place)
+		{
+			redblack_tree<int>::transient_type transient;
+
+			for (int i = 0; i < 10; i++)
+			{
+				transient.insert(i);
+			}
+
+			// the largest element is on the insertion path of a larger value.
+			auto node = &*transient.find(9);
+			transient.insert(10);
+			Assert::IsTrue(node == &*transient.find(9));
+
+			// once frozen, the nodes are shared and must be copied.
+			auto frozen = transient.persistent();
+			transient.insert(11);
+
+			Assert::IsTrue(node == &*frozen.find(9));
+			Assert::IsTrue(node != &*transient.find(9));
+			Assert::IsTrue(frozen.find(11) == frozen.end());
+		}
+
+		TEST_METHOD(Transient_From_Moved_Tree_Builds_Same_Tree_As_Insert)
+		{
+			std::mt19937 mt(7);
+			std::uniform_int_distribution<int> dis;
+			std::set<int> expected;
+			redblack_tree<int> tree;
+
+			auto transient = tree.take_transient();
+			Assert::IsTrue(tree.empty());
+
+			for (int i = 0; i < 1000; i++)
+			{
+				auto value = dis(mt);
+				expected.insert(value);
+				transient.insert(value);
+			}
+
+			tree = transient.take_persistent();
+
+			auto it = tree.begin();
+
+			for (auto value : expected)
+			{
+				Assert::AreEqual(value, *it);
+				++it;
+			}
+
+			Assert::IsTrue(it == tree.end());
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,191 @@
+#include "stdafx.h"
+#include <CppUnitTest.h>
+
+#include <wenda/fds/intrusive_ptr.h>
+#include <wenda/fds/biased_refcount.h>
+#include <wenda/fds/forward_list.h>
+#include <wenda/fds/redblack_tree.h>
+
+#include <cstddef>
+#include <functional>
+#include <thread>
+#include <tuple>
+
+#include "counting_allocator.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace WENDA_FDS_NAMESPACE;
+
+namespace tests
+{
+	namespace
+	{
+		template<typename Policy>
+		void check_reference_counting()
+		{
+			basic_intrusive_refcount<Policy> object;
+
+			Assert::AreEqual(std::size_t(1), add_reference(&object));
+			Assert::AreEqual(std::size_t(3), add_reference(&object, 2));
+			Assert::AreEqual(std::size_t(3), reference_count(&object));
+			Assert::AreEqual(std::size_t(2), remove_reference(&object));
+			Assert::AreEqual(std::size_t(1), remove_reference(&object));
+			Assert::AreEqual(std::size_t(0), remove_reference(&object));
+		}
+
+		typedef redblack_tree<int, std::less<>, counting_allocator<int>, biased_refcount_policy> biased_tree;
+	}
+
+	TEST_CLASS(RefCountPolicyTests)
+	{
+		TEST_METHOD(AtomicRefCountPolicy_Counts_References)
+		{
+			check_reference_counting<atomic_refcount_policy>();
+		}
+
+		TEST_METHOD(SeqCstRefCountPolicy_Counts_References)
+		{
+			check_reference_counting<seq_cst_refcount_policy>();
+		}
+
+		TEST_METHOD(NonAtomicRefCountPolicy_Counts_References)
+		{
+			check_reference_counting<nonatomic_refcount_policy>();
+		}
+
+		TEST_METHOD(BiasedRefCountPolicy_Counts_References)
+		{
+			check_reference_counting<biased_refcount_policy>();
+		}
+
+		TEST_METHOD(BiasedRefCount_Releases_Nodes_Dropped_By_Other_Threads)
+		{
+			std::ptrdiff_t live = 0;
+			biased_tree tree{ counting_allocator<int>(&live) };
+
+			for (int i = 0; i < 100; i++)
+			{
+				tree = std::get<0>(tree.insert(i));
+			}
+
+			// the copy taken by this thread is released by the other thread.
+			std::thread reader([](biased_tree snapshot)
+			{
+				auto copy = std::get<0>(snapshot.insert(100));
+				Assert::AreEqual(5050, copy.reduce(std::plus<int>(), 0));
+			}, tree);
+			reader.join();
+
+			tree = biased_tree(counting_allocator<int>(&live));
+			process_biased_references();
+
+			Assert::AreEqual(std::ptrdiff_t(0), live);
+		}
+
+		TEST_METHOD(BiasedRefCount_Releases_Nodes_After_Owner_Exits)
+		{
+			std::ptrdiff_t live = 0;
+			biased_tree tree{ counting_allocator<int>(&live) };
+
+			std::thread writer([&]()
+			{
+				biased_tree local{ counting_allocator<int>(&live) };
+
+				for (int i = 0; i < 100; i++)
+				{
+					local = std::get<0>(local.insert(i));
+				}
+
+				tree = local;
+			});
+			writer.join();
+
+			Assert::AreEqual(4950, tree.reduce(std::plus<int>(), 0));
+
+			tree = biased_tree(counting_allocator<int>(&live));
+			Assert::AreEqual(std::ptrdiff_t(0), live);
+		}
+
+		TEST_METHOD(BiasedRefCount_Owner_Gives_Up_While_Shared_Release_Is_In_Flight)
+		{
+			typedef forward_list<int, counting_allocator<int>, biased_refcount_policy> biased_list;
+			std::ptrdiff_t live = 0;
+
+			for (int i = 0; i < 1000; i++)
+			{
+				auto owned = biased_list(counting_allocator<int>(&live)).push_front(i);
+				auto released = owned;
+				auto copied = owned;
+				biased_list shared{ counting_allocator<int>(&live) };
+
+				// the copier adds a reference to the shared counter, which the owner releases along with its own,
+				// giving up its ownership, while the releaser drops a reference counted by the owner, which may
+				// make the shared counter negative and queue the node to the owner.
+				std::thread copier([&]() { shared = copied; });
+				copier.join();
+
+				std::thread releaser([&]() { released = biased_list(counting_allocator<int>(&live)); });
+				owned = biased_list(counting_allocator<int>(&live));
+				shared = biased_list(counting_allocator<int>(&live));
+				copied = biased_list(counting_allocator<int>(&live));
+				releaser.join();
+
+				process_biased_references();
+			}
+
+			Assert::AreEqual(std::ptrdiff_t(0), live);
+		}
+
+		TEST_METHOD(RedBlackTree_With_NonAtomic_RefCount_Can_Insert_And_Erase)
+		{
+			typedef redblack_tree<int, std::less<>, node_pool_allocator<int>, nonatomic_refcount_policy> tree_t;
+			tree_t tree;
+
+			for (int i = 0; i < 100; i++)
+			{
+				tree = std::get<0>(tree.insert(i));
+			}
+
+			auto copy = tree;
+			tree = std::get<0>(tree.erase(0));
+
+			Assert::IsTrue(copy.find(0) != copy.end());
+			Assert::AreEqual(4950, copy.reduce(std::plus<int>(), 0));
+		}
+
+		TEST_METHOD(ForwardList_With_NonAtomic_RefCount_Can_PushFront)
+		{
+			forward_list<int, node_pool_allocator<int>, nonatomic_refcount_policy> list;
+			auto longer = list.push_front(1).push_front(2);
+
+			Assert::AreEqual(2, longer.front());
+			Assert::IsTrue(list.empty());
+		}
+
+		TEST_METHOD(RedBlackTree_With_Atomic_RefCount_Can_Be_Shared_Between_Threads)
+		{
+			redblack_tree<int> tree;
+
+			for (int i = 0; i < 1000; i++)
+			{
+				tree = std::get<0>(tree.insert(i));
+			}
+
+			auto work = [](redblack_tree<int> tree)
+			{
+				for (int i = 0; i < 1000; i++)
+				{
+					auto copy = std::get<0>(tree.insert(i + 1000));
+					(void)copy;
+				}
+			};
+
+			std::thread first(work, tree);
+			std::thread second(work, tree);
+			tree = redblack_tree<int>();
+
+			first.join();
+			second.join();
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,63 @@
+#include "stdafx.h"
+#include <CppUnitTest.h>
+
+#include <wenda/fds/task_pool.h>
+
+#include <atomic>
+#include <stdexcept>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace WENDA_FDS_NAMESPACE;
+
+namespace tests
+{
+	namespace
+	{
+		long fibonacci(task_pool& pool, int n)
+		{
+			if (n < 2)
+			{
+				return n;
+			}
+
+			long first, second;
+			pool.invoke([&]() { first = fibonacci(pool, n - 1); }, [&]() { second = fibonacci(pool, n - 2); });
+			return first + second;
+		}
+	}
+
+	TEST_CLASS(TaskPoolTests)
+	{
+		TEST_METHOD(TaskPool_Runs_Nested_Invocations)
+		{
+			task_pool pool(3);
+			Assert::AreEqual(6765L, fibonacci(pool, 20));
+		}
+
+		TEST_METHOD(TaskPool_Without_Workers_Runs_Sequentially)
+		{
+			task_pool pool(0);
+			Assert::AreEqual(std::size_t(0), pool.worker_count());
+			Assert::AreEqual(610L, fibonacci(pool, 15));
+		}
+
+		TEST_METHOD(TaskPool_Rethrows_Exceptions_After_Both_Complete)
+		{
+			task_pool pool(2);
+			std::atomic<bool> ran(false);
+			bool thrown = false;
+
+			try
+			{
+				pool.invoke([]() { throw std::runtime_error("first"); }, [&]() { ran = true; });
+			}
+			catch (std::runtime_error const&)
+			{
+				thrown = true;
+			}
+
+			Assert::IsTrue(thrown);
+			Assert::IsTrue(ran.load());
+		}
+	};
+}
\ No newline at end of file
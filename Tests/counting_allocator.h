@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+namespace tests
+{
+	/**
+	* A stateful allocator that counts the number of live allocations.
+	*/
+	template<typename T>
+	class counting_allocator
+	{
+		template<typename U> friend class counting_allocator;
+		std::ptrdiff_t* live;
+	public:
+		typedef T value_type;
+
+		template<typename U>
+		struct rebind
+		{
+			typedef counting_allocator<U> other;
+		};
+
+		explicit counting_allocator(std::ptrdiff_t* live)
+			: live(live)
+		{}
+
+		template<typename U>
+		counting_allocator(counting_allocator<U> const& other)
+			: live(other.live)
+		{}
+
+		T* allocate(std::size_t count)
+		{
+			++*live;
+			return std::allocator<T>().allocate(count);
+		}
+
+		void deallocate(T* pointer, std::size_t count)
+		{
+			--*live;
+			std::allocator<T>().deallocate(pointer, count);
+		}
+
+		template<typename U>
+		bool operator==(counting_allocator<U> const& other) const { return live == other.live; }
+
+		template<typename U>
+		bool operator!=(counting_allocator<U> const& other) const { return live != other.live; }
+	};
+}
\ No newline at end of file
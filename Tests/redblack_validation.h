@@ -0,0 +1,84 @@
+#pragma once
+
+#include <CppUnitTest.h>
+
+#include <wenda/fds/redblack_tree.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace tests
+{
+	/**
+	* Checks the red-black invariants of the given subtree, and returns its black height.
+	*/
+	template<typename T, typename Traits>
+	int check_black_height(wenda::fds::detail::const_intrusive_rb_ptr<T, Traits> const& node)
+	{
+		using Microsoft::VisualStudio::CppUnitTestFramework::Assert;
+		using wenda::fds::detail::NodeColour;
+
+		if (is_leaf(node))
+		{
+			return 1;
+		}
+
+		if (colour(node) == NodeColour::Red)
+		{
+			Assert::IsTrue(is_leaf(node->get_left()) || colour(node->get_left()) == NodeColour::Black);
+			Assert::IsTrue(is_leaf(node->get_right()) || colour(node->get_right()) == NodeColour::Black);
+		}
+
+		auto left = check_black_height<T, Traits>(node->get_left());
+		auto right = check_black_height<T, Traits>(node->get_right());
+
+		Assert::AreEqual(left, right);
+		return left + (colour(node) == NodeColour::Black ? 1 : 0);
+	}
+
+	/**
+	* Checks that the sizes stored in the given subtree match the number of its nodes, and returns that number.
+	*/
+	template<typename T, typename Traits>
+	std::size_t check_size(wenda::fds::detail::const_intrusive_rb_ptr<T, Traits> const& node)
+	{
+		using Microsoft::VisualStudio::CppUnitTestFramework::Assert;
+
+		if (is_leaf(node))
+		{
+			return 0;
+		}
+
+		auto size = check_size<T, Traits>(node->get_left()) + check_size<T, Traits>(node->get_right()) + 1;
+		Assert::AreEqual(size, node->size());
+		return size;
+	}
+
+	/**
+	* Returns the elements constructed from the @p count values first, first + step, ..., in increasing order.
+	* @tparam T The type of the elements, which must be constructible from int.
+	*/
+	template<typename T = int>
+	std::vector<T> sorted_values(int count, int first = 0, int step = 1)
+	{
+		std::vector<T> values;
+
+		for (int i = 0; i < count; i++)
+		{
+			values.emplace_back(first + i * step);
+		}
+
+		return values;
+	}
+
+	/**
+	* Builds a tree holding the elements returned by sorted_values(), from a sorted range.
+	* @tparam Tree The type of the tree, whose elements must be constructible from int.
+	*/
+	template<typename Tree>
+	Tree make_sorted_tree(int count, int first = 0, int step = 1, typename Tree::allocator_type const& allocator = typename Tree::allocator_type())
+	{
+		auto values = sorted_values<typename Tree::value_type>(count, first, step);
+		return Tree(wenda::fds::sorted_range, values.begin(), values.end(), allocator);
+	}
+}
\ No newline at end of file